@@ -0,0 +1,313 @@
+// archetype entity registry
+#pragma once
+#include "Registry.h"
+
+#include <unordered_map>
+#include <new>
+#include <stdexcept>
+
+// Optional storage backend with the same entity/component api as Registry (createEntity, destroyEntity, isAlive,
+// addComponent, removeComponent, getComponent, hasComponent).
+// Entities that have the same Signature live together in an archetype. An archetype stores its entities in fixed size
+// chunks, and inside a chunk every component type has its own packed array (SoA). forEach only visits chunks of
+// archetypes that contain all requested components, walking each column linearly.
+// Adding or removing a component moves the entity to another archetype, so component references are only valid until
+// the next structural change of that entity or of the last entity of its archetype.
+
+constexpr UINT ArchetypeChunkBytes = 16 * 1024;
+
+class ArchetypeRegistry {
+public:
+	ArchetypeRegistry() {
+		// archetype 0 holds entities without components
+		getArchetype(Signature());
+	}
+
+	~ArchetypeRegistry() {
+		// chunks are raw bytes, components have to be destroyed by hand
+		for (auto& archetype : archetypes) {
+			for (UINT row = 0; row < archetype->count; row++) {
+				for (UINT column = 0; column < archetype->compTypeIDs.size(); column++)
+					archetype->infos[column]->destroy(archetype->component(archetype->compTypeIDs[column], row));
+			}
+		}
+	}
+
+	UINT createEntity() {
+		UINT index;
+		if (!freeSlots.empty()) {
+			index = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		else {
+			index = static_cast<UINT>(records.size());
+			records.emplace_back();
+			generations.push_back(0);
+		}
+
+		UINT entity = makeEntity(index, generations[index]);
+		records[index].entity = entity;
+		records[index].archetype = 0;
+		records[index].row = archetypes[0]->allocateRow(entity);
+		return entity;
+	}
+
+	void destroyEntity(UINT entity) {
+		if (!isAlive(entity))
+			return;
+
+		UINT index = entityIndex(entity);
+		auto& record = records[index];
+		removeRow(*archetypes[record.archetype], record.row, true);
+
+		generations[index] = (generations[index] + 1) & EntityGenerationMask;
+		record.entity = NullEntity;
+		freeSlots.push_back(index);
+	}
+
+	bool isAlive(UINT entity) const {
+		UINT index = entityIndex(entity);
+		return entity != NullEntity && index < records.size() && records[index].entity == entity;
+	}
+
+	template <typename T, typename ...TArgs>
+	T& addComponent(UINT entity, TArgs&& ...args) {
+		UINT compTypeID = registerComponent<T>();
+		auto& record = records[entityIndex(entity)];
+
+		// already has it, overwrite in place
+		if (archetypes[record.archetype]->signature.test(compTypeID)) {
+			T& component = *static_cast<T*>(archetypes[record.archetype]->component(compTypeID, record.row));
+			component = T(std::forward<TArgs>(args)...);
+			return component;
+		}
+
+		Signature signature = archetypes[record.archetype]->signature;
+		signature.set(compTypeID);
+		moveEntity(entity, getArchetype(signature));
+
+		void* ptr = archetypes[record.archetype]->component(compTypeID, record.row);
+		return *new (ptr) T(std::forward<TArgs>(args)...);
+	}
+
+	template <typename T>
+	void removeComponent(UINT entity) {
+		UINT compTypeID = Component<T>::getID();
+		auto& record = records[entityIndex(entity)];
+		if (!archetypes[record.archetype]->signature.test(compTypeID))
+			return;
+
+		Signature signature = archetypes[record.archetype]->signature;
+		signature.reset(compTypeID);
+		moveEntity(entity, getArchetype(signature));
+	}
+
+	template <typename T>
+	T& getComponent(UINT entity) {
+		auto& record = records[entityIndex(entity)];
+		return *static_cast<T*>(archetypes[record.archetype]->component(Component<T>::getID(), record.row));
+	}
+
+	template <typename T>
+	bool hasComponent(UINT entity) {
+		auto& record = records[entityIndex(entity)];
+		return archetypes[record.archetype]->signature.test(Component<T>::getID());
+	}
+
+	// call fn(entity, T&...) for every entity that has all of T. iterates chunk by chunk and column by column
+	template <typename ...T, typename Fn>
+	void forEach(Fn&& fn) {
+		Signature match;
+		(match.set(Component<T>::getID()), ...);
+
+		for (auto& archetype : archetypes) {
+			if ((archetype->signature & match) != match)
+				continue;
+
+			for (auto& chunk : archetype->chunks) {
+				UINT* chunkEntities = reinterpret_cast<UINT*>(chunk->data);
+				auto columns = std::make_tuple(archetype->template column<T>(*chunk)...);
+				for (UINT row = 0; row < chunk->count; row++)
+					fn(chunkEntities[row], std::get<T*>(columns)[row]...);
+			}
+		}
+	}
+
+	UINT getArchetypeCount() const {
+		return static_cast<UINT>(archetypes.size());
+	}
+
+private:
+	// type erased info to move component data between archetypes
+	struct ComponentInfo {
+		UINT size = 0;
+		UINT align = 0;
+		void (*moveConstruct)(void* dst, void* src) = nullptr;
+		void (*destroy)(void* ptr) = nullptr;
+	};
+
+	struct Chunk {
+		alignas(64) unsigned char data[ArchetypeChunkBytes];
+		UINT count = 0;
+	};
+
+	struct Archetype {
+		Signature signature;
+		std::vector<UINT> compTypeIDs;
+		std::vector<UINT> columnOffsets;										// byte offset of each component array inside a chunk
+		std::vector<UINT> columnOfType;											// component type id -> column, InvalidIndex if absent
+		std::vector<const ComponentInfo*> infos;
+		UINT capacity = 0;														// entities per chunk
+		std::vector<std::unique_ptr<Chunk>> chunks;
+		UINT count = 0;
+
+		// entity handles are the first array of a chunk, component arrays follow
+		void layout() {
+			UINT rowBytes = sizeof(UINT);
+			for (auto info : infos)
+				rowBytes += info->size;
+
+			capacity = ArchetypeChunkBytes / rowBytes;
+			while (capacity > 0 && !fits(capacity))
+				capacity--;
+			if (capacity == 0)
+				throw std::runtime_error("component set does not fit in an archetype chunk");
+			fits(capacity);
+		}
+
+		bool fits(UINT rows) {
+			columnOffsets.clear();
+			UINT offset = rows * sizeof(UINT);
+			for (auto info : infos) {
+				offset = (offset + info->align - 1) / info->align * info->align;
+				columnOffsets.push_back(offset);
+				offset += rows * info->size;
+			}
+			return offset <= ArchetypeChunkBytes;
+		}
+
+		UINT allocateRow(UINT entity) {
+			if (count == chunks.size() * capacity)
+				chunks.push_back(std::make_unique<Chunk>());
+			Chunk& chunk = *chunks[count / capacity];
+			reinterpret_cast<UINT*>(chunk.data)[chunk.count++] = entity;
+			return count++;
+		}
+
+		void* component(UINT compTypeID, UINT row) {
+			UINT column = columnOfType[compTypeID];
+			Chunk& chunk = *chunks[row / capacity];
+			return chunk.data + columnOffsets[column] + (row % capacity) * infos[column]->size;
+		}
+
+		UINT& entityAt(UINT row) {
+			return reinterpret_cast<UINT*>(chunks[row / capacity]->data)[row % capacity];
+		}
+
+		template <typename T>
+		T* column(Chunk& chunk) {
+			return reinterpret_cast<T*>(chunk.data + columnOffsets[columnOfType[Component<T>::getID()]]);
+		}
+	};
+
+	struct EntityRecord {
+		UINT entity = NullEntity;
+		UINT archetype = 0;
+		UINT row = 0;
+	};
+
+	template <typename T>
+	UINT registerComponent() {
+		UINT compTypeID = Component<T>::getID();
+		auto& info = componentInfos[compTypeID];
+		if (!info.size) {
+			info.size = sizeof(T);
+			info.align = alignof(T);
+			info.moveConstruct = [](void* dst, void* src) { new (dst) T(std::move(*static_cast<T*>(src))); };
+			info.destroy = [](void* ptr) { static_cast<T*>(ptr)->~T(); };
+		}
+		return compTypeID;
+	}
+
+	UINT getArchetype(const Signature& signature) {
+		auto it = archetypeLookup.find(signature);
+		if (it != archetypeLookup.end())
+			return it->second;
+
+		auto archetype = std::make_unique<Archetype>();
+		archetype->signature = signature;
+		archetype->columnOfType.resize(MaxComponents, InvalidIndex);
+		for (UINT compTypeID = 0; compTypeID < MaxComponents; compTypeID++) {
+			if (signature.test(compTypeID)) {
+				archetype->columnOfType[compTypeID] = static_cast<UINT>(archetype->compTypeIDs.size());
+				archetype->compTypeIDs.push_back(compTypeID);
+				archetype->infos.push_back(&componentInfos[compTypeID]);
+			}
+		}
+		archetype->layout();
+
+		UINT archetypeIndex = static_cast<UINT>(archetypes.size());
+		archetypes.push_back(std::move(archetype));
+		archetypeLookup[signature] = archetypeIndex;
+		return archetypeIndex;
+	}
+
+	// move an entity's shared components to the target archetype. components not in the target are destroyed,
+	// components only in the target are left unconstructed for the caller
+	void moveEntity(UINT entity, UINT targetIndex) {
+		auto& record = records[entityIndex(entity)];
+		Archetype& source = *archetypes[record.archetype];
+		Archetype& target = *archetypes[targetIndex];
+
+		UINT targetRow = target.allocateRow(entity);
+		for (UINT column = 0; column < source.compTypeIDs.size(); column++) {
+			UINT compTypeID = source.compTypeIDs[column];
+			void* src = source.component(compTypeID, record.row);
+			if (target.signature.test(compTypeID))
+				source.infos[column]->moveConstruct(target.component(compTypeID, targetRow), src);
+			source.infos[column]->destroy(src);
+		}
+
+		removeRow(source, record.row, false);
+		record.archetype = targetIndex;
+		record.row = targetRow;
+	}
+
+	// fill the hole at row with the archetype's last row so chunks stay packed
+	void removeRow(Archetype& archetype, UINT row, bool destroyComponents) {
+		UINT last = archetype.count - 1;
+
+		if (destroyComponents) {
+			for (UINT column = 0; column < archetype.compTypeIDs.size(); column++)
+				archetype.infos[column]->destroy(archetype.component(archetype.compTypeIDs[column], row));
+		}
+
+		if (row != last) {
+			for (UINT column = 0; column < archetype.compTypeIDs.size(); column++) {
+				UINT compTypeID = archetype.compTypeIDs[column];
+				void* src = archetype.component(compTypeID, last);
+				archetype.infos[column]->moveConstruct(archetype.component(compTypeID, row), src);
+				archetype.infos[column]->destroy(src);
+			}
+			UINT movedEntity = archetype.entityAt(last);
+			archetype.entityAt(row) = movedEntity;
+			records[entityIndex(movedEntity)].row = row;
+		}
+
+		archetype.chunks[last / archetype.capacity]->count--;
+		archetype.count--;
+
+		// keep one empty chunk past the used ones so an entity moving back and forth does not allocate every time
+		size_t usedChunks = (archetype.count + archetype.capacity - 1) / archetype.capacity;
+		while (archetype.chunks.size() > usedChunks + 1)
+			archetype.chunks.pop_back();
+	}
+
+	ComponentInfo componentInfos[MaxComponents];							// fixed size so archetypes can keep pointers into it
+	std::vector<std::unique_ptr<Archetype>> archetypes;
+	std::unordered_map<Signature, UINT> archetypeLookup;
+
+	std::vector<EntityRecord> records;										// slot index -> archetype and row
+	std::vector<UINT> generations;
+	std::vector<UINT> freeSlots;
+};
@@ -0,0 +1,219 @@
+// deferred structural changes
+#pragma once
+#include "Registry.h"
+#include "Scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// records create, destroy, add and remove while systems run, so nothing changes a pool or signature during iteration.
+// entities created here get a pending handle that can be used in the same buffer's commands; it is swapped for
+// a real entity at playback
+class CommandBuffer {
+public:
+	UINT createEntity() {
+		return makeEntity(numPendingEntities++, PendingGeneration);
+	}
+
+	void destroyEntity(UINT entity) {
+		destroys.push_back(entity);
+	}
+
+	template <typename T, typename ...TArgs>
+	void addComponent(UINT entity, TArgs&& ...args) {
+		auto& values = getPayloads<T>().values;
+		commands.push_back({ CommandType::ADD, Component<T>::getID(), entity, static_cast<UINT>(values.size()) });
+		values.push_back(T(std::forward<TArgs>(args)...));
+	}
+
+	template <typename T>
+	void removeComponent(UINT entity) {
+		getPayloads<T>();
+		commands.push_back({ CommandType::REMOVE, Component<T>::getID(), entity, 0 });
+	}
+
+	bool empty() const {
+		return numPendingEntities == 0 && commands.empty() && destroys.empty();
+	}
+
+private:
+	friend class CommandBuffers;
+
+	enum class CommandType : uint8_t {
+		ADD,
+		REMOVE
+	};
+
+	struct Command {
+		CommandType type;
+		UINT compTypeID;
+		UINT entity;
+		UINT payloadIndex;
+	};
+
+	// recorded component values of one type, applied to the registry by type id at playback
+	class IPayloads {
+	public:
+		virtual ~IPayloads() = default;
+		virtual void add(Registry& registry, UINT entity, UINT payloadIndex) = 0;
+		virtual void remove(Registry& registry, UINT entity) = 0;
+		virtual void clear() = 0;
+	};
+
+	template <typename T>
+	class Payloads : public IPayloads {
+	public:
+		void add(Registry& registry, UINT entity, UINT payloadIndex) override {
+			registry.addComponent<T>(entity, std::move(values[payloadIndex]));
+		}
+		void remove(Registry& registry, UINT entity) override {
+			registry.removeComponent<T>(entity);
+		}
+		void clear() override {
+			values.clear();
+		}
+		std::vector<T> values;
+	};
+
+	template <typename T>
+	Payloads<T>& getPayloads() {
+		auto compTypeID = Component<T>::getID();
+		if (compTypeID >= payloads.size())
+			payloads.resize(compTypeID + 1);
+		if (!payloads[compTypeID])
+			payloads[compTypeID] = std::make_unique<Payloads<T>>();
+		return *static_cast<Payloads<T>*>(payloads[compTypeID].get());
+	}
+
+	void clear() {
+		numPendingEntities = 0;
+		commands.clear();
+		destroys.clear();
+		for (auto& p : payloads) {
+			if (p)
+				p->clear();
+		}
+	}
+
+	UINT numPendingEntities = 0;
+	std::vector<Command> commands;
+	std::vector<UINT> destroys;
+	std::vector<std::unique_ptr<IPayloads>> payloads;						// component type id -> recorded values
+};
+
+// one CommandBuffer per thread so recording needs no locks. workers of the pool find theirs by thread index, any other
+// thread that records (the window thread, async tasks, workers of another pool) gets a buffer of its own on first use
+// and keeps a pointer to it, so only its first call takes the lock. played back in bulk at a sync point
+class CommandBuffers {
+public:
+	CommandBuffers(ThreadPool& threadPool) : threadPool(threadPool), workerBuffers(threadPool.getWorkerCount()), id(makeID()) {}
+
+	// buffer of the calling thread
+	CommandBuffer& local() {
+		if (ThreadPool::getCurrentPool() == &threadPool)
+			return workerBuffers[ThreadPool::getThreadIndex() - 1];
+
+		// the last buffer a thread got is remembered with the id of its CommandBuffers. ids are never reused, so an
+		// instance created where a destroyed one was does not get its buffer
+		struct Cached {
+			uint64_t owner = 0;
+			CommandBuffer* buffer = nullptr;
+		};
+		static thread_local Cached cached;
+		if (cached.owner == id)
+			return *cached.buffer;
+
+		// a deque so buffers handed out earlier stay where they are while another thread adds its own
+		std::lock_guard<std::mutex> lock(mutex);
+		auto thread = std::this_thread::get_id();
+		UINT i = 0;
+		while (i < otherThreads.size() && otherThreads[i] != thread)
+			i++;
+		if (i == otherThreads.size()) {
+			otherThreads.push_back(thread);
+			otherBuffers.emplace_back();
+		}
+		cached = { id, &otherBuffers[i] };
+		return otherBuffers[i];
+	}
+
+	// apply every recorded command. creates first, then adds and removes sorted by component type so each pool
+	// is written in one batch, destroys last. must not run while systems iterate the registry
+	void playback(Registry& registry) {
+		struct SortedCommand {
+			UINT compTypeID;
+			UINT bufferIndex;
+			UINT commandIndex;
+		};
+		std::vector<SortedCommand> sorted;
+
+		buffers.clear();
+		for (auto& buffer : workerBuffers)
+			buffers.push_back(&buffer);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			for (auto& buffer : otherBuffers)
+				buffers.push_back(&buffer);
+		}
+
+		// real entities for pending handles of each buffer
+		pendingEntities.resize(buffers.size());
+		for (UINT b = 0; b < buffers.size(); b++) {
+			auto& buffer = *buffers[b];
+			pendingEntities[b].clear();
+			for (UINT i = 0; i < buffer.numPendingEntities; i++)
+				pendingEntities[b].push_back(registry.createEntity());
+
+			for (UINT c = 0; c < buffer.commands.size(); c++)
+				sorted.push_back({ buffer.commands[c].compTypeID, b, c });
+		}
+
+		// stable so commands on the same type keep their recorded order
+		std::stable_sort(sorted.begin(), sorted.end(), [](const SortedCommand& a, const SortedCommand& b) {
+			return a.compTypeID < b.compTypeID;
+		});
+
+		for (auto& s : sorted) {
+			auto& buffer = *buffers[s.bufferIndex];
+			auto& command = buffer.commands[s.commandIndex];
+			UINT entity = resolve(s.bufferIndex, command.entity);
+			if (!registry.isAlive(entity))
+				continue;
+
+			if (command.type == CommandBuffer::CommandType::ADD)
+				buffer.payloads[command.compTypeID]->add(registry, entity, command.payloadIndex);
+			else
+				buffer.payloads[command.compTypeID]->remove(registry, entity);
+		}
+
+		for (UINT b = 0; b < buffers.size(); b++) {
+			for (auto entity : buffers[b]->destroys)
+				registry.destroyEntity(resolve(b, entity));
+			buffers[b]->clear();
+		}
+	}
+
+private:
+	UINT resolve(UINT bufferIndex, UINT entity) const {
+		return isPendingEntity(entity) ? pendingEntities[bufferIndex][entityIndex(entity)] : entity;
+	}
+
+	static uint64_t makeID() {
+		static std::atomic<uint64_t> nextID{ 1 };
+		return nextID++;
+	}
+
+	ThreadPool& threadPool;
+	std::vector<CommandBuffer> workerBuffers;									// worker index - 1 -> buffer
+	std::deque<CommandBuffer> otherBuffers;										// threads outside the pool, by first use
+	std::vector<std::thread::id> otherThreads;
+	std::mutex mutex;															// guards otherBuffers and otherThreads
+	const uint64_t id;															// tells instances apart in the per thread cache
+
+	std::vector<CommandBuffer*> buffers;										// all of them in playback order
+	std::vector<std::vector<UINT>> pendingEntities;							// per buffer, pending index -> created entity
+};
@@ -1,70 +1,79 @@
-#pragma once
-#include "stdafx.h"
-
-using namespace DirectX;
-
-struct CBuffPerObj {
-	DirectX::XMFLOAT4X4 matModel;
-	UINT colorIndex;
-};
-
-struct CBuffPerPass {
-	DirectX::XMFLOAT4X4 matView;
-	DirectX::XMFLOAT4X4 matProj;
-};
-
-enum class PieceType {
-	PIECE_CORNER,
-	PIECE_CROSS,
-	PIECE_CENTER,
-	PIECETYPE_TOTAL
-};
-
-
-
-struct CBoundingBox {
-	BoundingOrientedBox obb;
-};
-
-
-struct CDraw {
-	CDraw(UINT drawIndex = 0, UINT baseVertex = 0, UINT startIndex = 0, UINT indexCount = 0) :
-		drawIndex(drawIndex), baseVertex(baseVertex), startIndex(startIndex), indexCount(indexCount), colorIndex(0) {}
-	UINT drawIndex;
-	UINT baseVertex;
-	UINT startIndex;
-	UINT indexCount;
-	UINT colorIndex;
-};
-
-struct CTransform {
-	XMFLOAT3 pos;								// world position
-	XMFLOAT3 forward;							// forward facing vector of the object
-	XMFLOAT3 rot;								// xyz rotation 
-
-	XMFLOAT4X4 mxlocal;							// local space matrix
-	XMFLOAT4X4 mxmodel;							// final model matrix
-
-	CTransform() : pos(0.f, 0.f, 0.f), forward(0.f, 0.f, 1.f) {
-		XMStoreFloat4x4(&mxmodel, XMMatrixIdentity());
-	}
-};
-
-struct CHierarchy {												
-	CHierarchy(int entityParent = -1) : entityParent(entityParent) {}			//-1 means it has no parent; may have children
-	int entityParent;
-	std::vector<UINT> childEntities;
-};
-
-struct CFace {
-	XMFLOAT3 color;
-};
-
-struct CPiece {};
-struct CPiece_Corner{};
-struct CPiece_Cross{};
-struct CPiece_Center{};
-
-struct CPivot {};
-
+#pragma once
+#include "stdafx.h"
+#include "Entity.h"
+
+using namespace DirectX;
+
+// one element of the instance structured buffer, padded to 16 bytes
+struct InstanceData {
+	DirectX::XMFLOAT4X4 matModel;
+	UINT colorIndex;
+	UINT pad[3];
+};
+
+struct CBuffPerPass {
+	DirectX::XMFLOAT4X4 matView;
+	DirectX::XMFLOAT4X4 matProj;
+};
+
+enum class PieceType {
+	PIECE_CORNER,
+	PIECE_CROSS,
+	PIECE_CENTER,
+	PIECETYPE_TOTAL
+};
+
+
+
+struct CBoundingBox {
+	BoundingOrientedBox obb;
+};
+
+
+struct CDraw {
+	CDraw(UINT drawIndex = 0, UINT baseVertex = 0, UINT startIndex = 0, UINT indexCount = 0, UINT meshIndex = 0) :
+		drawIndex(drawIndex), baseVertex(baseVertex), startIndex(startIndex), indexCount(indexCount), colorIndex(0), meshIndex(meshIndex) {}
+	UINT drawIndex;
+	UINT baseVertex;
+	UINT startIndex;
+	UINT indexCount;
+	UINT colorIndex;
+	UINT meshIndex;								// entities of the same mesh are drawn together, instanced
+};
+
+struct CTransform {
+	XMFLOAT3 pos;								// world position
+	XMFLOAT3 forward;							// forward facing vector of the object
+	XMFLOAT3 rot;								// xyz rotation 
+
+	XMFLOAT4X4 mxlocal;							// local space matrix
+	XMFLOAT4X4 mxmodel;							// final model matrix
+
+	CTransform() : pos(0.f, 0.f, 0.f), forward(0.f, 0.f, 1.f) {
+		XMStoreFloat4x4(&mxlocal, XMMatrixIdentity());
+		XMStoreFloat4x4(&mxmodel, XMMatrixIdentity());
+	}
+};
+
+struct CHierarchy {												
+	CHierarchy(UINT entityParent = NullEntity) : entityParent(entityParent) {}		//NullEntity means it has no parent; may have children
+	UINT entityParent;
+	std::vector<UINT> childEntities;
+};
+
+struct CFace {
+	XMFLOAT3 color;
+};
+
+struct CPiece {
+	int position[3] = { 0, 0, 0 };				// layer on each axis, 0 on the negative side
+};
+struct CPiece_Corner{};
+struct CPiece_Cross{};
+struct CPiece_Center{};
+
+struct CPivot {};
+
+struct CTurning {};												// piece turning with the pivot right now, recorded through the command buffers
+
 struct CCentralPivot {};
\ No newline at end of file
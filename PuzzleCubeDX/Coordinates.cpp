@@ -0,0 +1,131 @@
+#include "Coordinates.h"
+
+#include <algorithm>
+
+namespace {
+	const uint8_t MaxPieces = 12;
+
+	struct RankTables {
+		uint8_t bitCount[1 << MaxPieces];
+		uint32_t binomial[MaxPieces + 1][MaxPieces + 1];
+
+		RankTables() {
+			bitCount[0] = 0;
+			for (uint32_t i = 1; i < (1 << MaxPieces); i++)
+				bitCount[i] = bitCount[i >> 1] + (i & 1);
+
+			for (uint8_t n = 0; n <= MaxPieces; n++) {
+				binomial[n][0] = 1;
+				for (uint8_t k = 1; k <= MaxPieces; k++)
+					binomial[n][k] = n == 0 ? 0 : binomial[n - 1][k - 1] + binomial[n - 1][k];
+			}
+		}
+	};
+
+	const RankTables& getRankTables() {
+		static RankTables rankTables;
+		return rankTables;
+	}
+
+	// value minus the number of smaller values already used, ie. its index among the values still free
+	inline uint32_t freeIndex(const RankTables& tables, uint16_t used, uint8_t value) {
+		return value - tables.bitCount[used & ((1 << value) - 1)];
+	}
+
+	// the index-th value not in used
+	inline uint8_t selectFree(uint16_t used, uint32_t index) {
+		uint8_t value = 0;
+		for (;; value++) {
+			if (!(used & (1 << value)) && index-- == 0)
+				return value;
+		}
+	}
+}
+
+
+uint32_t rankPermutation(const uint8_t* perm, uint8_t n) {
+	return rankPartialPermutation(perm, n, n);
+}
+
+void unrankPermutation(uint32_t rank, uint8_t* perm, uint8_t n) {
+	unrankPartialPermutation(rank, perm, n, n);
+}
+
+uint32_t rankPartialPermutation(const uint8_t* values, uint8_t k, uint8_t n) {
+	auto& tables = getRankTables();
+	uint32_t rank = 0;
+	uint16_t used = 0;
+	for (uint8_t i = 0; i < k; i++) {
+		rank = rank * (n - i) + freeIndex(tables, used, values[i]);
+		used |= 1 << values[i];
+	}
+	return rank;
+}
+
+void unrankPartialPermutation(uint32_t rank, uint8_t* values, uint8_t k, uint8_t n) {
+	uint32_t digits[MaxPieces];
+	for (int i = k - 1; i >= 0; i--) {
+		digits[i] = rank % (n - i);
+		rank /= (n - i);
+	}
+
+	uint16_t used = 0;
+	for (uint8_t i = 0; i < k; i++) {
+		values[i] = selectFree(used, digits[i]);
+		used |= 1 << values[i];
+	}
+}
+
+uint32_t rankCombination(uint16_t mask, uint8_t k) {
+	auto& tables = getRankTables();
+	uint32_t rank = 0;
+	uint8_t chosen = 0;
+	for (uint8_t i = 0; chosen < k; i++) {
+		if (mask & (1 << i))
+			rank += tables.binomial[i][++chosen];
+	}
+	return rank;
+}
+
+uint16_t unrankCombination(uint32_t rank, uint8_t k) {
+	auto& tables = getRankTables();
+	uint16_t mask = 0;
+	for (uint8_t chosen = k; chosen > 0; chosen--) {
+		// the largest slot whose binomial still fits
+		uint8_t slot = chosen - 1;
+		while (tables.binomial[slot + 1][chosen] <= rank)
+			slot++;
+		rank -= tables.binomial[slot][chosen];
+		mask |= 1 << slot;
+	}
+	return mask;
+}
+
+uint32_t rankOrientation(const uint8_t* orientation, uint8_t n, uint8_t base) {
+	uint32_t rank = 0;
+	for (uint8_t i = 0; i + 1 < n; i++)
+		rank = rank * base + orientation[i];
+	return rank;
+}
+
+void unrankOrientation(uint32_t rank, uint8_t* orientation, uint8_t n, uint8_t base) {
+	uint32_t sum = 0;
+	for (int i = n - 2; i >= 0; i--) {
+		orientation[i] = static_cast<uint8_t>(rank % base);
+		sum += orientation[i];
+		rank /= base;
+	}
+	orientation[n - 1] = static_cast<uint8_t>((base - sum % base) % base);
+}
+
+bool isOddPermutation(const uint8_t* perm, uint8_t n) {
+	// the Lehmer digits add up to the number of inversions
+	auto& tables = getRankTables();
+	uint32_t inversions = 0;
+	uint16_t used = 0;
+	for (uint8_t i = 0; i < n; i++) {
+		inversions += freeIndex(tables, used, perm[i]);
+		used |= 1 << perm[i];
+	}
+	return inversions & 1;
+}
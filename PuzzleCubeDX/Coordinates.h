@@ -0,0 +1,182 @@
+// dense integer coordinates of cube states
+#pragma once
+#include "CubieCube.h"
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// ranking maps an arrangement to 0 .. count-1 and unranking maps it back, so tables over states are plain arrays.
+// n is at most 12 everywhere
+
+// Lehmer code of a permutation of 0..n-1, the digits are counted with a popcount table instead of a nested loop
+uint32_t rankPermutation(const uint8_t* perm, uint8_t n);
+void unrankPermutation(uint32_t rank, uint8_t* perm, uint8_t n);
+
+// k distinct values out of 0..n-1 in order, eg. where k tracked pieces are. n! / (n-k)! ranks
+uint32_t rankPartialPermutation(const uint8_t* values, uint8_t k, uint8_t n);
+void unrankPartialPermutation(uint32_t rank, uint8_t* values, uint8_t k, uint8_t n);
+
+// a set of k out of n slots as a bitmask, in the combinatorial number system. C(n, k) ranks
+uint32_t rankCombination(uint16_t mask, uint8_t k);
+uint16_t unrankCombination(uint32_t rank, uint8_t k);
+
+// orientations of n pieces in base 3 (corners) or 2 (edges). the last piece is left out since the sum is always 0
+// mod base, unrank sets it from the others
+uint32_t rankOrientation(const uint8_t* orientation, uint8_t n, uint8_t base);
+void unrankOrientation(uint32_t rank, uint8_t* orientation, uint8_t n, uint8_t base);
+
+bool isOddPermutation(const uint8_t* perm, uint8_t n);
+
+// one coordinate type per piece subset: Size ranks, get/set on a CubieCube, and the half of the cube a move changes
+// for it, so buildMoveTable and table indexing work the same for all of them
+struct TwistCoord {
+	static constexpr uint32_t Size = NumTwist;
+	static uint32_t get(const CubieCube& cube) { return cube.getTwist(); }
+	static void set(CubieCube& cube, uint32_t coord) { cube.setTwist(static_cast<uint16_t>(coord)); }
+	static void multiply(CubieCube& cube, const CubieCube& move) { cube.cornerMultiply(move); }
+};
+
+struct FlipCoord {
+	static constexpr uint32_t Size = NumFlip;
+	static uint32_t get(const CubieCube& cube) { return cube.getFlip(); }
+	static void set(CubieCube& cube, uint32_t coord) { cube.setFlip(static_cast<uint16_t>(coord)); }
+	static void multiply(CubieCube& cube, const CubieCube& move) { cube.edgeMultiply(move); }
+};
+
+struct SliceCoord {
+	static constexpr uint32_t Size = NumSlice;
+	static uint32_t get(const CubieCube& cube) { return cube.getSlice(); }
+	static void set(CubieCube& cube, uint32_t coord) { cube.setSlice(static_cast<uint16_t>(coord)); }
+	static void multiply(CubieCube& cube, const CubieCube& move) { cube.edgeMultiply(move); }
+};
+
+struct CornerPermCoord {
+	static constexpr uint32_t Size = NumCornerPerm;
+	static uint32_t get(const CubieCube& cube) { return cube.getCornerPerm(); }
+	static void set(CubieCube& cube, uint32_t coord) { cube.setCornerPerm(static_cast<uint16_t>(coord)); }
+	static void multiply(CubieCube& cube, const CubieCube& move) { cube.cornerMultiply(move); }
+};
+
+struct UDEdgePermCoord {
+	static constexpr uint32_t Size = NumUDEdgePerm;
+	static uint32_t get(const CubieCube& cube) { return cube.getUDEdgePerm(); }
+	static void set(CubieCube& cube, uint32_t coord) { cube.setUDEdgePerm(static_cast<uint16_t>(coord)); }
+	static void multiply(CubieCube& cube, const CubieCube& move) { cube.edgeMultiply(move); }
+};
+
+struct SlicePermCoord {
+	static constexpr uint32_t Size = NumSlicePerm;
+	static uint32_t get(const CubieCube& cube) { return cube.getSlicePerm(); }
+	static void set(CubieCube& cube, uint32_t coord) { cube.setSlicePerm(static_cast<uint16_t>(coord)); }
+	static void multiply(CubieCube& cube, const CubieCube& move) { cube.edgeMultiply(move); }
+};
+
+constexpr uint32_t countPartialPermutations(uint8_t n, uint8_t k) {
+	return k == 0 ? 1 : n * countPartialPermutations(n - 1, k - 1);
+}
+
+// slots of the Count edges FirstEdge .. FirstEdge + Count - 1, ignoring their flips. set puts the other edges in the
+// free slots
+template <uint8_t FirstEdge, uint8_t Count = 6>
+struct EdgePositionCoord {
+	static constexpr uint32_t Size = countPartialPermutations(EdgeCount, Count);	// 12! / (12 - Count)!
+
+	static uint32_t get(const CubieCube& cube) {
+		uint8_t slots[Count];
+		for (uint8_t slot = 0; slot < EdgeCount; slot++) {
+			uint8_t k = cube.ep[slot] - FirstEdge;
+			if (k < Count)
+				slots[k] = slot;
+		}
+		return rankPartialPermutation(slots, Count, EdgeCount);
+	}
+
+	static void set(CubieCube& cube, uint32_t coord) {
+		uint8_t slots[Count];
+		unrankPartialPermutation(coord, slots, Count, EdgeCount);
+		bool tracked[EdgeCount] = {};
+		for (uint8_t k = 0; k < Count; k++) {
+			cube.ep[slots[k]] = FirstEdge + k;
+			tracked[slots[k]] = true;
+		}
+		uint8_t other = (FirstEdge + Count) % EdgeCount;
+		for (uint8_t slot = 0; slot < EdgeCount; slot++) {
+			if (!tracked[slot]) {
+				cube.ep[slot] = other;
+				other = (other + 1) % EdgeCount;
+			}
+		}
+	}
+
+	static void multiply(CubieCube& cube, const CubieCube& move) { cube.edgeMultiply(move); }
+};
+
+// table[coord * numMoves + m] = coordinate after moves[m]
+template <typename Coord, typename T>
+void buildMoveTable(std::vector<T>& table, const Move* moves, uint8_t numMoves) {
+	table.resize(static_cast<size_t>(Coord::Size) * numMoves);
+	CubieCube cube;
+	for (uint32_t coord = 0; coord < Coord::Size; coord++) {
+		Coord::set(cube, coord);
+		for (uint8_t m = 0; m < numMoves; m++) {
+			CubieCube moved = cube;
+			Coord::multiply(moved, CubieCube::getMoveCube(moves[m]));
+			table[static_cast<size_t>(coord) * numMoves + m] = static_cast<T>(Coord::get(moved));
+		}
+	}
+}
+
+// distances to solved per coordinate, 4 bits each with 15 meaning not reached yet. half the size of a byte per entry
+// so more of a table stays in cache
+class DistanceTable {
+public:
+	static constexpr uint8_t Unvisited = 0xf;
+
+	// for tables that are not owned, eg. mapped from a file
+	static uint8_t get(const uint8_t* data, size_t index) {
+		return (data[index >> 1] >> ((index & 1) * 4)) & 0xf;
+	}
+
+	// for tables several threads fill at once, same layout
+	static uint8_t get(const std::atomic<uint8_t>* data, size_t index) {
+		return (data[index >> 1].load(std::memory_order_relaxed) >> ((index & 1) * 4)) & 0xf;
+	}
+
+	// set an unvisited entry, false if another thread got there first
+	static bool setUnvisited(std::atomic<uint8_t>* data, size_t index, uint8_t distance) {
+		int shift = (index & 1) * 4;
+		auto& byte = data[index >> 1];
+		uint8_t current = byte.load(std::memory_order_relaxed);
+		do {
+			if (((current >> shift) & 0xf) != Unvisited)
+				return false;
+		} while (!byte.compare_exchange_weak(current, static_cast<uint8_t>((current & ~(0xf << shift)) | (distance << shift)),
+			std::memory_order_relaxed));
+		return true;
+	}
+
+	void reset(size_t size) {
+		count = size;
+		bytes.assign((size + 1) / 2, 0xff);
+	}
+
+	uint8_t get(size_t index) const {
+		return get(bytes.data(), index);
+	}
+
+	void set(size_t index, uint8_t distance) {
+		uint8_t& byte = bytes[index >> 1];
+		int shift = (index & 1) * 4;
+		byte = static_cast<uint8_t>((byte & ~(0xf << shift)) | (distance << shift));
+	}
+
+	size_t getSize() const { return count; }
+	size_t getByteSize() const { return bytes.size(); }
+	const uint8_t* getData() const { return bytes.data(); }
+	uint8_t* getData() { return bytes.data(); }
+
+private:
+	std::vector<uint8_t> bytes;
+	size_t count = 0;
+};
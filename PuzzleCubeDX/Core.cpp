@@ -1,625 +1,661 @@
-#include "Core.h"
-#include "Helper.h"
-#include "imgui_heap_alloc.h"
-
-#include <windowsx.h>
-
-using namespace DirectX;
-ImguiheapAlloc imguiHeapAlloc;
-extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);                // Use ImGui::GetCurrentContext()
-
-
-Core::Core(int wndWidth, int wndHeight) : mWndWidth(wndWidth), mWndHeight(wndHeight), 
-	mMinimized(false), mMaximized(false),
-	mUseMSAA(false), mMSAAQualityLevel(0),
-	mCurrentFence(0),
-	mLeftBtnDown(false), mRightBtnDown(false)
-{
-	levelLoader = std::make_unique<LevelLoader>();
-	registry = std::make_shared<Registry>();
-	snprintf(szcmds, 256, "");
-
-}
-
-void Core::initialize() {
-
-	// Make process DPI aware and obtain main monitor scale
-	ImGui_ImplWin32_EnableDpiAwareness();
-	float mainScale = ImGui_ImplWin32_GetDpiScaleForMonitor(::MonitorFromPoint(POINT{ 0, 0 }, MONITOR_DEFAULTTOPRIMARY));
-	// Setup Dear ImGui context
-	IMGUI_CHECKVERSION();
-	ImGui::CreateContext();
-	ImGuiIO& io = ImGui::GetIO(); (void)io;
-	io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;     // Enable Keyboard Controls
-	io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;      // Enable Gamepad Controls
-
-	// setup d3dx12
-	initD3D12Device();
-	createSwapChain();
-
-	ThrowIfFailed(mCommandList->Reset(mCmdAlloc.Get(), nullptr));
-
-	createRTandDSViews();
-
-	loadAssets();
-	loadPipeline();
-
-	//done recording
-	mCommandList->Close();
-	ID3D12CommandList* cmdLists[] = { mCommandList.Get() };
-	mCmdQueue->ExecuteCommandLists(1, cmdLists);
-	flushCommandQueue();
-
-	// cleanup resources after done executing commands
-	//levelLoader.reset();
-	initImgui(mainScale);
-
-}
-
-LRESULT Core::run(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam) {
-	if (ImGui_ImplWin32_WndProcHandler(hwnd, msg, wparam, lparam))
-		return true;
-
-	switch (msg) {
-	case WM_LBUTTONDOWN:
-	case WM_MBUTTONDOWN:
-	case WM_RBUTTONDOWN:
-		OnMouseDown(wparam, GET_X_LPARAM(lparam), GET_Y_LPARAM(lparam));
-		return 0;
-	case WM_LBUTTONUP:
-	case WM_MBUTTONUP:
-	case WM_RBUTTONUP:
-		OnMouseUp(wparam, GET_X_LPARAM(lparam), GET_Y_LPARAM(lparam));
-		return 0;
-	case WM_MOUSEMOVE:
-		OnMouseMove(wparam, GET_X_LPARAM(lparam), GET_Y_LPARAM(lparam));
-		return 0;
-
-	case WM_SIZE:
-		// save new window dimensions after resize
-		mWndWidth = LOWORD(lparam);
-		mWndHeight = HIWORD(lparam);
-		if (mDevice)
-		{
-			if (wparam == SIZE_MAXIMIZED) {
-				mMinimized = false;
-				mMaximized = true;
-				onResize();
-			}
-			else if (wparam == SIZE_RESTORED) {
-
-				// Restoring from minimized state?
-				if (mMinimized) {
-					mMinimized = false;
-					onResize();
-				}
-
-				// Restoring from maximized state?
-				else if (mMaximized) {
-					mMaximized = false;
-					onResize();
-				}
-				else {												// API call such as SetWindowPos or mSwapChain->SetFullscreenState.
-					onResize();
-				}
-			}
-		}
-		return 0;
-	
-	case WM_PAINT:
-		onUpdate();
-		onRender();
-
-		return 0;
-
-
-	case WM_DESTROY:
-		PostQuitMessage(0);
-		return 0;
-	}
-
-	return DefWindowProc(hwnd, msg, wparam, lparam);
-}
-void Core::OnMouseDown(WPARAM btnState, int x, int y) {
-	mLastMousePos.x = x;
-	mLastMousePos.y = y;
-
-	SetCapture(hwnd);
-
-	mUpdateView = true;
-}
-
-void Core::OnMouseUp(WPARAM btnState, int x, int y) {
-	ReleaseCapture();
-	mUpdateView = false;
-	
-	// reset cam after releasing right mouse
-	if (mRightBtnDown) {
-		mRightBtnDown = false;
-		mTheta = mPhi = XM_PIDIV2;
-		renderSystem.onUpdateView(mRadius, mTheta, mPhi);
-	}
-}
-
-void Core::OnMouseMove(WPARAM btnState, int x, int y)
-{
-	if ((btnState & MK_LBUTTON) != 0)
-	{
-		// Make each pixel correspond to a quarter of a degree.
-		float dx = XMConvertToRadians(0.25f * static_cast<float>(x - mLastMousePos.x));
-		float dy = XMConvertToRadians(0.25f * static_cast<float>(y - mLastMousePos.y));
-
-		// Update angles based on input to orbit camera around box.
-		mTheta += dx;
-		mPhi += dy;
-
-		// Restrict the angles when using right click mouse movement
-		mTheta = std::clamp(mTheta, 0.75f, 2.35f);
-		mPhi = std::clamp(mPhi, 1.0f, 2.15f);
-	}
-	else if ((btnState & MK_MBUTTON) != 0) {
-		mRightBtnDown = true;
-
-		// Make each pixel correspond to a quarter of a degree.
-		float dx = XMConvertToRadians(0.25f * static_cast<float>(x - mLastMousePos.x));
-		float dy = XMConvertToRadians(0.25f * static_cast<float>(y - mLastMousePos.y));
-
-		// Update angles based on input to orbit camera around box.
-		mTheta += dx;
-		mPhi += dy;
-		mPhi = std::clamp(mPhi, 0.1f, XM_PI - 0.1f);
-	}
-	else if ((btnState & MK_RBUTTON) != 0)
-	{
-		// Make each pixel correspond to 0.005 unit in the scene.
-		float dx = 0.005f * static_cast<float>(x - mLastMousePos.x);
-		float dy = 0.005f * static_cast<float>(y - mLastMousePos.y);
-
-		// Update the camera radius based on input.
-		mRadius += dx - dy;
-
-		// Restrict the radius.
-		mRadius = std::clamp(mRadius, 3.0f, 15.0f);
-	}
-
-	mLastMousePos.x = x;
-	mLastMousePos.y = y;
-}
-
-
-void Core::onUpdate() {
-	timer.Tick();
-
-	if (gameplaySystem.onUpdate(timer.GetElapsedSeconds()))
-		renderSystem.onUpdateTransformations();
-
-	if (mUpdateView) 
-		renderSystem.onUpdateView(mRadius, mTheta, mPhi);
-
-}
-
-void Core::onRender() {
-	renderImgui();
-
-	ThrowIfFailed(mCmdAlloc->Reset());
-	ThrowIfFailed(mCommandList->Reset(mCmdAlloc.Get(), mPipelineState.Get()));
-
-	mCommandList->RSSetViewports(1, &mViewport);
-	mCommandList->RSSetScissorRects(1, &mScissorRect);
-
-	// commands for clear the back buffer and depth buffer
-	ID3D12Resource* backBuffer = mSwapChainBuffer[mCurrBackBuffer].Get();
-	auto rtResourceBarrier = CD3DX12_RESOURCE_BARRIER::Transition(backBuffer, D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
-	auto backBufferView = getCurrentBackBufferView();
-	auto depthBufferView = getDepthStencilView();
-
-	const float colorbg[] = {0.56f, 0.f, 0.27f, 1.f};
-	mCommandList->ResourceBarrier(1, &rtResourceBarrier);
-	mCommandList->ClearRenderTargetView(backBufferView, colorbg, 0, nullptr);
-	mCommandList->ClearDepthStencilView(depthBufferView, D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
-	mCommandList->OMSetRenderTargets(1, &backBufferView, true, &depthBufferView);
-
-	renderSystem.onDraw(mCommandList.Get());
-	ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), mCommandList.Get());
-
-	rtResourceBarrier = CD3DX12_RESOURCE_BARRIER::Transition(backBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
-	mCommandList->ResourceBarrier(1, &rtResourceBarrier);
-
-	//done recording
-	mCommandList->Close();
-	ID3D12CommandList* cmdLists[] = { mCommandList.Get() };
-	mCmdQueue->ExecuteCommandLists(1, cmdLists);
-
-	ThrowIfFailed(mSwapChain->Present(1, 0));
-	mCurrBackBuffer = (mCurrBackBuffer + 1) % mSwapChainBufferCount;
-
-	flushCommandQueue();
-}
-
-void Core::renderImgui() {
-	// Start the Dear ImGui frame
-	ImGui_ImplDX12_NewFrame();
-	ImGui_ImplWin32_NewFrame();
-	ImGui::NewFrame();
-
-	ImGuiWindowFlags window_flags = ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoBackground;
-	ImGui::Begin("Interact", 0, window_flags);   
-	ImGui::SetWindowPos(ImVec2(0.f, mWndHeight - 230.f));
-	for(int k = 0; k < 6; k++)
-	for (int i = 0; i < 6; i++)
-	{
-		if (i > 0)
-			ImGui::SameLine();
-		ImGui::PushID(k * i);
-		ImGui::PushStyleColor(ImGuiCol_Button, (ImVec4)ImColor::HSV(i / 7.0f, 0.6f, 0.6f));
-		ImGui::PushStyleColor(ImGuiCol_ButtonHovered, (ImVec4)ImColor::HSV(i / 7.0f, 0.7f, 0.7f));
-		ImGui::PushStyleColor(ImGuiCol_ButtonActive, (ImVec4)ImColor::HSV(i / 7.0f, 0.8f, 0.8f));
-		if (ImGui::Button(gameplaySystem.cubeNotations[6 * k + i].c_str(), ImVec2(40, 25))) {
-			gameplaySystem.processInputCmd(gameplaySystem.cubeNotations[6 * k + i].c_str());
-		}
-			
-		ImGui::PopStyleColor(3);
-		ImGui::PopID();
-	}
-	ImGui::NewLine();
-	ImGui::InputText("Input", szcmds, 256);
-	ImGui::SameLine();
-	if (ImGui::Button("Enter")) {
-		gameplaySystem.processInputCmd(szcmds);
-	}
-	ImGui::End();
-
-
-	ImGui::Begin("reset", 0, window_flags);
-	ImGui::SetWindowPos(ImVec2(mWndWidth / 2.f - 58.f, mWndHeight - 39.f));
-	if (ImGui::Button("Reset")) {
-		gameplaySystem.onReset();
-		renderSystem.onUpdateTransformations();
-	}
-	ImGui::SameLine();
-	if (ImGui::Button("Shuffle"))
-		gameplaySystem.onShuffle();
-	ImGui::NewLine();
-	ImGui::End();
-
-	ImGui::Begin("Interface", 0, window_flags);
-	ImGui::Text("Left   Mouse to Rotate Camera");
-	ImGui::Text("Middle Mouse to Free Rotate");
-	ImGui::Text("Right  Mouse to Zoom Camera");
-	ImGui::End();
-
-	ImGui::Begin("about", 0, window_flags);
-	ImGui::Text("//chirag");
-	ImGui::SetWindowPos(ImVec2(mWndWidth - 70.f, mWndHeight - 34.f));
-	ImGui::End();
-
-
-	// Rendering
-	ImGui::Render();
-}
-
-void Core::onResize() {
-	// if the window is resized, create new swap chain and buffers to updated window dimensions
-
-	flushCommandQueue();
-	ThrowIfFailed(mCmdAlloc->Reset());
-	ThrowIfFailed(mCommandList->Reset(mCmdAlloc.Get(), nullptr));
-
-
-	for (UINT i = 0; i < mSwapChainBufferCount; i++)
-		mSwapChainBuffer[i].Reset();
-
-	mDepthStencilBuffer.Reset();
-
-	// Resize the swap chain buffers. Call this to avoid errors
-	ThrowIfFailed(mSwapChain->ResizeBuffers(mSwapChainBufferCount, mWndWidth, mWndHeight, mBackBufferFormat, DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH));
-
-	// recreate both swapchain and the rtv dsv with new sizes
-	createSwapChain();
-	createRTandDSViews();
-
-	// execute commands for buffer operations
-	mCommandList->Close();
-	ID3D12CommandList* cmdLists[] = { mCommandList.Get() };
-	mCmdQueue->ExecuteCommandLists(1, cmdLists);
-	flushCommandQueue();
-
-
-	mViewport.TopLeftX = 0.0f;
-	mViewport.TopLeftY = 0.0f;
-	mViewport.Width = static_cast<float>(mWndWidth);
-	mViewport.Height = static_cast<float>(mWndHeight);
-	mViewport.MinDepth = 0.0f;
-	mViewport.MaxDepth = 1.0f;
-
-	mScissorRect = { 0, 0, mWndWidth, mWndHeight };
-}
-
-void Core::destroy() {
-
-}
-
-void Core::flushCommandQueue() {
-	mCurrentFence++;
-	ThrowIfFailed(mCmdQueue->Signal(mFence.Get(), mCurrentFence));
-
-	if (mFence->GetCompletedValue() < mCurrentFence) {
-
-		HANDLE eventHandle = CreateEventEx(nullptr, 0, 0, EVENT_ALL_ACCESS);
-		ThrowIfFailed(mFence->SetEventOnCompletion(mCurrentFence, eventHandle));
-		
-		WaitForSingleObject(eventHandle, INFINITE);
-		CloseHandle(eventHandle);
-	}
-}
-
-
-void Core::initImgui(float mainScale) {
-	// Setup Dear ImGui style
-	ImGui::StyleColorsDark();
-	//ImGui::StyleColorsLight();
-
-	// Setup scaling
-	ImGuiStyle& style = ImGui::GetStyle();
-	style.ScaleAllSizes(mainScale);        // Bake a fixed style scale. (until we have a solution for dynamic style scaling, changing this requires resetting Style + calling this again)
-	style.FontScaleDpi = mainScale;        // Set initial font scale. (using io.ConfigDpiScaleFonts=true makes this unnecessary. We leave both here for documentation purpose)
-
-	// Setup Platform/Renderer backends
-	ImGui_ImplWin32_Init(hwnd);
-
-	imguiHeapAlloc.Create(mDevice.Get(), renderSystem.getCBVHeap());
-
-	ImGui_ImplDX12_InitInfo init_info = {};
-	init_info.Device = mDevice.Get();
-	init_info.CommandQueue = mCmdQueue.Get();
-	init_info.NumFramesInFlight = 1;
-	init_info.RTVFormat = mBackBufferFormat;
-	init_info.DSVFormat = mDepthStencilFormat;
-	// Allocating SRV descriptors (for textures) is up to the application, so we provide callbacks.
-	// (current version of the backend will only allocate one descriptor, future versions will need to allocate more)
-	init_info.SrvDescriptorHeap = renderSystem.getCBVHeap();
-	init_info.SrvDescriptorAllocFn = [](ImGui_ImplDX12_InitInfo*, D3D12_CPU_DESCRIPTOR_HANDLE* out_cpu_handle, D3D12_GPU_DESCRIPTOR_HANDLE* out_gpu_handle) { return imguiHeapAlloc.Alloc(out_cpu_handle, out_gpu_handle); };
-	init_info.SrvDescriptorFreeFn = [](ImGui_ImplDX12_InitInfo*, D3D12_CPU_DESCRIPTOR_HANDLE cpu_handle, D3D12_GPU_DESCRIPTOR_HANDLE gpu_handle) { return imguiHeapAlloc.Free(cpu_handle, gpu_handle); };
-	ImGui_ImplDX12_Init(&init_info);
-}
-
-void Core::loadAssets() { 
-	// order matters
-	levelLoader->loadLevel(registry);												// load and assemble
-	renderSystem.onInit(mDevice.Get(),												// create model matrices and get forward vector
-		mCommandList.Get(), registry, 
-		static_cast<float>(mWndWidth) / static_cast<float>(mWndHeight), 
-		levelLoader->vertBuffData, levelLoader->indexBuffData); 
-	gameplaySystem.onInit(registry, mWndWidth, mWndHeight);												// color the faces when after getting forward vectors
-
-
-	// update at least once after load
-	renderSystem.onUpdateTransformations();
-	renderSystem.onUpdateView(mRadius, mTheta, mPhi);
-}
-
-
-void Core::loadPipeline() {
-	// Compile shaders
-#if defined(_DEBUG)
-// Enable better shader debugging with the graphics debugging tools.
-	UINT compileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
-#else
-	UINT compileFlags = 0;
-#endif
-
-	D3D12_INPUT_ELEMENT_DESC vertexElementDesc[] = {
-	{"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-	{"COLOR", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0}
-	};
-
-	ComPtr<ID3DBlob> vertexShader;
-	ComPtr<ID3DBlob> pixelShader;
-	HRESULT hr = D3DCompileFromFile(L"./shaders/color.hlsl", nullptr, nullptr, "VSMain", "vs_5_0", compileFlags, 0, &vertexShader, nullptr);
-	if (FAILED(hr))
-		MessageBox(0, L"Error: Shader Compile From File", 0, 0);
-
-	hr = D3DCompileFromFile(L"./shaders/color.hlsl", nullptr, nullptr, "PSMain", "ps_5_0", compileFlags, 0, &pixelShader, nullptr);
-	if (FAILED(hr))
-		MessageBox(0, L"Error: Shader Compile From File", 0, 0);
-
-	D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc;
-	ZeroMemory(&psoDesc, sizeof(D3D12_GRAPHICS_PIPELINE_STATE_DESC));
-	psoDesc.InputLayout = { vertexElementDesc, _countof(vertexElementDesc) };
-	psoDesc.pRootSignature = renderSystem.getRootSignature();
-	psoDesc.VS = CD3DX12_SHADER_BYTECODE(vertexShader.Get());
-	psoDesc.PS = CD3DX12_SHADER_BYTECODE(pixelShader.Get());
-	psoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
-	psoDesc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
-	psoDesc.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
-	psoDesc.SampleMask = UINT_MAX;
-	psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
-	psoDesc.NumRenderTargets = 1;
-	psoDesc.RTVFormats[0] = mBackBufferFormat;
-	psoDesc.SampleDesc.Count = mUseMSAA ? 4 : 1;
-	psoDesc.SampleDesc.Quality = mUseMSAA ? (mMSAAQualityLevel - 1) : 0;
-	psoDesc.DSVFormat = mDepthStencilFormat;
-
-	ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineState)));
-}
-
-
-void Core::initD3D12Device() {
-	UINT dxgiFactoryFlags = 0;
-
-#if defined(DEBUG) || defined(_DEBUG) 
-	ComPtr<ID3D12Debug>	debugController;
-	if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&debugController)))) {
-		debugController->EnableDebugLayer();
-		// Enable additional debug layers.
-		dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
-	}
-#endif
-
-	
-	ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mFactory)));
-
-	//device
-	auto result = D3D12CreateDevice(nullptr, D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(&mDevice));
-	// fallback to WARP if no device found
-	if (FAILED(result)) {
-		ComPtr<IDXGIAdapter> warpAdapter;
-		ThrowIfFailed(mFactory->EnumWarpAdapter(IID_PPV_ARGS(&warpAdapter)));
-
-		//create device again with the WARP adapter this time
-		ThrowIfFailed(D3D12CreateDevice(warpAdapter.Get(), D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(&mDevice)));
-	}
-
-
-	// fence
-	ThrowIfFailed(mDevice->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
-
-	// query descriptor increment sizes
-	mRtvDescriptorSize = mDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
-	mDsvDescriptorSize = mDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
-	
-
-	// MSAA support level 4X
-	D3D12_FEATURE_DATA_MULTISAMPLE_QUALITY_LEVELS msQualityLevels;
-	msQualityLevels.Format = mBackBufferFormat;
-	msQualityLevels.NumQualityLevels = 0;
-	msQualityLevels.SampleCount = 4;
-	msQualityLevels.Flags = D3D12_MULTISAMPLE_QUALITY_LEVELS_FLAG_NONE;
-	ThrowIfFailed(
-		mDevice->CheckFeatureSupport(D3D12_FEATURE_MULTISAMPLE_QUALITY_LEVELS, &msQualityLevels, sizeof(msQualityLevels))
-	);
-	mMSAAQualityLevel = msQualityLevels.NumQualityLevels;
-
-
-	// Command Objects
-	D3D12_COMMAND_QUEUE_DESC queueDesc = {};
-	queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
-	queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
-	ThrowIfFailed(
-		mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCmdQueue))
-	);
-	ThrowIfFailed(
-		mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(mCmdAlloc.GetAddressOf()))
-	);
-	ThrowIfFailed(
-		mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, mCmdAlloc.Get(), nullptr, IID_PPV_ARGS(mCommandList.GetAddressOf()))
-	);
-	// Close at first so reset can be called on it before we use it
-	mCommandList->Close();
-
-
-	// create Descriptor Heaps
-	D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc;
-	rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
-	rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;							//rtv is not shader visible
-	rtvHeapDesc.NumDescriptors = mSwapChainBufferCount;
-	rtvHeapDesc.NodeMask = 0;
-	ThrowIfFailed(
-		mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(mRtvHeap.GetAddressOf()))
-	);
-	D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc;
-	dsvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
-	dsvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;							//rtv is not shader visible
-	dsvHeapDesc.NumDescriptors = 1;
-	dsvHeapDesc.NodeMask = 0;
-	ThrowIfFailed(
-		mDevice->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(mDsvHeap.GetAddressOf()))
-	);
-}
-
-
-void Core::createSwapChain() {
-	// release prev swapchain
-	mSwapChain.Reset();
-	// reset back currentbackbuffer index since a new swapchain will be made
-	mCurrBackBuffer = 0;
-
-	DXGI_SWAP_CHAIN_DESC swapchainDesc = {0};
-	swapchainDesc.BufferDesc.Width = mWndWidth;
-	swapchainDesc.BufferDesc.Height = mWndHeight;
-	swapchainDesc.BufferDesc.RefreshRate.Numerator = 60;
-	swapchainDesc.BufferDesc.RefreshRate.Denominator = 1;
-	swapchainDesc.BufferDesc.Format = mBackBufferFormat;
-	swapchainDesc.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
-	swapchainDesc.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
-	swapchainDesc.SampleDesc.Count = mUseMSAA ? 4 : 1;
-	swapchainDesc.SampleDesc.Quality = mUseMSAA ? (mMSAAQualityLevel - 1) : 0;
-	swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-	swapchainDesc.BufferCount = mSwapChainBufferCount;
-	swapchainDesc.OutputWindow = hwnd;
-	swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
-	
-	//windowed
-	swapchainDesc.Windowed = true;
-	swapchainDesc.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH;
-
-	ThrowIfFailed(
-		mFactory->CreateSwapChain(mCmdQueue.Get(), &swapchainDesc, mSwapChain.GetAddressOf())
-	);
-
-}
-
-void Core::createRTandDSViews() {	
-	CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHeapHandle(mRtvHeap->GetCPUDescriptorHandleForHeapStart());
-	for (UINT i = 0; i < mSwapChainBufferCount; i++) {
-		ThrowIfFailed(
-			mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mSwapChainBuffer[i]))
-		);
-
-		mDevice->CreateRenderTargetView(mSwapChainBuffer[i].Get(), nullptr, rtvHeapHandle);
-
-		rtvHeapHandle.Offset(1, mRtvDescriptorSize);
-	}
-
-	//create Depth Stencil View
-	D3D12_RESOURCE_DESC depthStencilDesc;
-	depthStencilDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-	depthStencilDesc.Format = mDepthStencilFormat;
-	depthStencilDesc.Alignment = 0;
-	depthStencilDesc.Width = mWndWidth;
-	depthStencilDesc.Height = mWndHeight;
-	depthStencilDesc.DepthOrArraySize = 1;
-	depthStencilDesc.MipLevels = 1;
-	depthStencilDesc.SampleDesc.Count = mUseMSAA ? 4 : 1;
-	depthStencilDesc.SampleDesc.Quality = mUseMSAA ? (mMSAAQualityLevel - 1) : 0;
-	depthStencilDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
-	depthStencilDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
-
-	//clear value
-	D3D12_CLEAR_VALUE optClear;
-	optClear.Format = mDepthStencilFormat;
-	optClear.DepthStencil.Depth = 1.0f;
-	optClear.DepthStencil.Stencil = 0;
-
-	CD3DX12_HEAP_PROPERTIES heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
-	ThrowIfFailed(
-		mDevice->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &depthStencilDesc, D3D12_RESOURCE_STATE_COMMON, &optClear, IID_PPV_ARGS(mDepthStencilBuffer.GetAddressOf()))
-	);
-	mDevice->CreateDepthStencilView(mDepthStencilBuffer.Get(), nullptr, getDepthStencilView());
-
-	CD3DX12_RESOURCE_BARRIER resbDepthWrite = CD3DX12_RESOURCE_BARRIER::Transition(mDepthStencilBuffer.Get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_DEPTH_WRITE);
-	mCommandList->ResourceBarrier(1, &resbDepthWrite);
-}
-
-
-
-D3D12_CPU_DESCRIPTOR_HANDLE Core::getCurrentBackBufferView() {
-	return CD3DX12_CPU_DESCRIPTOR_HANDLE(mRtvHeap->GetCPUDescriptorHandleForHeapStart(), mCurrBackBuffer, mRtvDescriptorSize);
-}
-
-D3D12_CPU_DESCRIPTOR_HANDLE Core::getDepthStencilView() {
-	return mDsvHeap->GetCPUDescriptorHandleForHeapStart();
-}
-
-ComPtr<ID3D12Resource> Core::getCurrentBackBuffer() const {
-	return mSwapChainBuffer[mCurrBackBuffer].Get();
-}
-
-
-
-int Core::getWndWidth() const {
-	return mWndWidth;
-}
-int Core::getWndHeight() const {
-	return mWndHeight;
+#include "Core.h"
+#include "Helper.h"
+#include "imgui_heap_alloc.h"
+
+#include <windowsx.h>
+
+using namespace DirectX;
+ImguiheapAlloc imguiHeapAlloc;
+extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);                // Use ImGui::GetCurrentContext()
+
+
+Core::Core(int wndWidth, int wndHeight, uint16_t cubeSize) : mWndWidth(wndWidth), mWndHeight(wndHeight), mCubeSize(std::clamp(cubeSize, MinCubeSize, MaxCubeSize)), 
+	mMinimized(false), mMaximized(false),
+	mUseMSAA(false), mMSAAQualityLevel(0),
+	mCurrentFence(0),
+	mLeftBtnDown(false), mRightBtnDown(false)
+{
+	levelLoader = std::make_unique<LevelLoader>();
+	registry = std::make_shared<Registry>();
+	snprintf(szcmds, 256, "");
+
+}
+
+void Core::initialize() {
+
+	// Make process DPI aware and obtain main monitor scale
+	ImGui_ImplWin32_EnableDpiAwareness();
+	float mainScale = ImGui_ImplWin32_GetDpiScaleForMonitor(::MonitorFromPoint(POINT{ 0, 0 }, MONITOR_DEFAULTTOPRIMARY));
+	// Setup Dear ImGui context
+	IMGUI_CHECKVERSION();
+	ImGui::CreateContext();
+	ImGuiIO& io = ImGui::GetIO(); (void)io;
+	io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;     // Enable Keyboard Controls
+	io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;      // Enable Gamepad Controls
+
+	// setup d3dx12
+	initD3D12Device();
+	createSwapChain();
+
+	ThrowIfFailed(mCommandList->Reset(mCmdAlloc.Get(), nullptr));
+
+	createRTandDSViews();
+
+	loadAssets();
+	loadPipeline();
+
+	//done recording
+	mCommandList->Close();
+	ID3D12CommandList* cmdLists[] = { mCommandList.Get() };
+	mCmdQueue->ExecuteCommandLists(1, cmdLists);
+	flushCommandQueue();
+
+	// cleanup resources after done executing commands
+	//levelLoader.reset();
+	initImgui(mainScale);
+
+}
+
+LRESULT Core::run(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam) {
+	if (ImGui_ImplWin32_WndProcHandler(hwnd, msg, wparam, lparam))
+		return true;
+
+	switch (msg) {
+	case WM_LBUTTONDOWN:
+	case WM_MBUTTONDOWN:
+	case WM_RBUTTONDOWN:
+		OnMouseDown(wparam, GET_X_LPARAM(lparam), GET_Y_LPARAM(lparam));
+		return 0;
+	case WM_LBUTTONUP:
+	case WM_MBUTTONUP:
+	case WM_RBUTTONUP:
+		OnMouseUp(wparam, GET_X_LPARAM(lparam), GET_Y_LPARAM(lparam));
+		return 0;
+	case WM_MOUSEMOVE:
+		OnMouseMove(wparam, GET_X_LPARAM(lparam), GET_Y_LPARAM(lparam));
+		return 0;
+
+	case WM_SIZE:
+		// save new window dimensions after resize
+		mWndWidth = LOWORD(lparam);
+		mWndHeight = HIWORD(lparam);
+		if (mDevice)
+		{
+			if (wparam == SIZE_MAXIMIZED) {
+				mMinimized = false;
+				mMaximized = true;
+				onResize();
+			}
+			else if (wparam == SIZE_RESTORED) {
+
+				// Restoring from minimized state?
+				if (mMinimized) {
+					mMinimized = false;
+					onResize();
+				}
+
+				// Restoring from maximized state?
+				else if (mMaximized) {
+					mMaximized = false;
+					onResize();
+				}
+				else {												// API call such as SetWindowPos or mSwapChain->SetFullscreenState.
+					onResize();
+				}
+			}
+		}
+		return 0;
+	
+	case WM_PAINT:
+		onUpdate();
+		onRender();
+
+		return 0;
+
+
+	case WM_DESTROY:
+		PostQuitMessage(0);
+		return 0;
+	}
+
+	return DefWindowProc(hwnd, msg, wparam, lparam);
+}
+void Core::OnMouseDown(WPARAM btnState, int x, int y) {
+	mLastMousePos.x = x;
+	mLastMousePos.y = y;
+
+	SetCapture(hwnd);
+
+	mUpdateView = true;
+}
+
+void Core::OnMouseUp(WPARAM btnState, int x, int y) {
+	ReleaseCapture();
+	mUpdateView = false;
+	
+	// reset cam after releasing right mouse
+	if (mRightBtnDown) {
+		mRightBtnDown = false;
+		mTheta = mPhi = XM_PIDIV2;
+		renderSystem.onUpdateView(mRadius, mTheta, mPhi);
+	}
+}
+
+void Core::OnMouseMove(WPARAM btnState, int x, int y)
+{
+	if ((btnState & MK_LBUTTON) != 0)
+	{
+		// Make each pixel correspond to a quarter of a degree.
+		float dx = XMConvertToRadians(0.25f * static_cast<float>(x - mLastMousePos.x));
+		float dy = XMConvertToRadians(0.25f * static_cast<float>(y - mLastMousePos.y));
+
+		// Update angles based on input to orbit camera around box.
+		mTheta += dx;
+		mPhi += dy;
+
+		// Restrict the angles when using right click mouse movement
+		mTheta = std::clamp(mTheta, 0.75f, 2.35f);
+		mPhi = std::clamp(mPhi, 1.0f, 2.15f);
+	}
+	else if ((btnState & MK_MBUTTON) != 0) {
+		mRightBtnDown = true;
+
+		// Make each pixel correspond to a quarter of a degree.
+		float dx = XMConvertToRadians(0.25f * static_cast<float>(x - mLastMousePos.x));
+		float dy = XMConvertToRadians(0.25f * static_cast<float>(y - mLastMousePos.y));
+
+		// Update angles based on input to orbit camera around box.
+		mTheta += dx;
+		mPhi += dy;
+		mPhi = std::clamp(mPhi, 0.1f, XM_PI - 0.1f);
+	}
+	else if ((btnState & MK_RBUTTON) != 0)
+	{
+		// Make each pixel correspond to 0.005 unit in the scene.
+		float dx = 0.005f * static_cast<float>(x - mLastMousePos.x);
+		float dy = 0.005f * static_cast<float>(y - mLastMousePos.y);
+
+		// Update the camera radius based on input.
+		mRadius += dx - dy;
+
+		// Restrict the radius.
+		mRadius = std::clamp(mRadius, 3.0f, 15.0f);
+	}
+
+	mLastMousePos.x = x;
+	mLastMousePos.y = y;
+}
+
+
+void Core::onUpdate() {
+	timer.Tick();
+
+	scheduler.onUpdate(static_cast<float>(timer.GetElapsedSeconds()));
+
+	// sync point, structural changes recorded by systems this frame are applied here
+	commandBuffers.playback(*registry);
+
+	if (mUpdateView) 
+		renderSystem.onUpdateView(mRadius, mTheta, mPhi);
+
+}
+
+void Core::onRender() {
+	renderImgui();
+
+	ThrowIfFailed(mCmdAlloc->Reset());
+	ThrowIfFailed(mCommandList->Reset(mCmdAlloc.Get(), mPipelineState.Get()));
+
+	mCommandList->RSSetViewports(1, &mViewport);
+	mCommandList->RSSetScissorRects(1, &mScissorRect);
+
+	// commands for clear the back buffer and depth buffer
+	ID3D12Resource* backBuffer = mSwapChainBuffer[mCurrBackBuffer].Get();
+	auto rtResourceBarrier = CD3DX12_RESOURCE_BARRIER::Transition(backBuffer, D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
+	auto backBufferView = getCurrentBackBufferView();
+	auto depthBufferView = getDepthStencilView();
+
+	const float colorbg[] = {0.56f, 0.f, 0.27f, 1.f};
+	mCommandList->ResourceBarrier(1, &rtResourceBarrier);
+	mCommandList->ClearRenderTargetView(backBufferView, colorbg, 0, nullptr);
+	mCommandList->ClearDepthStencilView(depthBufferView, D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
+	mCommandList->OMSetRenderTargets(1, &backBufferView, true, &depthBufferView);
+
+	renderSystem.onDraw(mCommandList.Get());
+	ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), mCommandList.Get());
+
+	rtResourceBarrier = CD3DX12_RESOURCE_BARRIER::Transition(backBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
+	mCommandList->ResourceBarrier(1, &rtResourceBarrier);
+
+	//done recording
+	mCommandList->Close();
+	ID3D12CommandList* cmdLists[] = { mCommandList.Get() };
+	mCmdQueue->ExecuteCommandLists(1, cmdLists);
+
+	ThrowIfFailed(mSwapChain->Present(1, 0));
+	mCurrBackBuffer = (mCurrBackBuffer + 1) % mSwapChainBufferCount;
+
+	flushCommandQueue();
+}
+
+void Core::renderImgui() {
+	// Start the Dear ImGui frame
+	ImGui_ImplDX12_NewFrame();
+	ImGui_ImplWin32_NewFrame();
+	ImGui::NewFrame();
+
+	ImGuiWindowFlags window_flags = ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoBackground;
+	ImGui::Begin("Interact", 0, window_flags);   
+	ImGui::SetWindowPos(ImVec2(0.f, mWndHeight - 230.f));
+	for(int k = 0; k < 6; k++)
+	for (int i = 0; i < 6; i++)
+	{
+		if (i > 0)
+			ImGui::SameLine();
+		ImGui::PushID(k * i);
+		ImGui::PushStyleColor(ImGuiCol_Button, (ImVec4)ImColor::HSV(i / 7.0f, 0.6f, 0.6f));
+		ImGui::PushStyleColor(ImGuiCol_ButtonHovered, (ImVec4)ImColor::HSV(i / 7.0f, 0.7f, 0.7f));
+		ImGui::PushStyleColor(ImGuiCol_ButtonActive, (ImVec4)ImColor::HSV(i / 7.0f, 0.8f, 0.8f));
+		auto move = gameplaySystem.cubeMoves[6 * k + i];
+		if (ImGui::Button(getMoveInfo(move).notation, ImVec2(40, 25))) {
+			gameplaySystem.queueMove(move);
+		}
+			
+		ImGui::PopStyleColor(3);
+		ImGui::PopID();
+	}
+	ImGui::NewLine();
+	ImGui::InputText("Input", szcmds, 256);
+	ImGui::SameLine();
+	if (ImGui::Button("Enter")) {
+		gameplaySystem.processInputCmd(szcmds);
+	}
+	ImGui::End();
+
+
+	ImGui::Begin("reset", 0, window_flags);
+	ImGui::SetWindowPos(ImVec2(mWndWidth / 2.f - 85.f, mWndHeight - 39.f));
+	if (ImGui::Button("Reset")) {
+		gameplaySystem.onReset();
+		renderSystem.onUpdateTransformations();
+	}
+	ImGui::SameLine();
+	ImGui::BeginDisabled(gameplaySystem.isShuffling() || gameplaySystem.isSolving());
+	if (ImGui::Button("Shuffle"))
+		gameplaySystem.onShuffle(scrambler);
+	ImGui::EndDisabled();
+	ImGui::SameLine();
+	ImGui::BeginDisabled(!solver.isReady() || mCubeSize != 3 || gameplaySystem.isSolving() || gameplaySystem.isShuffling());
+	if (ImGui::Button("Solve"))
+		gameplaySystem.onSolve(solver);
+	ImGui::EndDisabled();
+	ImGui::NewLine();
+	ImGui::End();
+
+	ImGui::Begin("Interface", 0, window_flags);
+	ImGui::Text("Left   Mouse to Rotate Camera");
+	ImGui::Text("Middle Mouse to Free Rotate");
+	ImGui::Text("Right  Mouse to Zoom Camera");
+	ImGui::End();
+
+	ImGui::Begin("about", 0, window_flags);
+	ImGui::Text("//chirag");
+	ImGui::SetWindowPos(ImVec2(mWndWidth - 70.f, mWndHeight - 34.f));
+	ImGui::End();
+
+
+	// Rendering
+	ImGui::Render();
+}
+
+void Core::onResize() {
+	// if the window is resized, create new swap chain and buffers to updated window dimensions
+
+	flushCommandQueue();
+	ThrowIfFailed(mCmdAlloc->Reset());
+	ThrowIfFailed(mCommandList->Reset(mCmdAlloc.Get(), nullptr));
+
+
+	for (UINT i = 0; i < mSwapChainBufferCount; i++)
+		mSwapChainBuffer[i].Reset();
+
+	mDepthStencilBuffer.Reset();
+
+	// Resize the swap chain buffers. Call this to avoid errors
+	ThrowIfFailed(mSwapChain->ResizeBuffers(mSwapChainBufferCount, mWndWidth, mWndHeight, mBackBufferFormat, DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH));
+
+	// recreate both swapchain and the rtv dsv with new sizes
+	createSwapChain();
+	createRTandDSViews();
+
+	// execute commands for buffer operations
+	mCommandList->Close();
+	ID3D12CommandList* cmdLists[] = { mCommandList.Get() };
+	mCmdQueue->ExecuteCommandLists(1, cmdLists);
+	flushCommandQueue();
+
+
+	mViewport.TopLeftX = 0.0f;
+	mViewport.TopLeftY = 0.0f;
+	mViewport.Width = static_cast<float>(mWndWidth);
+	mViewport.Height = static_cast<float>(mWndHeight);
+	mViewport.MinDepth = 0.0f;
+	mViewport.MaxDepth = 1.0f;
+
+	mScissorRect = { 0, 0, mWndWidth, mWndHeight };
+}
+
+void Core::destroy() {
+
+}
+
+void Core::flushCommandQueue() {
+	mCurrentFence++;
+	ThrowIfFailed(mCmdQueue->Signal(mFence.Get(), mCurrentFence));
+
+	if (mFence->GetCompletedValue() < mCurrentFence) {
+
+		HANDLE eventHandle = CreateEventEx(nullptr, 0, 0, EVENT_ALL_ACCESS);
+		ThrowIfFailed(mFence->SetEventOnCompletion(mCurrentFence, eventHandle));
+		
+		WaitForSingleObject(eventHandle, INFINITE);
+		CloseHandle(eventHandle);
+	}
+}
+
+
+void Core::initImgui(float mainScale) {
+	// Setup Dear ImGui style
+	ImGui::StyleColorsDark();
+	//ImGui::StyleColorsLight();
+
+	// Setup scaling
+	ImGuiStyle& style = ImGui::GetStyle();
+	style.ScaleAllSizes(mainScale);        // Bake a fixed style scale. (until we have a solution for dynamic style scaling, changing this requires resetting Style + calling this again)
+	style.FontScaleDpi = mainScale;        // Set initial font scale. (using io.ConfigDpiScaleFonts=true makes this unnecessary. We leave both here for documentation purpose)
+
+	// Setup Platform/Renderer backends
+	ImGui_ImplWin32_Init(hwnd);
+
+	imguiHeapAlloc.Create(mDevice.Get(), renderSystem.getCBVHeap());
+
+	ImGui_ImplDX12_InitInfo init_info = {};
+	init_info.Device = mDevice.Get();
+	init_info.CommandQueue = mCmdQueue.Get();
+	init_info.NumFramesInFlight = 1;
+	init_info.RTVFormat = mBackBufferFormat;
+	init_info.DSVFormat = mDepthStencilFormat;
+	// Allocating SRV descriptors (for textures) is up to the application, so we provide callbacks.
+	// (current version of the backend will only allocate one descriptor, future versions will need to allocate more)
+	init_info.SrvDescriptorHeap = renderSystem.getCBVHeap();
+	init_info.SrvDescriptorAllocFn = [](ImGui_ImplDX12_InitInfo*, D3D12_CPU_DESCRIPTOR_HANDLE* out_cpu_handle, D3D12_GPU_DESCRIPTOR_HANDLE* out_gpu_handle) { return imguiHeapAlloc.Alloc(out_cpu_handle, out_gpu_handle); };
+	init_info.SrvDescriptorFreeFn = [](ImGui_ImplDX12_InitInfo*, D3D12_CPU_DESCRIPTOR_HANDLE cpu_handle, D3D12_GPU_DESCRIPTOR_HANDLE gpu_handle) { return imguiHeapAlloc.Free(cpu_handle, gpu_handle); };
+	ImGui_ImplDX12_Init(&init_info);
+}
+
+void Core::loadAssets() { 
+	// order matters
+	levelLoader->loadLevel(registry, mCubeSize);									// load and assemble
+	hierarchySystem.onInit(registry);												// create model matrices and get forward vector
+	renderSystem.onInit(mDevice.Get(),
+		mCommandList.Get(), registry, 
+		static_cast<float>(mWndWidth) / static_cast<float>(mWndHeight), 
+		levelLoader->vertBuffData, levelLoader->indexBuffData, levelLoader->meshes);
+	gameplaySystem.onInit(registry, &hierarchySystem, &commandBuffers, mWndWidth, mWndHeight, mCubeSize);												// color the faces when after getting forward vectors
+
+
+	// update at least once after load
+	renderSystem.onUpdateTransformations();
+	renderSystem.onUpdateView(mRadius, mTheta, mPhi);
+
+	registerSystems();
+
+	// the solver tables take a few seconds the first time, build them off the window thread
+	solverInit = std::async(std::launch::async, [this] { solver.init("TwoPhaseTables.bin"); });
+}
+
+void Core::registerSystems() {
+	// gameplay moves local transforms, the hierarchy turns them into model matrices and the render system uploads them.
+	// they share CTransform so the scheduler keeps them in this order; systems added later with disjoint component
+	// sets run alongside them on the worker pool
+	scheduler.addSystem("Gameplay",
+		registry->getSignature<CTransform, CHierarchy>(),
+		registry->getSignature<CTransform, CHierarchy, CDraw>(),
+		[this](float deltaTime) { gameplaySystem.onUpdate(deltaTime); });
+
+	scheduler.addSystem("Hierarchy",
+		registry->getSignature<CTransform, CHierarchy>(),
+		registry->getSignature<CTransform>(),
+		[this](float) { hierarchySystem.onUpdate(); });
+
+	scheduler.addSystem("Transformations",
+		registry->getSignature<CTransform, CDraw>(),
+		Signature(),
+		[this](float) { renderSystem.onUpdateTransformations(); });
+}
+
+
+void Core::loadPipeline() {
+	// Compile shaders
+#if defined(_DEBUG)
+// Enable better shader debugging with the graphics debugging tools.
+	UINT compileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+#else
+	UINT compileFlags = 0;
+#endif
+
+	D3D12_INPUT_ELEMENT_DESC vertexElementDesc[] = {
+	{"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	{"COLOR", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0}
+	};
+
+	ComPtr<ID3DBlob> vertexShader;
+	ComPtr<ID3DBlob> pixelShader;
+	HRESULT hr = D3DCompileFromFile(L"./shaders/color.hlsl", nullptr, nullptr, "VSMain", "vs_5_0", compileFlags, 0, &vertexShader, nullptr);
+	if (FAILED(hr))
+		MessageBox(0, L"Error: Shader Compile From File", 0, 0);
+
+	hr = D3DCompileFromFile(L"./shaders/color.hlsl", nullptr, nullptr, "PSMain", "ps_5_0", compileFlags, 0, &pixelShader, nullptr);
+	if (FAILED(hr))
+		MessageBox(0, L"Error: Shader Compile From File", 0, 0);
+
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc;
+	ZeroMemory(&psoDesc, sizeof(D3D12_GRAPHICS_PIPELINE_STATE_DESC));
+	psoDesc.InputLayout = { vertexElementDesc, _countof(vertexElementDesc) };
+	psoDesc.pRootSignature = renderSystem.getRootSignature();
+	psoDesc.VS = CD3DX12_SHADER_BYTECODE(vertexShader.Get());
+	psoDesc.PS = CD3DX12_SHADER_BYTECODE(pixelShader.Get());
+	psoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+	psoDesc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
+	psoDesc.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
+	psoDesc.SampleMask = UINT_MAX;
+	psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+	psoDesc.NumRenderTargets = 1;
+	psoDesc.RTVFormats[0] = mBackBufferFormat;
+	psoDesc.SampleDesc.Count = mUseMSAA ? 4 : 1;
+	psoDesc.SampleDesc.Quality = mUseMSAA ? (mMSAAQualityLevel - 1) : 0;
+	psoDesc.DSVFormat = mDepthStencilFormat;
+
+	ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineState)));
+}
+
+
+void Core::initD3D12Device() {
+	UINT dxgiFactoryFlags = 0;
+
+#if defined(DEBUG) || defined(_DEBUG) 
+	ComPtr<ID3D12Debug>	debugController;
+	if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&debugController)))) {
+		debugController->EnableDebugLayer();
+		// Enable additional debug layers.
+		dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
+	}
+#endif
+
+	
+	ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mFactory)));
+
+	//device
+	auto result = D3D12CreateDevice(nullptr, D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(&mDevice));
+	// fallback to WARP if no device found
+	if (FAILED(result)) {
+		ComPtr<IDXGIAdapter> warpAdapter;
+		ThrowIfFailed(mFactory->EnumWarpAdapter(IID_PPV_ARGS(&warpAdapter)));
+
+		//create device again with the WARP adapter this time
+		ThrowIfFailed(D3D12CreateDevice(warpAdapter.Get(), D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(&mDevice)));
+	}
+
+
+	// fence
+	ThrowIfFailed(mDevice->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+
+	// query descriptor increment sizes
+	mRtvDescriptorSize = mDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
+	mDsvDescriptorSize = mDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
+	
+
+	// MSAA support level 4X
+	D3D12_FEATURE_DATA_MULTISAMPLE_QUALITY_LEVELS msQualityLevels;
+	msQualityLevels.Format = mBackBufferFormat;
+	msQualityLevels.NumQualityLevels = 0;
+	msQualityLevels.SampleCount = 4;
+	msQualityLevels.Flags = D3D12_MULTISAMPLE_QUALITY_LEVELS_FLAG_NONE;
+	ThrowIfFailed(
+		mDevice->CheckFeatureSupport(D3D12_FEATURE_MULTISAMPLE_QUALITY_LEVELS, &msQualityLevels, sizeof(msQualityLevels))
+	);
+	mMSAAQualityLevel = msQualityLevels.NumQualityLevels;
+
+
+	// Command Objects
+	D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+	queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+	queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+	ThrowIfFailed(
+		mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCmdQueue))
+	);
+	ThrowIfFailed(
+		mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(mCmdAlloc.GetAddressOf()))
+	);
+	ThrowIfFailed(
+		mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, mCmdAlloc.Get(), nullptr, IID_PPV_ARGS(mCommandList.GetAddressOf()))
+	);
+	// Close at first so reset can be called on it before we use it
+	mCommandList->Close();
+
+
+	// create Descriptor Heaps
+	D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc;
+	rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+	rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;							//rtv is not shader visible
+	rtvHeapDesc.NumDescriptors = mSwapChainBufferCount;
+	rtvHeapDesc.NodeMask = 0;
+	ThrowIfFailed(
+		mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(mRtvHeap.GetAddressOf()))
+	);
+	D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc;
+	dsvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
+	dsvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;							//rtv is not shader visible
+	dsvHeapDesc.NumDescriptors = 1;
+	dsvHeapDesc.NodeMask = 0;
+	ThrowIfFailed(
+		mDevice->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(mDsvHeap.GetAddressOf()))
+	);
+}
+
+
+void Core::createSwapChain() {
+	// release prev swapchain
+	mSwapChain.Reset();
+	// reset back currentbackbuffer index since a new swapchain will be made
+	mCurrBackBuffer = 0;
+
+	DXGI_SWAP_CHAIN_DESC swapchainDesc = {0};
+	swapchainDesc.BufferDesc.Width = mWndWidth;
+	swapchainDesc.BufferDesc.Height = mWndHeight;
+	swapchainDesc.BufferDesc.RefreshRate.Numerator = 60;
+	swapchainDesc.BufferDesc.RefreshRate.Denominator = 1;
+	swapchainDesc.BufferDesc.Format = mBackBufferFormat;
+	swapchainDesc.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
+	swapchainDesc.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
+	swapchainDesc.SampleDesc.Count = mUseMSAA ? 4 : 1;
+	swapchainDesc.SampleDesc.Quality = mUseMSAA ? (mMSAAQualityLevel - 1) : 0;
+	swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+	swapchainDesc.BufferCount = mSwapChainBufferCount;
+	swapchainDesc.OutputWindow = hwnd;
+	swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+	
+	//windowed
+	swapchainDesc.Windowed = true;
+	swapchainDesc.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH;
+
+	ThrowIfFailed(
+		mFactory->CreateSwapChain(mCmdQueue.Get(), &swapchainDesc, mSwapChain.GetAddressOf())
+	);
+
+}
+
+void Core::createRTandDSViews() {	
+	CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHeapHandle(mRtvHeap->GetCPUDescriptorHandleForHeapStart());
+	for (UINT i = 0; i < mSwapChainBufferCount; i++) {
+		ThrowIfFailed(
+			mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mSwapChainBuffer[i]))
+		);
+
+		mDevice->CreateRenderTargetView(mSwapChainBuffer[i].Get(), nullptr, rtvHeapHandle);
+
+		rtvHeapHandle.Offset(1, mRtvDescriptorSize);
+	}
+
+	//create Depth Stencil View
+	D3D12_RESOURCE_DESC depthStencilDesc;
+	depthStencilDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+	depthStencilDesc.Format = mDepthStencilFormat;
+	depthStencilDesc.Alignment = 0;
+	depthStencilDesc.Width = mWndWidth;
+	depthStencilDesc.Height = mWndHeight;
+	depthStencilDesc.DepthOrArraySize = 1;
+	depthStencilDesc.MipLevels = 1;
+	depthStencilDesc.SampleDesc.Count = mUseMSAA ? 4 : 1;
+	depthStencilDesc.SampleDesc.Quality = mUseMSAA ? (mMSAAQualityLevel - 1) : 0;
+	depthStencilDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+	depthStencilDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+
+	//clear value
+	D3D12_CLEAR_VALUE optClear;
+	optClear.Format = mDepthStencilFormat;
+	optClear.DepthStencil.Depth = 1.0f;
+	optClear.DepthStencil.Stencil = 0;
+
+	CD3DX12_HEAP_PROPERTIES heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+	ThrowIfFailed(
+		mDevice->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &depthStencilDesc, D3D12_RESOURCE_STATE_COMMON, &optClear, IID_PPV_ARGS(mDepthStencilBuffer.GetAddressOf()))
+	);
+	mDevice->CreateDepthStencilView(mDepthStencilBuffer.Get(), nullptr, getDepthStencilView());
+
+	CD3DX12_RESOURCE_BARRIER resbDepthWrite = CD3DX12_RESOURCE_BARRIER::Transition(mDepthStencilBuffer.Get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+	mCommandList->ResourceBarrier(1, &resbDepthWrite);
+}
+
+
+
+D3D12_CPU_DESCRIPTOR_HANDLE Core::getCurrentBackBufferView() {
+	return CD3DX12_CPU_DESCRIPTOR_HANDLE(mRtvHeap->GetCPUDescriptorHandleForHeapStart(), mCurrBackBuffer, mRtvDescriptorSize);
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE Core::getDepthStencilView() {
+	return mDsvHeap->GetCPUDescriptorHandleForHeapStart();
+}
+
+ComPtr<ID3D12Resource> Core::getCurrentBackBuffer() const {
+	return mSwapChainBuffer[mCurrBackBuffer].Get();
+}
+
+
+
+int Core::getWndWidth() const {
+	return mWndWidth;
+}
+int Core::getWndHeight() const {
+	return mWndHeight;
 }
\ No newline at end of file
@@ -0,0 +1,244 @@
+#include "CubeModel.h"
+#include "MoveKernels.h"
+
+namespace {
+	// outward normal of each face, same order as CubeFace
+	const int faceNormals[FaceTotal][3] = {
+		{ 0, 0, 1 },
+		{ -1, 0, 0 },
+		{ 0, 1, 0 },
+		{ 1, 0, 0 },
+		{ 0, 0, -1 },
+		{ 0, -1, 0 }
+	};
+
+	// piece position and normal of every facelet
+	struct FaceletGeometry {
+		int position[3];
+		int normal[3];
+	};
+
+	struct Geometry {
+		FaceletGeometry facelets[NumFacelets];
+
+		Geometry() {
+			// 9 stickers per face, row major over the two axes the face does not point along
+			for (int f = 0; f < FaceTotal; f++) {
+				int axis = faceNormals[f][0] ? 0 : faceNormals[f][1] ? 1 : 2;
+				int u = (axis + 1) % 3, v = (axis + 2) % 3;
+				for (int i = 0; i < 9; i++) {
+					auto& facelet = facelets[f * 9 + i];
+					for (int k = 0; k < 3; k++)
+						facelet.normal[k] = faceNormals[f][k];
+					facelet.position[axis] = faceNormals[f][axis];
+					facelet.position[u] = i / 3 - 1;
+					facelet.position[v] = i % 3 - 1;
+				}
+			}
+		}
+	};
+
+	const Geometry& getGeometry() {
+		static Geometry geometry;
+		return geometry;
+	}
+
+	// +90 degrees around axis with the DirectXMath row vector convention, applied to positions and normals alike
+	void rotateQuarter(int axis, const int in[3], int out[3]) {
+		if (axis == 0) {
+			out[0] = in[0]; out[1] = -in[2]; out[2] = in[1];
+		}
+		else if (axis == 1) {
+			out[0] = in[2]; out[1] = in[1]; out[2] = -in[0];
+		}
+		else {
+			out[0] = -in[1]; out[1] = in[0]; out[2] = in[2];
+		}
+	}
+
+	// one table per axis, layer mask (1..7) and quarter turn count (1..3), built once on first use. each with the byte
+	// shuffle that applies it
+	struct PermutationTables {
+		Facelets tables[3][8][4];
+		FaceletShuffle shuffles[3][8][4];
+
+		PermutationTables() {
+			auto& geometry = getGeometry();
+			for (int axis = 0; axis < 3; axis++) {
+				for (int layers = 0; layers < 8; layers++) {
+					// a single quarter turn, scattered into its gather form
+					Facelets quarter;
+					for (int i = 0; i < NumFacelets; i++)
+						quarter[i] = static_cast<uint8_t>(i);
+					for (int i = 0; i < NumFacelets; i++) {
+						auto& facelet = geometry.facelets[i];
+						if (!(layers & (1 << (facelet.position[axis] + 1))))
+							continue;
+
+						int position[3], normal[3];
+						rotateQuarter(axis, facelet.position, position);
+						rotateQuarter(axis, facelet.normal, normal);
+						quarter[CubeModel::faceletAt(position, normal)] = static_cast<uint8_t>(i);
+					}
+
+					for (int i = 0; i < NumFacelets; i++)
+						tables[axis][layers][0][i] = static_cast<uint8_t>(i);
+					for (int q = 1; q < 4; q++) {
+						for (int i = 0; i < NumFacelets; i++)
+							tables[axis][layers][q][i] = tables[axis][layers][q - 1][quarter[i]];
+					}
+					for (int q = 0; q < 4; q++)
+						makeFaceletShuffle(tables[axis][layers][q], shuffles[axis][layers][q]);
+				}
+			}
+		}
+	};
+
+	const PermutationTables& getPermutationTables() {
+		static PermutationTables permutationTables;
+		return permutationTables;
+	}
+
+	// clockwise turn of every base move in Move order. the right face is at -x, so R turns the layers at x = -0.5
+	// by -90 degrees
+	struct BaseMove {
+		char letter;
+		CubeTurn turn;
+	};
+
+	const BaseMove baseMoves[MoveCount / 3] = {
+		{ 'R', { 0, 0b001, 3 } },
+		{ 'L', { 0, 0b100, 1 } },
+		{ 'U', { 1, 0b100, 1 } },
+		{ 'F', { 2, 0b100, 1 } },
+		{ 'D', { 1, 0b001, 3 } },
+		{ 'B', { 2, 0b001, 3 } },
+		{ 'M', { 0, 0b010, 1 } },
+		{ 'E', { 1, 0b010, 3 } },
+		{ 'S', { 2, 0b010, 1 } },
+		{ 'r', { 0, 0b011, 3 } },
+		{ 'l', { 0, 0b110, 1 } },
+		{ 'u', { 1, 0b110, 1 } },
+		{ 'f', { 2, 0b110, 1 } },
+		{ 'd', { 1, 0b011, 3 } },
+		{ 'b', { 2, 0b011, 3 } },
+		{ 'X', { 0, 0b111, 3 } },
+		{ 'Y', { 1, 0b111, 1 } },
+		{ 'Z', { 2, 0b111, 1 } }
+	};
+
+	struct MoveTable {
+		MoveInfo moves[MoveCount];
+		const FaceletShuffle* shuffles[MoveCount];
+
+		MoveTable() {
+			const char suffixes[] = { '\0', 'i', '2' };
+			const float quarter = 1.57079633f;
+			for (int m = 0; m < MoveCount; m++) {
+				auto& base = baseMoves[m / 3];
+				auto& info = moves[m];
+				int variant = m % 3;
+
+				info.notation[0] = base.letter;
+				info.notation[1] = suffixes[variant];
+				info.notation[2] = '\0';
+				info.notation[3] = '\0';
+
+				info.turn = base.turn;
+				if (variant == 1)
+					info.turn.quarterTurns = 4 - base.turn.quarterTurns;
+				else if (variant == 2)
+					info.turn.quarterTurns = 2;
+
+				// a double turn animates the same way round as the clockwise turn
+				float direction = base.turn.quarterTurns == 1 ? 1.f : -1.f;
+				info.angle = variant == 0 ? direction * quarter : variant == 1 ? -direction * quarter : direction * 2.f * quarter;
+				info.permutation = &CubeModel::getPermutation(info.turn);
+				shuffles[m] = &getPermutationTables().shuffles[info.turn.axis][info.turn.layers][info.turn.quarterTurns];
+			}
+		}
+	};
+
+	const MoveTable& getMoveTable() {
+		static MoveTable moveTable;
+		return moveTable;
+	}
+}
+
+
+const MoveInfo& getMoveInfo(Move move) {
+	return getMoveTable().moves[move];
+}
+
+Move getInverseMove(Move move) {
+	int variant = move % 3;
+	return static_cast<Move>(move - variant + (variant == 0 ? 1 : variant == 1 ? 0 : 2));
+}
+
+CubeModel::CubeModel() {
+	reset();
+}
+
+void CubeModel::reset() {
+	for (int i = 0; i < NumFacelets; i++)
+		facelets[i] = static_cast<uint8_t>(i / 9);
+}
+
+void CubeModel::apply(const CubeTurn& turn) {
+	auto& tables = getPermutationTables();
+	permuteFacelets(facelets, tables.tables[turn.axis][turn.layers & 7][turn.quarterTurns & 3],
+		tables.shuffles[turn.axis][turn.layers & 7][turn.quarterTurns & 3]);
+}
+
+void CubeModel::apply(Move move) {
+	auto& moveTable = getMoveTable();
+	permuteFacelets(facelets, *moveTable.moves[move].permutation, *moveTable.shuffles[move]);
+}
+
+bool CubeModel::isSolved() const {
+	for (int f = 0; f < FaceTotal; f++) {
+		for (int i = 1; i < 9; i++) {
+			if (facelets[f * 9 + i] != facelets[f * 9])
+				return false;
+		}
+	}
+	return true;
+}
+
+uint8_t CubeModel::getFacelet(uint8_t facelet) const {
+	return facelets[facelet];
+}
+
+const Facelets& CubeModel::getFacelets() const {
+	return facelets;
+}
+
+void CubeModel::setFacelets(const Facelets& facelets) {
+	this->facelets = facelets;
+}
+
+bool CubeModel::operator==(const CubeModel& other) const {
+	return facelets == other.facelets;
+}
+
+uint8_t CubeModel::faceletAt(const int position[3], const int normal[3]) {
+	for (int f = 0; f < FaceTotal; f++) {
+		if (normal[0] != faceNormals[f][0] || normal[1] != faceNormals[f][1] || normal[2] != faceNormals[f][2])
+			continue;
+
+		int axis = normal[0] ? 0 : normal[1] ? 1 : 2;
+		int u = (axis + 1) % 3, v = (axis + 2) % 3;
+		if (position[axis] != normal[axis])
+			return InvalidFacelet;
+		return static_cast<uint8_t>(f * 9 + (position[u] + 1) * 3 + position[v] + 1);
+	}
+	return InvalidFacelet;
+}
+
+const int* CubeModel::getFaceNormal(uint8_t face) {
+	return faceNormals[face];
+}
+
+const Facelets& CubeModel::getPermutation(const CubeTurn& turn) {
+	return getPermutationTables().tables[turn.axis][turn.layers & 7][turn.quarterTurns & 3];
+}
@@ -0,0 +1,102 @@
+// integer cube state
+#pragma once
+#include <array>
+#include <cstdint>
+
+// faces in the same order as the face colors of the shader, a solved facelet holds the index of its face
+enum CubeFace : uint8_t {
+	FaceFront,																	// +z
+	FaceRight,																	// -x
+	FaceTop,																	// +y
+	FaceLeft,																	// +x
+	FaceBack,																	// -z
+	FaceBottom,																	// -y
+	FaceTotal
+};
+
+constexpr uint8_t NumFacelets = 54;
+constexpr uint8_t InvalidFacelet = 0xff;
+
+// turn of one or more layers along an axis. layers is a bitmask over the layers at -0.5 (bit 0), the middle (bit 1) and
+// +0.5 (bit 2). quarterTurns counts +90 degree rotations around the axis, the same direction XMMatrixRotationX/Y/Z takes
+// for a positive angle, so 3 is -90 degrees
+struct CubeTurn {
+	uint8_t axis;																// 0 x, 1 y, 2 z
+	uint8_t layers;
+	uint8_t quarterTurns;
+};
+
+typedef std::array<uint8_t, NumFacelets> Facelets;
+
+// every move the gameplay knows, as a byte. each base turn comes as clockwise, inverse (legacy "i" suffix) and double,
+// in that order, so the variant of a move is move % 3
+enum Move : uint8_t {
+	// face
+	MoveR, MoveRi, MoveR2,
+	MoveL, MoveLi, MoveL2,
+	MoveU, MoveUi, MoveU2,
+	MoveF, MoveFi, MoveF2,
+	MoveD, MoveDi, MoveD2,
+	MoveB, MoveBi, MoveB2,
+	// slice
+	MoveM, MoveMi, MoveM2,
+	MoveE, MoveEi, MoveE2,
+	MoveS, MoveSi, MoveS2,
+	// double layer, written lowercase (r is Rw)
+	MoveRw, MoveRwi, MoveRw2,
+	MoveLw, MoveLwi, MoveLw2,
+	MoveUw, MoveUwi, MoveUw2,
+	MoveFw, MoveFwi, MoveFw2,
+	MoveDw, MoveDwi, MoveDw2,
+	MoveBw, MoveBwi, MoveBw2,
+	// whole cube
+	MoveX, MoveXi, MoveX2,
+	MoveY, MoveYi, MoveY2,
+	MoveZ, MoveZi, MoveZ2,
+	MoveCount
+};
+
+// everything needed to animate and apply a move, precomputed once
+struct MoveInfo {
+	char notation[4];
+	CubeTurn turn;
+	float angle;																// pivot rotation around turn.axis in radians
+	const Facelets* permutation;
+};
+
+const MoveInfo& getMoveInfo(Move move);
+Move getInverseMove(Move move);
+
+// facelet (sticker) model of the 3x3 cube and the source of truth for its state. facelets are numbered face by face in
+// CubeFace order, 9 per face. every turn is a precomputed permutation applied with byte shuffles (see MoveKernels.h)
+// and nothing here depends on floats or the renderer
+class CubeModel {
+public:
+	CubeModel();
+
+	void reset();
+	void apply(const CubeTurn& turn);
+	void apply(Move move);
+
+	// every face shows a single color, whatever way the whole cube is held
+	bool isSolved() const;
+
+	uint8_t getFacelet(uint8_t facelet) const;
+	const Facelets& getFacelets() const;
+	void setFacelets(const Facelets& facelets);
+
+	bool operator==(const CubeModel& other) const;
+
+	// facelet of the sticker on the piece at position (each coordinate -1, 0 or 1) facing along normal (a unit axis),
+	// InvalidFacelet if there is no such sticker
+	static uint8_t faceletAt(const int position[3], const int normal[3]);
+
+	// outward unit normal of a face
+	static const int* getFaceNormal(uint8_t face);
+
+	// gather permutation of a turn: after the turn facelet i holds what was at permutation[i]
+	static const Facelets& getPermutation(const CubeTurn& turn);
+
+private:
+	Facelets facelets;
+};
@@ -0,0 +1,208 @@
+#include "CubeModelNxN.h"
+
+#include <algorithm>
+
+namespace {
+	// +90 degrees around axis, the same rotation as the 3x3 model uses
+	void rotateQuarter(int axis, const int in[3], int out[3]) {
+		if (axis == 0) {
+			out[0] = in[0]; out[1] = -in[2]; out[2] = in[1];
+		}
+		else if (axis == 1) {
+			out[0] = in[2]; out[1] = in[1]; out[2] = -in[0];
+		}
+		else {
+			out[0] = -in[1]; out[1] = in[0]; out[2] = in[2];
+		}
+	}
+
+	int normalAxis(const int normal[3]) {
+		return normal[0] ? 0 : normal[1] ? 1 : 2;
+	}
+}
+
+
+CubeModelNxN::CubeModelNxN(uint16_t size) : size(0) {
+	setSize(size);
+}
+
+void CubeModelNxN::setSize(uint16_t size) {
+	size = std::min(std::max(size, MinCubeSize), MaxCubeSize);
+	if (size == this->size) {
+		reset();
+		return;
+	}
+	this->size = size;
+	facelets.resize(getNumFacelets());
+
+	// positions are doubled and centered (2 * layer - (size - 1)) so a quarter turn maps them onto each other without
+	// fractions whether the size is odd or even
+	int n = size;
+	uint32_t numFacelets = getNumFacelets();
+	for (int axis = 0; axis < 3; axis++) {
+		// where each sticker goes in a quarter turn of the layer it lies in
+		std::vector<uint16_t> target(numFacelets);
+		std::vector<uint16_t> layerOf(numFacelets);
+		for (uint32_t i = 0; i < numFacelets; i++) {
+			auto normal = CubeModel::getFaceNormal(static_cast<uint8_t>(i / (n * n)));
+			int faceAxis = normalAxis(normal);
+			int u = (faceAxis + 1) % 3, v = (faceAxis + 2) % 3;
+			int position[3];
+			position[faceAxis] = normal[faceAxis] > 0 ? n - 1 : 0;
+			position[u] = (i % (n * n)) / n;
+			position[v] = i % n;
+
+			int doubled[3], turned[3], turnedNormal[3];
+			for (int k = 0; k < 3; k++)
+				doubled[k] = 2 * position[k] - (n - 1);
+			rotateQuarter(axis, doubled, turned);
+			rotateQuarter(axis, normal, turnedNormal);
+			for (int k = 0; k < 3; k++)
+				turned[k] = (turned[k] + n - 1) / 2;
+
+			target[i] = faceletAt(turned, turnedNormal);
+			layerOf[i] = static_cast<uint16_t>(position[axis]);
+		}
+
+		// every sticker off the axis lies on a cycle of 4, the centers of odd faces stay put
+		std::vector<std::vector<uint16_t>> layerCycles(n);
+		std::vector<bool> done(numFacelets);
+		for (uint32_t i = 0; i < numFacelets; i++) {
+			if (done[i] || target[i] == i)
+				continue;
+			auto& layer = layerCycles[layerOf[i]];
+			for (uint32_t k = i; !done[k]; k = target[k]) {
+				done[k] = true;
+				layer.push_back(static_cast<uint16_t>(k));
+			}
+		}
+
+		cycles[axis].clear();
+		cycleStart[axis].assign(1, 0);
+		for (auto& layer : layerCycles) {
+			cycles[axis].insert(cycles[axis].end(), layer.begin(), layer.end());
+			cycleStart[axis].push_back(static_cast<uint32_t>(cycles[axis].size()));
+		}
+	}
+
+	reset();
+}
+
+uint16_t CubeModelNxN::getSize() const {
+	return size;
+}
+
+uint32_t CubeModelNxN::getNumFacelets() const {
+	return FaceTotal * size * size;
+}
+
+void CubeModelNxN::reset() {
+	uint32_t perFace = size * size;
+	for (uint32_t i = 0; i < facelets.size(); i++)
+		facelets[i] = static_cast<uint8_t>(i / perFace);
+}
+
+void CubeModelNxN::apply(const LayerTurn& turn) {
+	uint16_t last = std::min<uint16_t>(turn.last, size - 1);
+	if (turn.first > last || (turn.quarterTurns & 3) == 0)
+		return;
+
+	auto* cycle = cycles[turn.axis].data() + cycleStart[turn.axis][turn.first];
+	auto* end = cycles[turn.axis].data() + cycleStart[turn.axis][last + 1];
+	uint8_t* f = facelets.data();
+	switch (turn.quarterTurns & 3) {
+	case 1:
+		for (; cycle < end; cycle += 4) {
+			uint8_t t = f[cycle[3]];
+			f[cycle[3]] = f[cycle[2]];
+			f[cycle[2]] = f[cycle[1]];
+			f[cycle[1]] = f[cycle[0]];
+			f[cycle[0]] = t;
+		}
+		break;
+	case 2:
+		for (; cycle < end; cycle += 4) {
+			std::swap(f[cycle[0]], f[cycle[2]]);
+			std::swap(f[cycle[1]], f[cycle[3]]);
+		}
+		break;
+	case 3:
+		for (; cycle < end; cycle += 4) {
+			uint8_t t = f[cycle[0]];
+			f[cycle[0]] = f[cycle[1]];
+			f[cycle[1]] = f[cycle[2]];
+			f[cycle[2]] = f[cycle[3]];
+			f[cycle[3]] = t;
+		}
+		break;
+	}
+}
+
+void CubeModelNxN::apply(const LayerMove& move) {
+	apply(getTurn(move));
+}
+
+bool CubeModelNxN::isSolved() const {
+	uint32_t perFace = size * size;
+	for (uint32_t f = 0; f < FaceTotal; f++) {
+		for (uint32_t i = 1; i < perFace; i++) {
+			if (facelets[f * perFace + i] != facelets[f * perFace])
+				return false;
+		}
+	}
+	return true;
+}
+
+uint8_t CubeModelNxN::getFacelet(uint32_t facelet) const {
+	return facelets[facelet];
+}
+
+const std::vector<uint8_t>& CubeModelNxN::getFacelets() const {
+	return facelets;
+}
+
+LayerTurn CubeModelNxN::getTurn(const LayerMove& move) const {
+	auto& turn = getMoveInfo(move.base).turn;
+	LayerTurn layerTurn = { turn.axis, 0, static_cast<uint16_t>(size - 1), turn.quarterTurns };
+	if (move.isFaceMove()) {
+		// depths past the middle are allowed, 4R on a 5x5 is the layer next to L
+		uint16_t first = std::max<uint16_t>(move.first, 1), last = std::min(move.last, size);
+		if (turn.layers == 0b001) {
+			layerTurn.first = first - 1;
+			layerTurn.last = last - 1;
+		}
+		else {
+			layerTurn.first = size - last;
+			layerTurn.last = size - first;
+		}
+	}
+	else if (move.base < MoveRw) {
+		layerTurn.first = 1;
+		layerTurn.last = size - 2;
+	}
+	return layerTurn;
+}
+
+bool CubeModelNxN::toCubeModel(CubeModel& cube) const {
+	if (size != 3)
+		return false;
+	Facelets state;
+	std::copy(facelets.begin(), facelets.end(), state.begin());
+	cube.setFacelets(state);
+	return true;
+}
+
+uint16_t CubeModelNxN::faceletAt(const int position[3], const int normal[3]) const {
+	for (int f = 0; f < FaceTotal; f++) {
+		auto faceNormal = CubeModel::getFaceNormal(static_cast<uint8_t>(f));
+		if (normal[0] != faceNormal[0] || normal[1] != faceNormal[1] || normal[2] != faceNormal[2])
+			continue;
+
+		int axis = normalAxis(normal);
+		int u = (axis + 1) % 3, v = (axis + 2) % 3;
+		if (position[axis] != (normal[axis] > 0 ? size - 1 : 0))
+			return InvalidFaceletNxN;
+		return static_cast<uint16_t>(f * size * size + position[u] * size + position[v]);
+	}
+	return InvalidFaceletNxN;
+}
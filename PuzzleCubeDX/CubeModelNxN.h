@@ -0,0 +1,85 @@
+// integer cube state of any size
+#pragma once
+#include "CubeModel.h"
+
+#include <vector>
+
+constexpr uint16_t MinCubeSize = 2;
+constexpr uint16_t MaxCubeSize = 100;											// 6 * 100^2 facelets still fit 16 bit indices
+constexpr uint16_t InvalidFaceletNxN = 0xffff;
+
+// turn of the layers first..last along an axis, layer 0 being the one on the negative side. quarterTurns as in
+// CubeTurn. an empty range (first > last, eg. a slice move on a 2x2) turns nothing
+struct LayerTurn {
+	uint8_t axis;
+	uint16_t first;
+	uint16_t last;
+	uint8_t quarterTurns;
+};
+
+// a move in big cube notation. base is the 3x3 move it is named after and gives the axis, direction and turn count.
+// face moves turn the layers first..last counted inwards from their face (1 = the face itself), so R is 1..1, Rw 1..2,
+// 3Rw 1..3 and 3R 3..3. wide 3x3 moves are stored as their face move with 1..2. slices turn every inner layer and
+// rotations the whole cube, both ignore first and last
+struct LayerMove {
+	LayerMove(Move base = MoveR, uint16_t first = 1, uint16_t last = 1) : base(base), first(first), last(last) {
+		if (base >= MoveRw && base < MoveX) {
+			this->base = static_cast<Move>(base - MoveRw);
+			this->first = 1;
+			this->last = 2;
+		}
+	}
+
+	Move base;
+	uint16_t first;
+	uint16_t last;
+
+	bool isFaceMove() const {
+		return base < MoveM;
+	}
+};
+
+inline LayerMove getInverseMove(const LayerMove& move) {
+	return LayerMove(getInverseMove(move.base), move.first, move.last);
+}
+
+// facelet model of an NxN cube, numbered like CubeModel: face by face in CubeFace order, size^2 per face, row major
+// over the two axes after the face's own (in xyz order). a 3x3 is numbered exactly like CubeModel. every layer turn
+// is a precomputed list of 4-cycles, so a turn only touches the facelets of the turning layers
+class CubeModelNxN {
+public:
+	CubeModelNxN(uint16_t size = 3);
+
+	void setSize(uint16_t size);
+	uint16_t getSize() const;
+	uint32_t getNumFacelets() const;
+
+	void reset();
+	void apply(const LayerTurn& turn);
+	void apply(const LayerMove& move);
+
+	// every face shows a single color
+	bool isSolved() const;
+
+	uint8_t getFacelet(uint32_t facelet) const;
+	const std::vector<uint8_t>& getFacelets() const;
+
+	// the layers a move turns on this size
+	LayerTurn getTurn(const LayerMove& move) const;
+
+	// copy of the state as a 3x3 model, false for other sizes
+	bool toCubeModel(CubeModel& cube) const;
+
+	// facelet of the sticker on the piece at layer position (each 0..size-1) facing along normal (a unit axis),
+	// InvalidFaceletNxN if there is no such sticker
+	uint16_t faceletAt(const int position[3], const int normal[3]) const;
+
+private:
+	uint16_t size;
+	std::vector<uint8_t> facelets;
+
+	// 4-cycles of a quarter turn of each layer, layer l of an axis in cycles[axis][cycleStart[axis][l]..[l + 1]).
+	// a cycle a b c d moves the sticker at a to b, b to c, c to d and d to a
+	std::vector<uint16_t> cycles[3];
+	std::vector<uint32_t> cycleStart[3];
+};
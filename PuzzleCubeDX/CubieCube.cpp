@@ -0,0 +1,266 @@
+#include "CubieCube.h"
+#include "Coordinates.h"
+#include "MoveKernels.h"
+
+#include <algorithm>
+
+namespace {
+	const uint8_t U = FaceTop, R = FaceRight, F = FaceFront, D = FaceBottom, L = FaceLeft, B = FaceBack;
+
+	// faces of each slot, the U/D face first (F/B for E slice edges) and the rest in the same turning sense for every
+	// corner, so twists add up mod 3
+	const uint8_t cornerFaces[CornerCount][3] = {
+		{ U, R, F }, { U, F, L }, { U, L, B }, { U, B, R },
+		{ D, F, R }, { D, L, F }, { D, B, L }, { D, R, B }
+	};
+
+	const uint8_t edgeFaces[EdgeCount][2] = {
+		{ U, R }, { U, F }, { U, L }, { U, B },
+		{ D, R }, { D, F }, { D, L }, { D, B },
+		{ F, R }, { F, L }, { B, L }, { B, R }
+	};
+
+	// facelet of the sticker of a slot on one of its faces
+	uint8_t slotFacelet(const uint8_t* faces, int count, uint8_t face) {
+		int position[3] = { 0, 0, 0 };
+		for (int i = 0; i < count; i++) {
+			auto normal = CubeModel::getFaceNormal(faces[i]);
+			for (int k = 0; k < 3; k++)
+				position[k] += normal[k];
+		}
+		return CubeModel::faceletAt(position, CubeModel::getFaceNormal(face));
+	}
+
+	struct SlotFacelets {
+		uint8_t corners[CornerCount][3];
+		uint8_t edges[EdgeCount][2];
+
+		SlotFacelets() {
+			for (int i = 0; i < CornerCount; i++) {
+				for (int k = 0; k < 3; k++)
+					corners[i][k] = slotFacelet(cornerFaces[i], 3, cornerFaces[i][k]);
+			}
+			for (int i = 0; i < EdgeCount; i++) {
+				for (int k = 0; k < 2; k++)
+					edges[i][k] = slotFacelet(edgeFaces[i], 2, edgeFaces[i][k]);
+			}
+		}
+	};
+
+	const SlotFacelets& getSlotFacelets() {
+		static SlotFacelets slotFacelets;
+		return slotFacelets;
+	}
+
+	struct MoveCubes {
+		CubieCube moves[18];
+
+		MoveCubes() {
+			for (int m = 0; m < 18; m++) {
+				CubeModel cube;
+				cube.apply(static_cast<Move>(m));
+				moves[m].fromFacelets(cube);
+			}
+		}
+	};
+}
+
+
+CubieCube::CubieCube() {
+	for (int i = 0; i < CornerCount; i++) {
+		cp[i] = static_cast<uint8_t>(i);
+		co[i] = 0;
+	}
+	for (int i = 0; i < EdgeCount; i++) {
+		ep[i] = static_cast<uint8_t>(i);
+		eo[i] = 0;
+	}
+}
+
+bool CubieCube::fromFacelets(const CubeModel& cube) {
+	auto& facelets = cube.getFacelets();
+	auto& slots = getSlotFacelets();
+
+	// every color in range and on 9 stickers, checked first since the colors index the tables below
+	int colorCount[FaceTotal] = {};
+	for (auto color : facelets) {
+		if (color >= FaceTotal || ++colorCount[color] > 9)
+			return false;
+	}
+
+	// the color in the middle of each face names that face, so the 6 centers must all differ
+	uint8_t faceOfColor[FaceTotal] = {};
+	bool centerSeen[FaceTotal] = {};
+	for (int f = 0; f < FaceTotal; f++) {
+		auto color = facelets[f * 9 + 4];
+		if (centerSeen[color])
+			return false;
+		centerSeen[color] = true;
+		faceOfColor[color] = static_cast<uint8_t>(f);
+	}
+
+	bool cornerSeen[CornerCount] = {}, edgeSeen[EdgeCount] = {};
+	int twist = 0, flip = 0;
+	for (int i = 0; i < CornerCount; i++) {
+		uint8_t faces[3];
+		for (int k = 0; k < 3; k++)
+			faces[k] = faceOfColor[facelets[slots.corners[i][k]]];
+
+		int ori = 0;
+		while (ori < 3 && faces[ori] != U && faces[ori] != D)
+			ori++;
+		if (ori == 3)
+			return false;
+
+		int j = 0;
+		while (j < CornerCount && (cornerFaces[j][0] != faces[ori] || cornerFaces[j][1] != faces[(ori + 1) % 3] ||
+			cornerFaces[j][2] != faces[(ori + 2) % 3]))
+			j++;
+		if (j == CornerCount || cornerSeen[j])
+			return false;
+
+		cornerSeen[j] = true;
+		cp[i] = static_cast<uint8_t>(j);
+		co[i] = static_cast<uint8_t>(ori);
+		twist += ori;
+	}
+
+	for (int i = 0; i < EdgeCount; i++) {
+		uint8_t face0 = faceOfColor[facelets[slots.edges[i][0]]];
+		uint8_t face1 = faceOfColor[facelets[slots.edges[i][1]]];
+
+		int j = 0;
+		while (j < EdgeCount && !((edgeFaces[j][0] == face0 && edgeFaces[j][1] == face1) ||
+			(edgeFaces[j][0] == face1 && edgeFaces[j][1] == face0)))
+			j++;
+		if (j == EdgeCount || edgeSeen[j])
+			return false;
+
+		edgeSeen[j] = true;
+		ep[i] = static_cast<uint8_t>(j);
+		eo[i] = edgeFaces[j][0] == face0 ? 0 : 1;
+		flip += eo[i];
+	}
+
+	// a twisted corner, flipped edge or swapped pair can not be solved
+	return twist % 3 == 0 && flip % 2 == 0 && isOddPermutation(cp, CornerCount) == isOddPermutation(ep, EdgeCount);
+}
+
+void CubieCube::toFacelets(CubeModel& cube) const {
+	auto& slots = getSlotFacelets();
+	Facelets facelets;
+	for (uint8_t f = 0; f < FaceTotal; f++)
+		facelets[f * 9 + 4] = f;
+
+	// the inverse of fromFacelets, the U/D sticker of the corner sits co[i] places into the slot's faces
+	for (int i = 0; i < CornerCount; i++) {
+		for (int k = 0; k < 3; k++)
+			facelets[slots.corners[i][k]] = cornerFaces[cp[i]][(k + 3 - co[i]) % 3];
+	}
+	for (int i = 0; i < EdgeCount; i++) {
+		for (int k = 0; k < 2; k++)
+			facelets[slots.edges[i][k]] = edgeFaces[ep[i]][k ^ eo[i]];
+	}
+	cube.setFacelets(facelets);
+}
+
+CubieCube CubieCube::getInverse() const {
+	CubieCube inverse;
+	for (int i = 0; i < CornerCount; i++) {
+		inverse.cp[cp[i]] = static_cast<uint8_t>(i);
+		inverse.co[cp[i]] = (3 - co[i]) % 3;
+	}
+	for (int i = 0; i < EdgeCount; i++) {
+		inverse.ep[ep[i]] = static_cast<uint8_t>(i);
+		inverse.eo[ep[i]] = eo[i];
+	}
+	return inverse;
+}
+
+void CubieCube::multiply(const CubieCube& other) {
+	cornerMultiply(other);
+	edgeMultiply(other);
+}
+
+void CubieCube::cornerMultiply(const CubieCube& other) {
+	multiplyCorners(*this, other);
+}
+
+void CubieCube::edgeMultiply(const CubieCube& other) {
+	multiplyEdges(*this, other);
+}
+
+const CubieCube& CubieCube::getMoveCube(Move move) {
+	static MoveCubes moveCubes;
+	return moveCubes.moves[move];
+}
+
+bool CubieCube::operator==(const CubieCube& other) const {
+	return std::equal(cp, cp + CornerCount, other.cp) && std::equal(co, co + CornerCount, other.co) &&
+		std::equal(ep, ep + EdgeCount, other.ep) && std::equal(eo, eo + EdgeCount, other.eo);
+}
+
+uint16_t CubieCube::getTwist() const {
+	return static_cast<uint16_t>(rankOrientation(co, CornerCount, 3));
+}
+
+void CubieCube::setTwist(uint16_t twist) {
+	unrankOrientation(twist, co, CornerCount, 3);
+}
+
+uint16_t CubieCube::getFlip() const {
+	return static_cast<uint16_t>(rankOrientation(eo, EdgeCount, 2));
+}
+
+void CubieCube::setFlip(uint16_t flip) {
+	unrankOrientation(flip, eo, EdgeCount, 2);
+}
+
+uint16_t CubieCube::getSlice() const {
+	// the 4 slots holding E slice edges, slots 8..11 give SolvedSlice
+	uint16_t slots = 0;
+	for (int i = 0; i < EdgeCount; i++) {
+		if (ep[i] >= EdgeFR)
+			slots |= 1 << i;
+	}
+	return static_cast<uint16_t>(rankCombination(slots, 4));
+}
+
+void CubieCube::setSlice(uint16_t slice) {
+	uint16_t slots = unrankCombination(slice, 4);
+	uint8_t nextSlice = EdgeFR, nextOther = EdgeUR;
+	for (int i = 0; i < EdgeCount; i++)
+		ep[i] = slots & (1 << i) ? nextSlice++ : nextOther++;
+}
+
+uint16_t CubieCube::getCornerPerm() const {
+	return static_cast<uint16_t>(rankPermutation(cp, CornerCount));
+}
+
+void CubieCube::setCornerPerm(uint16_t perm) {
+	unrankPermutation(perm, cp, CornerCount);
+}
+
+uint16_t CubieCube::getUDEdgePerm() const {
+	return static_cast<uint16_t>(rankPermutation(ep, 8));
+}
+
+void CubieCube::setUDEdgePerm(uint16_t perm) {
+	unrankPermutation(perm, ep, 8);
+	for (int i = EdgeFR; i < EdgeCount; i++)
+		ep[i] = static_cast<uint8_t>(i);
+}
+
+uint16_t CubieCube::getSlicePerm() const {
+	uint8_t perm[4];
+	for (int i = 0; i < 4; i++)
+		perm[i] = ep[EdgeFR + i] - EdgeFR;
+	return static_cast<uint16_t>(rankPermutation(perm, 4));
+}
+
+void CubieCube::setSlicePerm(uint16_t perm) {
+	uint8_t slicePerm[4];
+	unrankPermutation(perm, slicePerm, 4);
+	for (int i = 0; i < 4; i++)
+		ep[EdgeFR + i] = slicePerm[i] + EdgeFR;
+}
@@ -0,0 +1,78 @@
+// cubie level cube state
+#pragma once
+#include "CubeModel.h"
+
+// corner and edge slots in the usual solver order, U = top, D = bottom, F = front, B = back, R = right (-x), L = left (+x)
+enum Corner : uint8_t {
+	CornerURF, CornerUFL, CornerULB, CornerUBR, CornerDFR, CornerDLF, CornerDBL, CornerDRB,
+	CornerCount
+};
+
+enum Edge : uint8_t {
+	EdgeUR, EdgeUF, EdgeUL, EdgeUB, EdgeDR, EdgeDF, EdgeDL, EdgeDB,
+	EdgeFR, EdgeFL, EdgeBL, EdgeBR,											// the E slice between U and D
+	EdgeCount
+};
+
+constexpr uint16_t NumTwist = 2187;												// 3^7 corner orientations
+constexpr uint16_t NumFlip = 2048;												// 2^11 edge orientations
+constexpr uint16_t NumSlice = 495;												// C(12, 4) places of the E slice edges
+constexpr uint16_t NumCornerPerm = 40320;										// 8!
+constexpr uint16_t NumUDEdgePerm = 40320;										// 8! edges of U and D, only in phase 2
+constexpr uint16_t NumSlicePerm = 24;											// 4! E slice edges, only in phase 2
+constexpr uint16_t SolvedSlice = 494;
+
+// work done by one solver call
+struct SolveStats {
+	uint64_t nodes = 0;
+	double seconds = 0.0;
+
+	double getNodesPerSecond() const { return seconds > 0.0 ? nodes / seconds : 0.0; }
+};
+
+// the cube as permutations and orientations of its 8 corners and 12 edges. cp[i] is the corner in slot i, co[i] its
+// twist (0..2) as the position of its U/D sticker among the slot's stickers. edges the same, with the U/D sticker, or
+// the F/B sticker for E slice edges, deciding the flip. also has the coordinates the two-phase solver works on
+struct CubieCube {
+	uint8_t cp[CornerCount];
+	uint8_t co[CornerCount];
+	uint8_t ep[EdgeCount];
+	uint8_t eo[EdgeCount];
+
+	CubieCube();
+
+	// read the facelets of a cube model. the center colors decide which face is which, so the cube can be held in any
+	// orientation. false if the stickers do not form a valid cube
+	bool fromFacelets(const CubeModel& cube);
+	// the stickers of this cube, held with U on top and F in front
+	void toFacelets(CubeModel& cube) const;
+
+	// the cube that undoes this one, this * inverse is solved
+	CubieCube getInverse() const;
+
+	// this = this * other, ie. apply other after this
+	void multiply(const CubieCube& other);
+	void cornerMultiply(const CubieCube& other);
+	void edgeMultiply(const CubieCube& other);
+
+	// the cubie effect of one of the 18 face moves (MoveR .. MoveB2)
+	static const CubieCube& getMoveCube(Move move);
+
+	bool operator==(const CubieCube& other) const;
+
+	// phase 1 coordinates
+	uint16_t getTwist() const;
+	void setTwist(uint16_t twist);
+	uint16_t getFlip() const;
+	void setFlip(uint16_t flip);
+	uint16_t getSlice() const;
+	void setSlice(uint16_t slice);
+
+	// phase 2 coordinates, only meaningful once the cube is in <U, D, R2, L2, F2, B2>
+	uint16_t getCornerPerm() const;
+	void setCornerPerm(uint16_t perm);
+	uint16_t getUDEdgePerm() const;
+	void setUDEdgePerm(uint16_t perm);
+	uint16_t getSlicePerm() const;
+	void setSlicePerm(uint16_t perm);
+};
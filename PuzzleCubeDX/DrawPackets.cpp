@@ -0,0 +1,37 @@
+#include "DrawPackets.h"
+
+
+void DrawPacketBuilder::build(const uint32_t* meshOfDraw, uint32_t numDraws, uint32_t numMeshes) {
+	// count the instances of each mesh, then hand out slots mesh by mesh
+	std::vector<uint32_t> next(numMeshes, 0);
+	for (uint32_t i = 0; i < numDraws; i++) {
+		if (meshOfDraw[i] < numMeshes)
+			next[meshOfDraw[i]]++;
+	}
+
+	packets.clear();
+	numInstances = 0;
+	for (uint32_t mesh = 0; mesh < numMeshes; mesh++) {
+		uint32_t count = next[mesh];
+		next[mesh] = numInstances;
+		if (count > 0)
+			packets.push_back({ mesh, numInstances, count });
+		numInstances += count;
+	}
+
+	instanceOfDraw.resize(numDraws);
+	for (uint32_t i = 0; i < numDraws; i++)
+		instanceOfDraw[i] = meshOfDraw[i] < numMeshes ? next[meshOfDraw[i]]++ : InvalidInstance;
+}
+
+const std::vector<DrawPacket>& DrawPacketBuilder::getPackets() const {
+	return packets;
+}
+
+uint32_t DrawPacketBuilder::getNumInstances() const {
+	return numInstances;
+}
+
+uint32_t DrawPacketBuilder::getInstance(uint32_t draw) const {
+	return draw < instanceOfDraw.size() ? instanceOfDraw[draw] : InvalidInstance;
+}
@@ -0,0 +1,40 @@
+// grouping of draws into instanced draw packets
+#pragma once
+#include <cstdint>
+#include <vector>
+
+constexpr uint32_t InvalidInstance = 0xffffffff;
+
+// where a mesh sits in the shared vertex and index buffers
+struct MeshRange {
+	uint32_t baseVertex;
+	uint32_t startIndex;
+	uint32_t indexCount;
+};
+
+// one instanced draw of a mesh, its instances are the instance buffer slots firstInstance..firstInstance + instanceCount
+struct DrawPacket {
+	uint32_t mesh;
+	uint32_t firstInstance;
+	uint32_t instanceCount;
+};
+
+// sorts draws into one packet per mesh with a counting sort, so the instances of a packet are contiguous and keep the
+// draw order. draws are numbered densely (the CDraw pool order) and build hands each its instance slot. nothing here
+// knows about d3d12, the render system only uploads the slots and submits the packets
+class DrawPacketBuilder {
+public:
+	// meshOfDraw[i] is the mesh of draw i. draws with a mesh past numMeshes get no slot
+	void build(const uint32_t* meshOfDraw, uint32_t numDraws, uint32_t numMeshes);
+
+	const std::vector<DrawPacket>& getPackets() const;
+	uint32_t getNumInstances() const;
+
+	// instance buffer slot of a draw, InvalidInstance if it is not drawn
+	uint32_t getInstance(uint32_t draw) const;
+
+private:
+	std::vector<DrawPacket> packets;
+	std::vector<uint32_t> instanceOfDraw;
+	uint32_t numInstances = 0;
+};
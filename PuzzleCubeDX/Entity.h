@@ -0,0 +1,35 @@
+// entity handles
+#pragma once
+#ifdef _WIN32
+#include "stdafx.h"
+#else
+// headless builds (tools, ci) have no windows sdk
+typedef unsigned int UINT;
+#endif
+
+// an entity handle packs the slot index in the low bits and the slot's generation in the high bits.
+// destroying an entity bumps its slot generation so old handles to a recycled slot can be detected as stale
+constexpr UINT EntityIndexBits = 22;												// ~4M live entities
+constexpr UINT EntityIndexMask = (1u << EntityIndexBits) - 1;
+constexpr UINT EntityGenerationMask = ~0u >> EntityIndexBits;
+
+constexpr UINT NullEntity = ~0u;													// no entity, eg. a root in CHierarchy
+
+// live entities never reach the last generation, handles with it are placeholders handed out by a CommandBuffer
+constexpr UINT PendingGeneration = EntityGenerationMask;
+
+inline UINT entityIndex(UINT entity) {
+	return entity & EntityIndexMask;
+}
+
+inline UINT entityGeneration(UINT entity) {
+	return entity >> EntityIndexBits;
+}
+
+inline bool isPendingEntity(UINT entity) {
+	return entity != NullEntity && entityGeneration(entity) == PendingGeneration;
+}
+
+inline UINT makeEntity(UINT index, UINT generation) {
+	return ((generation & EntityGenerationMask) << EntityIndexBits) | index;
+}
@@ -1,536 +1,397 @@
-#include "GameplaySystem.h"
-#include "Components.h"
-#include "Helper.h"
-
-#include <cstdlib>
-#include <ctime>
-
-XMFLOAT3 faceDirection[] = {
-	{0.f, 0.f, 1.f},							// front
-	{-1.f, 0.f, 0.f},							// right
-	{0.f, 1.f, 0.f},							// top
-	{1.f, 0.f, 0.f},							// left
-	{0.f, 0.f, -1.f},							// back
-	{0.f, -1.f, 0.f}							// bottom
-};
-
-enum FaceDirection {
-	FRONT,
-	RIGHT,
-	TOP,
-	LEFT,
-	BACK,
-	BOTTOM,
-	TOTAL
-};
-
-GameplaySystem::GameplaySystem() : cubeRotInMotion(false), rotTargetReached(false) {
-
-}
-
-void GameplaySystem::onShuffle() {
-	std::srand(std::time(0));
-	for (int i = 0; i < 24; i++) 
-		queueCmd.push(cubeNotations[std::rand() % cubeNotations.size()]);
-
-}
-
-void GameplaySystem::processInputCmd(const std::string strcmd) {
-	// rotate cube sides by filling up the queue with algo commands even when using the button interface
-	if (queueCmd.empty()) {
-		int i = 0;
-		while (true) {
-			if (i >= strcmd.length())
-				break;
-			else if(i == strcmd.length() - 1)
-				queueCmd.push(strcmd.substr(i++, 1));
-			else {
-				if (strcmd[i + 1] == 'i') {
-					queueCmd.push(strcmd.substr(i, 2));
-					i += 2;
-				}
-				else {
-					queueCmd.push(strcmd.substr(i++, 1));
-				}
-			}
-		}
-	}
-	
-}
-
-bool GameplaySystem::onUpdate(const float& deltaTime) {
-	if (queueCmd.empty() == false && cubeRotInMotion == false) {
-		currRotation = { 0.f, 0.f, 0.f };
-		rotateCubeSide(queueCmd.front());
-		queueCmd.pop();
-	}
-
-	// rotate the pivot and all its child pieces will rotate too
-
-	// rotTargetReached allows to update transformations in RenderSystem final time one more frame after we create pivot model mat
-	if (rotTargetReached && cubeRotInMotion) {
-		rotTargetReached = false;
-		cubeRotInMotion = false;
-
-		for (auto& epiece : entitiesPiecesInRot) {
-			auto& cTrans = registry->getComponent<CTransform>(epiece);
-			auto& cHrchy = registry->getComponent<CHierarchy>(epiece);
-
-			// precision problems in model matrix with translation cause the cube to render in buggy state
-			// all world position xyz values must be 0 or 0.5 or -0.5f, thats why something like 0.499999 must be rounded off to 0.50
-			// otherwise rotateCubeSide() cannot identify which pieces to rotate if there position isnt precise
-			cTrans.mxmodel._41 = roundoff(cTrans.mxmodel._41, 0.5f);
-			cTrans.mxmodel._42 = roundoff(cTrans.mxmodel._42, 0.5f);
-			cTrans.mxmodel._43 = roundoff(cTrans.mxmodel._43, 0.5f);
-			cTrans.mxlocal = cTrans.mxmodel;																// finalize local matrix position after rot is complete to set its position in stone			
-			cHrchy = -1;																					// remove the pivot parent so it doesnt multiply with its matrix
-		}
-	}
-
-	if (cubeRotInMotion) {
-		auto& cTrans = registry->getComponent<CTransform>(entityCntlPivot);
-		if (rotVelocity.x != 0.f) 
-			currRotation.x += rotVelocity.x * deltaTime;
-		else if (rotVelocity.y != 0.f)
-			currRotation.y += rotVelocity.y * deltaTime;
-		else if (rotVelocity.z != 0.f) 
-			currRotation.z += rotVelocity.z * deltaTime;
-
-		if ((rotationTarget.x > 0.f && currRotation.x > rotationTarget.x) || (rotationTarget.x < 0.f && currRotation.x < rotationTarget.x) ||
-			(rotationTarget.y > 0.f && currRotation.y > rotationTarget.y) || (rotationTarget.y < 0.f && currRotation.y < rotationTarget.y) ||
-			(rotationTarget.z > 0.f && currRotation.z > rotationTarget.z) || (rotationTarget.z < 0.f && currRotation.z < rotationTarget.z))
-		{
-			currRotation = rotationTarget;
-			rotTargetReached = true;
-			rotationTarget = { 0.f, 0.f, 0.f };
-		}
-			
-
-		// model matrix = scale * rot * trans
-		auto mxmodel = XMMatrixRotationRollPitchYawFromVector(XMLoadFloat3(&currRotation)) /** XMMatrixTranslationFromVector(XMLoadFloat3(&cTrans.pos))*/;
-		XMStoreFloat4x4(&cTrans.mxmodel, mxmodel);
-	}
-
-	return cubeRotInMotion;
-}
-
-
-
-
-void GameplaySystem::onInit(std::shared_ptr<Registry> registry, int mWndWidth, int mWndHeight) {
-	this->registry = registry;
-	this->mWndHeight = mWndHeight;
-	this->mWndWidth = mWndWidth;
-
-	createCubeNotations();
-	storeEntities();
-	onReset();
-}
-
-
-void GameplaySystem::onReset() {
-	if (queueCmd.empty()) {
-		// reset the entire cube by repainting the faces
-		for (auto& e : entitiesFace) {
-			auto& ctrans = registry->getComponent<CTransform>(e);
-			auto& cdraw = registry->getComponent<CDraw>(e);
-
-			for (uint8_t i = 0; i < _countof(faceDirection); i++) {
-				if ((ctrans.forward.x == faceDirection[i].x) && (ctrans.forward.y == faceDirection[i].y) && (ctrans.forward.z == faceDirection[i].z)) {
-					cdraw.colorIndex = i;
-					break;
-				}
-			}
-
-		}
-	}
-}
-
-
-void GameplaySystem::storeEntities() {
-	// get all CFace entities
-	Signature sigFace;
-	sigFace.set(registry->getComponentTypeID<CFace>());
-	// store all drawable entities that have CFace
-	entitiesFace = registry->getEntitiesFromSignature(sigFace);
-
-
-	// pieces 
-	Signature sigPiece;
-	sigPiece.set(registry->getComponentTypeID<CPiece>());
-	// store all drawable entities that have CDraw
-	entitiesPiece = registry->getEntitiesFromSignature(sigPiece);
-
-
-	// central pivot entity to rotate all pieces of the cube
-	Signature sigCenPivot;
-	sigCenPivot.set(registry->getComponentTypeID<CCentralPivot>());
-	auto vecEntCenPivot = registry->getEntitiesFromSignature(sigCenPivot);
-
-	// there is only 1 central pivot entity
-	entityCntlPivot = vecEntCenPivot[0];
-}
-
-void GameplaySystem::createCubeNotations() {
-	// clockwise 
-	cubeNotations.push_back("R");
-	cubeNotations.push_back("L");
-	cubeNotations.push_back("U");
-	cubeNotations.push_back("F");
-	cubeNotations.push_back("D");
-	cubeNotations.push_back("B");
-
-	// anti clockwise
-	cubeNotations.push_back("Ri");
-	cubeNotations.push_back("Li");
-	cubeNotations.push_back("Ui");
-	cubeNotations.push_back("Fi");
-	cubeNotations.push_back("Di");
-	cubeNotations.push_back("Bi");
-
-	// slice
-	cubeNotations.push_back("M");
-	cubeNotations.push_back("Mi");
-	cubeNotations.push_back("E");
-	cubeNotations.push_back("Ei");
-	cubeNotations.push_back("S");
-	cubeNotations.push_back("Si");
-
-	// double layer
-	cubeNotations.push_back("r");
-	cubeNotations.push_back("l");
-	cubeNotations.push_back("u");
-	cubeNotations.push_back("f");
-	cubeNotations.push_back("d");
-	cubeNotations.push_back("b");
-	
-	// inverse double layer
-	cubeNotations.push_back("ri");
-	cubeNotations.push_back("li");
-	cubeNotations.push_back("ui");
-	cubeNotations.push_back("fi");
-	cubeNotations.push_back("di");
-	cubeNotations.push_back("bi");
-
-	// whole cube
-	cubeNotations.push_back("X");
-	cubeNotations.push_back("Xi");
-	cubeNotations.push_back("Y");
-	cubeNotations.push_back("Yi");
-	cubeNotations.push_back("Z");
-	cubeNotations.push_back("Zi");
-}
-
-
-void GameplaySystem::rotateCubeSide(std::string notation) {
-	CTransform& ctrans = registry->getComponent<CTransform>(entityCntlPivot);
-
-	if (notation == "R") {
-		setPieceEntityPivot('x', -0.5f);
-		rotationTarget.x = -XM_PIDIV2;
-	}
-	else if (notation == "L") {
-		setPieceEntityPivot('x', 0.5f);
-		rotationTarget.x = XM_PIDIV2;
-	}
-	else if (notation == "U") {
-		setPieceEntityPivot('y', .5f);
-		rotationTarget.y = XM_PIDIV2;
-	}
-	else if (notation == "F") {
-		setPieceEntityPivot('z', .5f);
-		rotationTarget.z = XM_PIDIV2;
-	}
-	else if (notation == "D") {
-		setPieceEntityPivot('y', -.5f);
-		rotationTarget.y = -XM_PIDIV2;
-	}
-	else if (notation == "B") {
-		setPieceEntityPivot('z', -.5f);
-		rotationTarget.z = -XM_PIDIV2;
-	}
-
-	if (notation == "Ri") {
-		setPieceEntityPivot('x', -0.5f);
-		rotationTarget.x = XM_PIDIV2;
-	}
-	else if (notation == "Li") {
-		setPieceEntityPivot('x', 0.5f);
-		rotationTarget.x = -XM_PIDIV2;
-	}
-	else if (notation == "Ui") {
-		setPieceEntityPivot('y', .5f);
-		rotationTarget.y = -XM_PIDIV2;
-	}
-	else if (notation == "Fi") {
-		setPieceEntityPivot('z', .5f);
-		rotationTarget.z = -XM_PIDIV2;
-	}
-	else if (notation == "Di") {
-		setPieceEntityPivot('y', -.5f);
-		rotationTarget.y = XM_PIDIV2;
-	}
-	else if (notation == "Bi") {
-		setPieceEntityPivot('z', -.5f);
-		rotationTarget.z = XM_PIDIV2;
-	}
-
-
-	if (notation == "M") {
-		setPieceEntityPivotMiddle('x');
-	    rotationTarget.x = XM_PIDIV2;
-	}
-	else if (notation == "Mi") {
-		setPieceEntityPivotMiddle('x');
-		rotationTarget.x = -XM_PIDIV2;
-	}
-	else if (notation == "E") {
-		setPieceEntityPivotMiddle('y');
-		rotationTarget.y = -XM_PIDIV2;
-	}
-	else if (notation == "Ei") {
-		setPieceEntityPivotMiddle('y');
-		rotationTarget.y = XM_PIDIV2;
-	}
-	else if (notation == "S") {
-		setPieceEntityPivotMiddle('z');
-		rotationTarget.z = XM_PIDIV2;
-	}
-	else if (notation == "Si") {
-		setPieceEntityPivotMiddle('z');
-		rotationTarget.z = -XM_PIDIV2;
-	}
-
-
-	
-	if (notation == "r") {
-		setPieceEntityPivotDouble('x', 0.5f);
-		rotationTarget.x = -XM_PIDIV2;
-	}
-	else if (notation == "l") {
-		setPieceEntityPivotDouble('x', -0.5f);
-		rotationTarget.x = XM_PIDIV2;
-	}
-	else if (notation == "u") {
-		setPieceEntityPivotDouble('y', -.5f);
-		rotationTarget.y = XM_PIDIV2;
-	}
-	else if (notation == "f") {
-		setPieceEntityPivotDouble('z', -.5f);
-		rotationTarget.z = XM_PIDIV2;
-	}
-	else if (notation == "d") {
-		setPieceEntityPivotDouble('y', .5f);
-		rotationTarget.y = -XM_PIDIV2;
-	}
-	else if (notation == "b") {
-		setPieceEntityPivotDouble('z', .5f);
-		rotationTarget.z = -XM_PIDIV2;
-	}
-
-
-	if (notation == "ri") {
-		setPieceEntityPivotDouble('x', 0.5f);
-		rotationTarget.x = XM_PIDIV2;
-	}
-	else if (notation == "li") {
-		setPieceEntityPivotDouble('x', -0.5f);
-		rotationTarget.x = -XM_PIDIV2;
-	}
-	else if (notation == "ui") {
-		setPieceEntityPivotDouble('y', -.5f);
-		rotationTarget.y = -XM_PIDIV2;
-	}
-	else if (notation == "fi") {
-		setPieceEntityPivotDouble('z', -.5f);
-		rotationTarget.z = -XM_PIDIV2;
-	}
-	else if (notation == "di") {
-		setPieceEntityPivotDouble('y', .5f);
-		rotationTarget.y = XM_PIDIV2;
-	}
-	else if (notation == "bi") {
-		setPieceEntityPivotDouble('z', .5f);
-		rotationTarget.z = XM_PIDIV2;
-	}
-
-
-
-	if (notation == "X") {
-		setPieceEntityPivotAll();
-		rotationTarget.x = -XM_PIDIV2;
-	}
-	else if (notation == "Xi") {
-		setPieceEntityPivotAll();
-		rotationTarget.x = XM_PIDIV2;
-	}
-	else if (notation == "Y") {
-		setPieceEntityPivotAll();
-		rotationTarget.y = XM_PIDIV2;
-	}
-	else if (notation == "Z") {
-		setPieceEntityPivotAll();
-		rotationTarget.z = XM_PIDIV2;
-	}
-	else if (notation == "Yi") {
-		setPieceEntityPivotAll();
-		rotationTarget.y = -XM_PIDIV2;
-	}
-	else if (notation == "Zi") {
-		setPieceEntityPivotAll();
-		rotationTarget.z = -XM_PIDIV2;
-	}
-
-
-	rotVelocity = { rotationTarget.x * 4.f, rotationTarget.y * 4.f, rotationTarget.z * 4.f };
-	
-	OutputDebugStringA("H");
-	//cubeRotInMotion = true;
-}
-
-
-void GameplaySystem::setPieceEntityPivot(const char axis, const float cmpPos) {
-	entitiesPiecesInRot.clear();
-
-	float pos = 0.f;
-	for (auto epiece : entitiesPiece) {
-		auto& ctransPiece = registry->getComponent<CTransform>(epiece);
-
-		// get translation from model matrix; normalize and compare
-		if (axis == 'x')
-			pos = ctransPiece.mxlocal._41;
-		else if (axis == 'y')
-			pos = ctransPiece.mxlocal._42;
-		else
-			pos = ctransPiece.mxlocal._43;
-
-		// set pivot as parent of piece that will rotate 
-		if (pos == cmpPos) {
-			auto& chrchy = registry->getComponent<CHierarchy>(epiece);
-			chrchy.entityParent = entityCntlPivot;
-			entitiesPiecesInRot.push_back(epiece);
-		}
-	}
-
-	cubeRotInMotion = true;
-}
-
-void GameplaySystem::setPieceEntityPivotMiddle(const char axis) {
-	entitiesPiecesInRot.clear();
-
-	float pos = 0.f;
-	for (auto epiece : entitiesPiece) {
-		auto& ctransPiece = registry->getComponent<CTransform>(epiece);
-
-		// get translation from model matrix; normalize and compare
-		if (axis == 'x')
-			pos = ctransPiece.mxlocal._41;
-		else if (axis == 'y')
-			pos = ctransPiece.mxlocal._42;
-		else
-			pos = ctransPiece.mxlocal._43;
-
-		// set pivot as parent of piece that will rotate 
-		if (pos == 0.f) {
-			auto& chrchy = registry->getComponent<CHierarchy>(epiece);
-			chrchy.entityParent = entityCntlPivot;
-			entitiesPiecesInRot.push_back(epiece);
-		}
-	}
-
-	cubeRotInMotion = true;
-
-}
-
-void GameplaySystem::setPieceEntityPivotDouble(const char axis, const float cmpPos) {
-	entitiesPiecesInRot.clear();
-
-	float pos = 0.f;
-	for (auto epiece : entitiesPiece) {
-		auto& ctransPiece = registry->getComponent<CTransform>(epiece);
-
-		// get translation from model matrix; normalize and compare
-		if (axis == 'x')
-			pos = ctransPiece.mxlocal._41;
-		else if (axis == 'y')
-			pos = ctransPiece.mxlocal._42;
-		else
-			pos = ctransPiece.mxlocal._43;
-
-		// set pivot as parent of piece that will rotate 
-		if (pos != cmpPos) {
-			auto& chrchy = registry->getComponent<CHierarchy>(epiece);
-			chrchy.entityParent = entityCntlPivot;
-			entitiesPiecesInRot.push_back(epiece);
-		}
-	}
-
-	cubeRotInMotion = true;
-
-}
-
-void GameplaySystem::setPieceEntityPivotAll() {
-	entitiesPiecesInRot.clear();
-
-	float pos = 0.f;
-	for (auto epiece : entitiesPiece) {
-		auto& chrchy = registry->getComponent<CHierarchy>(epiece);
-		chrchy.entityParent = entityCntlPivot;
-		entitiesPiecesInRot.push_back(epiece);
-	}
-
-	cubeRotInMotion = true;
-
-}
-
-
-void GameplaySystem::resetCentralPivot() {
-	// reset pivot
-	auto& cTrans = registry->getComponent<CTransform>(entityCntlPivot);
-	cTrans.rot = { 0.f, 0.f, 0.f };
-
-	// model matrix = scale * rot * trans
-	auto mxmodel = XMMatrixRotationRollPitchYawFromVector(XMLoadFloat3(&cTrans.rot)) * XMMatrixTranslationFromVector(XMLoadFloat3(&cTrans.pos));
-	XMStoreFloat4x4(&cTrans.mxmodel, mxmodel);
-}
-
-
-void GameplaySystem::raycastPick(const int sx, const int sy, XMFLOAT4X4 mproj, XMFLOAT4X4 mview) {
-	// Compute picking ray in view space.
-	float vx = (2.0f * sx / mWndWidth - 1.0f) / mproj(0, 0);
-	float vy = (-2.0f * sy / mWndHeight + 1.0f) / mproj(1, 1);
-
-	// Ray definition in view space.
-	XMVECTOR rayOrigin = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
-	XMVECTOR rayDir = XMVectorSet(vx, vy, 1.0f, 0.0f);
-
-	XMMATRIX xmview = XMLoadFloat4x4(&mview);
-	auto xmviewDet = XMMatrixDeterminant(xmview);
-	XMMATRIX invView = XMMatrixInverse(&xmviewDet, xmview);
-
-	for (auto& e : entitiesPiece) {
-		auto& cbbox = registry->getComponent<CBoundingBox>(e);
-		auto& ctrans = registry->getComponent<CTransform>(e);
-
-		XMMATRIX xmmodel = XMLoadFloat4x4(&ctrans.mxmodel);
-		auto xmmodelDet = XMMatrixDeterminant(xmmodel);
-		XMMATRIX invModel = XMMatrixInverse(&xmmodelDet, xmmodel);
-
-		// convert ray to local space of the model
-		XMMATRIX toLocal = XMMatrixMultiply(invView, invModel);
-
-		rayOrigin = XMVector3TransformCoord(rayOrigin, toLocal);
-		rayDir = XMVector3TransformNormal(rayDir, toLocal);
-
-		// normalize to get true direction
-		rayDir = XMVector3Normalize(rayDir);
-
-
-		float rayDist = 150.f;
-		if (cbbox.obb.Intersects(rayOrigin, rayDir, rayDist)) {
-			OutputDebugStringA("\n\n\n\n\nRay hit!!!\n\n\n\n\n\n");
-		}
-
-	}
-
+#include "GameplaySystem.h"
+#include "Components.h"
+#include "Helper.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+namespace {
+	// components of a unit axis vector to -1, 0 or 1
+	int toCubeCoord(float v) {
+		return v > 0.25f ? 1 : v < -0.25f ? -1 : 0;
+	}
+}
+
+GameplaySystem::GameplaySystem() : cubeRotInMotion(false), rotTargetReached(false), random(std::random_device{}()) {
+
+}
+
+void GameplaySystem::onShuffle(const Scrambler& scrambler) {
+	if (cube.getSize() == 3) {
+		// a random state scramble, uniform no matter what the cube looked like before. it solves a random state, which
+		// can take a while, so like a solve it runs off the window thread on its own generator seeded from ours
+		if (isShuffling() || isSolving())
+			return;
+		pendingScramble = std::async(std::launch::async, [&scrambler, seed = random.next()] {
+			Random random(seed);
+			std::vector<Move> scramble;
+			scrambler.generate(random, scramble);
+			return scramble;
+		});
+		return;
+	}
+
+	// other sizes get random single layer turns, quick enough to make right here
+	std::vector<LayerMove> scramble;
+	Scrambler::generate(random, cube, scramble);
+	LOG_DEBUG(Gameplay, "scramble: %s", toNotation(scramble).c_str());
+	for (auto& move : scramble)
+		queueCmd.push(move);
+}
+
+void GameplaySystem::onSolve(const TwoPhaseSolver& solver) {
+	// solve from the model state, which is only exact when nothing is queued or turning
+	if (!queueCmd.empty() || cubeRotInMotion || isSolving() || isShuffling())
+		return;
+
+	if (!cube.toCubeModel(solveState)) {
+		LOG_WARN(Gameplay, "the solver only takes the 3x3");
+		return;
+	}
+
+	// a solve can take up to its timeout, so it runs off the window thread and onUpdate picks up the result
+	pendingSolve = std::async(std::launch::async, [&solver, state = solveState] {
+		SolveResult result;
+		result.solved = solver.solve(state, result.moves);
+		return result;
+	});
+}
+
+bool GameplaySystem::isSolving() const {
+	return pendingSolve.valid();
+}
+
+bool GameplaySystem::isShuffling() const {
+	return pendingScramble.valid();
+}
+
+void GameplaySystem::pollScramble() {
+	if (!pendingScramble.valid() || pendingScramble.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		return;
+
+	// the scramble is queued behind anything typed in the meantime, it takes the cube to a random state either way
+	auto scramble = pendingScramble.get();
+	if (cube.getSize() != 3)
+		return;
+	LOG_DEBUG(Gameplay, "scramble: %s", toNotation(scramble).c_str());
+	for (auto move : scramble)
+		queueCmd.push(move);
+}
+
+void GameplaySystem::pollSolve() {
+	if (!pendingSolve.valid() || pendingSolve.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		return;
+
+	auto result = pendingSolve.get();
+	if (!result.solved) {
+		LOG_WARN(Gameplay, "no solution found");
+		return;
+	}
+
+	// moves made while the solver ran would make the solution wrong
+	CubeModel state;
+	if (!queueCmd.empty() || cubeRotInMotion || !cube.toCubeModel(state) || !(state == solveState)) {
+		LOG_INFO(Gameplay, "the cube changed while solving, solution dropped");
+		return;
+	}
+
+	LOG_INFO(Gameplay, "solution (%zu moves): %s", result.moves.size(), toNotation(result.moves).c_str());
+	for (auto move : result.moves)
+		queueCmd.push(move);
+}
+
+void GameplaySystem::processInputCmd(const std::string strcmd) {
+	// rotate cube sides by appending algo commands to the queue. the text is compiled once here, the queue only holds
+	// moves. 3x3 sequences are simplified too so only the net moves animate, bigger cubes take layer numbers (3Rw)
+	std::string error;
+	if (cube.getSize() == 3) {
+		std::vector<Move> moves;
+		if (!compileNotation(strcmd, moves, &error)) {
+			LOG_WARN(Gameplay, "\"%s\" %s", strcmd.c_str(), error.c_str());
+			return;
+		}
+
+		simplifyMoves(moves);
+		for (auto move : moves)
+			queueCmd.push(move);
+		return;
+	}
+
+	std::vector<LayerMove> moves;
+	if (!compileNotation(strcmd, cube.getSize(), moves, &error)) {
+		LOG_WARN(Gameplay, "\"%s\" %s", strcmd.c_str(), error.c_str());
+		return;
+	}
+	for (auto& move : moves)
+		queueCmd.push(move);
+}
+
+void GameplaySystem::queueMove(const LayerMove& move) {
+	queueCmd.push(move);
+}
+
+bool GameplaySystem::onUpdate(const float& deltaTime) {
+	pollScramble();
+	pollSolve();
+
+	if (queueCmd.empty() == false && cubeRotInMotion == false) {
+		currRotation = { 0.f, 0.f, 0.f };
+		rotateCubeSide(queueCmd.front());
+		queueCmd.pop();
+	}
+
+	// rotate the pivot and all its child pieces will rotate too
+
+	// rotTargetReached allows to update transformations in RenderSystem final time one more frame after we create pivot model mat
+	if (rotTargetReached && cubeRotInMotion) {
+		rotTargetReached = false;
+		cubeRotInMotion = false;
+
+		// the turn is only applied to the cube model once the animation is done. the turned pieces then snap back to
+		// their home slots and their faces are repainted from the model, which looks the same as the rotated pieces
+		// but keeps every transform exact
+		cube.apply(currentTurn);
+		for (auto& epiece : entitiesPiecesInRot) {
+			auto& cTrans = view.get<CTransform>(epiece);
+			cTrans.mxlocal = pieceSlots[pieceSlotOfEntity[entityIndex(epiece)]].mxhome;
+			hierarchySystem->setParent(epiece, NullEntity);																// remove the pivot parent so it doesnt multiply with its matrix
+			registry->markChanged<CTransform>(epiece);
+			commandBuffers->local().removeComponent<CTurning>(epiece);
+
+			for (auto eface : view.get<CHierarchy>(epiece).childEntities)
+				paintFace(eface);
+		}
+	}
+
+	if (cubeRotInMotion) {
+		auto& cTrans = view.get<CTransform>(entityCntlPivot);
+		if (rotVelocity.x != 0.f) 
+			currRotation.x += rotVelocity.x * deltaTime;
+		else if (rotVelocity.y != 0.f)
+			currRotation.y += rotVelocity.y * deltaTime;
+		else if (rotVelocity.z != 0.f) 
+			currRotation.z += rotVelocity.z * deltaTime;
+
+		if ((rotationTarget.x > 0.f && currRotation.x > rotationTarget.x) || (rotationTarget.x < 0.f && currRotation.x < rotationTarget.x) ||
+			(rotationTarget.y > 0.f && currRotation.y > rotationTarget.y) || (rotationTarget.y < 0.f && currRotation.y < rotationTarget.y) ||
+			(rotationTarget.z > 0.f && currRotation.z > rotationTarget.z) || (rotationTarget.z < 0.f && currRotation.z < rotationTarget.z))
+		{
+			currRotation = rotationTarget;
+			rotTargetReached = true;
+			rotationTarget = { 0.f, 0.f, 0.f };
+		}
+			
+
+		// model matrix = scale * rot * trans
+		auto mxmodel = XMMatrixRotationRollPitchYawFromVector(XMLoadFloat3(&currRotation)) /** XMMatrixTranslationFromVector(XMLoadFloat3(&cTrans.pos))*/;
+		XMStoreFloat4x4(&cTrans.mxlocal, mxmodel);
+		registry->markChanged<CTransform>(entityCntlPivot);
+	}
+
+	return cubeRotInMotion;
+}
+
+
+
+
+void GameplaySystem::onInit(std::shared_ptr<Registry> registry, HierarchySystem* hierarchySystem, CommandBuffers* commandBuffers, int mWndWidth,
+	int mWndHeight, uint16_t cubeSize) {
+	this->registry = registry;
+	this->hierarchySystem = hierarchySystem;
+	this->commandBuffers = commandBuffers;
+	this->view = registry->getView<CTransform, CHierarchy, CDraw, CBoundingBox>();
+	this->mWndHeight = mWndHeight;
+	this->mWndWidth = mWndWidth;
+	cube.setSize(cubeSize);
+
+	createCubeNotations();
+	storeEntities();
+	onReset();
+}
+
+
+void GameplaySystem::onReset() {
+	if (queueCmd.empty() && !cubeRotInMotion) {
+		// reset the entire cube by repainting the faces
+		cube.reset();
+		for (auto& e : registry->getQueryEntities(queryFace))
+			paintFace(e);
+	}
+}
+
+bool GameplaySystem::isSolved() const {
+	return cube.isSolved();
+}
+
+const CubeModelNxN& GameplaySystem::getCube() const {
+	return cube;
+}
+
+void GameplaySystem::paintFace(UINT eface) {
+	auto& cdraw = view.get<CDraw>(eface);
+	cdraw.colorIndex = cube.getFacelet(faceletOfEntity[entityIndex(eface)]);
+	registry->markChanged<CDraw>(eface);
+}
+
+
+void GameplaySystem::storeEntities() {
+	// live sets of all CFace and CPiece entities, kept up to date by the registry
+	queryFace = registry->registerQuery(registry->getSignature<CFace>());
+	queryPiece = registry->registerQuery(registry->getSignature<CPiece>());
+	queryPickable = registry->registerQuery(registry->getSignature<CPiece>(), Signature(), registry->getSignature<CTurning>());
+
+	// central pivot entity to rotate all pieces of the cube
+	auto queryCenPivot = registry->registerQuery(registry->getSignature<CCentralPivot, CTransform>());
+
+	// there is only 1 central pivot entity
+	entityCntlPivot = registry->getQueryEntities(queryCenPivot)[0];
+
+	// map the assembled cube onto the cube model once: each piece keeps its home slot, each face the facelet it shows
+	for (auto epiece : registry->getQueryEntities(queryPiece)) {
+		auto& ctrans = view.get<CTransform>(epiece);
+		auto& cpiece = registry->getComponent<CPiece>(epiece);
+		PieceSlot slot;
+		slot.entity = epiece;
+		for (int k = 0; k < 3; k++)
+			slot.position[k] = cpiece.position[k];
+		slot.mxhome = ctrans.mxlocal;
+
+		if (entityIndex(epiece) >= pieceSlotOfEntity.size())
+			pieceSlotOfEntity.resize(entityIndex(epiece) + 1, InvalidIndex);
+		pieceSlotOfEntity[entityIndex(epiece)] = static_cast<UINT>(pieceSlots.size());
+
+		for (auto eface : view.get<CHierarchy>(epiece).childEntities) {
+			auto& forward = view.get<CTransform>(eface).forward;
+			int normal[3] = { toCubeCoord(forward.x), toCubeCoord(forward.y), toCubeCoord(forward.z) };
+			if (entityIndex(eface) >= faceletOfEntity.size())
+				faceletOfEntity.resize(entityIndex(eface) + 1, InvalidFaceletNxN);
+			faceletOfEntity[entityIndex(eface)] = cube.faceletAt(slot.position, normal);
+		}
+
+		pieceSlots.push_back(slot);
+	}
+
+	// bucket the slots by layer on every axis, counting sort style
+	uint16_t n = cube.getSize();
+	for (int axis = 0; axis < 3; axis++) {
+		layerStart[axis].assign(n + 1, 0);
+		for (auto& slot : pieceSlots)
+			layerStart[axis][slot.position[axis] + 1]++;
+		for (uint16_t l = 0; l < n; l++)
+			layerStart[axis][l + 1] += layerStart[axis][l];
+
+		std::vector<UINT> next(layerStart[axis].begin(), layerStart[axis].end() - 1);
+		slotsInLayer[axis].resize(pieceSlots.size());
+		for (UINT i = 0; i < pieceSlots.size(); i++)
+			slotsInLayer[axis][next[pieceSlots[i].position[axis]]++] = i;
+	}
+}
+
+void GameplaySystem::createCubeNotations() {
+	// the moves on the buttons, 6 per row
+	cubeMoves = {
+		MoveR, MoveL, MoveU, MoveF, MoveD, MoveB,							// clockwise
+		MoveRi, MoveLi, MoveUi, MoveFi, MoveDi, MoveBi,						// anti clockwise
+		MoveM, MoveMi, MoveE, MoveEi, MoveS, MoveSi,						// slice
+		MoveRw, MoveLw, MoveUw, MoveFw, MoveDw, MoveBw,						// double layer
+		MoveRwi, MoveLwi, MoveUwi, MoveFwi, MoveDwi, MoveBwi,				// inverse double layer
+		MoveX, MoveXi, MoveY, MoveYi, MoveZ, MoveZi							// whole cube
+	};
+}
+
+
+void GameplaySystem::rotateCubeSide(const LayerMove& move) {
+	// every layer of a move turns the way its 3x3 namesake does
+	auto& moveInfo = getMoveInfo(move.base);
+	currentTurn = cube.getTurn(move);
+	setPieceEntityPivot(currentTurn);
+
+	if (currentTurn.axis == 0)
+		rotationTarget.x = moveInfo.angle;
+	else if (currentTurn.axis == 1)
+		rotationTarget.y = moveInfo.angle;
+	else
+		rotationTarget.z = moveInfo.angle;
+
+	// quarter turns take a quarter of a second, double turns the same
+	rotVelocity = { rotationTarget.x * 4.f, rotationTarget.y * 4.f, rotationTarget.z * 4.f };
+	
+	LOG_DEBUG(Gameplay, "rotate %s", toNotation(std::vector<LayerMove>{ move }).c_str());
+}
+
+
+void GameplaySystem::setPieceEntityPivot(const LayerTurn& turn) {
+	entitiesPiecesInRot.clear();
+
+	// set pivot as parent of the pieces whose home slot lies in one of the turning layers. the CTurning tags are
+	// structural changes, so they are recorded and only land in the registry at the sync point after the systems ran
+	auto& commands = commandBuffers->local();
+	auto& starts = layerStart[turn.axis];
+	uint16_t last = std::min<uint16_t>(turn.last, cube.getSize() - 1);
+	if (turn.first <= last) {
+		for (UINT i = starts[turn.first]; i < starts[last + 1]; i++) {
+			auto entity = pieceSlots[slotsInLayer[turn.axis][i]].entity;
+			hierarchySystem->setParent(entity, entityCntlPivot);
+			commands.addComponent<CTurning>(entity);
+			entitiesPiecesInRot.push_back(entity);
+		}
+	}
+
+	cubeRotInMotion = true;
+}
+
+
+void GameplaySystem::resetCentralPivot() {
+	// reset pivot
+	auto& cTrans = view.get<CTransform>(entityCntlPivot);
+	cTrans.rot = { 0.f, 0.f, 0.f };
+
+	// model matrix = scale * rot * trans
+	auto mxmodel = XMMatrixRotationRollPitchYawFromVector(XMLoadFloat3(&cTrans.rot)) * XMMatrixTranslationFromVector(XMLoadFloat3(&cTrans.pos));
+	XMStoreFloat4x4(&cTrans.mxlocal, mxmodel);
+	registry->markChanged<CTransform>(entityCntlPivot);
+}
+
+
+void GameplaySystem::raycastPick(const int sx, const int sy, XMFLOAT4X4 mproj, XMFLOAT4X4 mview) {
+	// Compute picking ray in view space.
+	float vx = (2.0f * sx / mWndWidth - 1.0f) / mproj(0, 0);
+	float vy = (-2.0f * sy / mWndHeight + 1.0f) / mproj(1, 1);
+
+	// Ray definition in view space.
+	XMVECTOR rayOrigin = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
+	XMVECTOR rayDir = XMVectorSet(vx, vy, 1.0f, 0.0f);
+
+	XMMATRIX xmview = XMLoadFloat4x4(&mview);
+	auto xmviewDet = XMMatrixDeterminant(xmview);
+	XMMATRIX invView = XMMatrixInverse(&xmviewDet, xmview);
+
+	// pieces in the middle of a turn are not where their box says
+	for (auto& e : registry->getQueryEntities(queryPickable)) {
+		auto& cbbox = view.get<CBoundingBox>(e);
+		auto& ctrans = view.get<CTransform>(e);
+
+		XMMATRIX xmmodel = XMLoadFloat4x4(&ctrans.mxmodel);
+		auto xmmodelDet = XMMatrixDeterminant(xmmodel);
+		XMMATRIX invModel = XMMatrixInverse(&xmmodelDet, xmmodel);
+
+		// convert ray to local space of the model
+		XMMATRIX toLocal = XMMatrixMultiply(invView, invModel);
+
+		rayOrigin = XMVector3TransformCoord(rayOrigin, toLocal);
+		rayDir = XMVector3TransformNormal(rayDir, toLocal);
+
+		// normalize to get true direction
+		rayDir = XMVector3Normalize(rayDir);
+
+
+		float rayDist = 150.f;
+		if (cbbox.obb.Intersects(rayOrigin, rayDir, rayDist)) {
+			LOG_DEBUG(Gameplay, "ray hit piece %u", e);
+		}
+
+	}
+
 }
\ No newline at end of file
@@ -1,52 +1,94 @@
-#pragma once
-#include "stdafx.h"
-#include "Registry.h"
-
-#include <vector>
-#include <map>
-#include <queue>
-
-class GameplaySystem {
-public:
-	GameplaySystem();
-	void onInit(std::shared_ptr<Registry> registry, int mWndWidth, int mWndHeight);
-	bool onUpdate(const float& deltaTime);
-	void onReset();
-	void onShuffle();
-
-	void processInputCmd(const std::string strcmd);
-	void raycastPick(const int sx, const int sy, XMFLOAT4X4 mproj, XMFLOAT4X4 mview);
-
-	std::vector<std::string> cubeNotations;
-
-private:
-
-	void rotateCubeSide(std::string notation);														// rotate cube
-
-	void storeEntities();
-	void createCubeNotations();
-	void setPieceEntityPivot(const char axis, const float cmpPos);
-	void setPieceEntityPivotMiddle(const char axis);
-	void setPieceEntityPivotDouble(const char axis, const float cmpPos);
-	void setPieceEntityPivotAll();
-	void resetCentralPivot();
-
-	std::shared_ptr<Registry> registry;
-	int mWndWidth, mWndHeight;
-
-	bool cubeRotInMotion, rotTargetReached;
-	XMFLOAT3 rotationTarget;
-
-	UINT entityCntlPivot;													//Central pivot entity
-	std::vector<UINT> entitiesFace;										//CFace face mesh entities
-	std::vector<UINT> entitiesPiece;										//CPiece piece mesh entities
-	std::vector<UINT> entitiesPiecesInRot;									// pieces that rotate around pivot
-
-	std::map<UINT, std::vector<XMFLOAT3>> faceDirPositions;
-
-	std::queue<std::string> queueCmd;
-	XMFLOAT3 rotVelocity, currRotation;
-
-};
-
-
+#pragma once
+#include "stdafx.h"
+#include "Components.h"
+#include "Registry.h"
+#include "HierarchySystem.h"
+#include "CommandBuffer.h"
+#include "CubeModel.h"
+#include "CubeModelNxN.h"
+#include "Notation.h"
+#include "TwoPhaseSolver.h"
+#include "Scrambler.h"
+
+#include <vector>
+#include <queue>
+#include <future>
+
+class GameplaySystem {
+public:
+	GameplaySystem();
+	void onInit(std::shared_ptr<Registry> registry, HierarchySystem* hierarchySystem, CommandBuffers* commandBuffers, int mWndWidth,
+		int mWndHeight, uint16_t cubeSize = 3);
+	bool onUpdate(const float& deltaTime);
+	void onReset();
+	void onShuffle(const Scrambler& scrambler);								// 3x3 scrambles are generated in the background
+	bool isShuffling() const;												// a scramble is being generated, it is queued when it is done
+	void onSolve(const TwoPhaseSolver& solver);								// solve the current state in the background, 3x3 only
+	bool isSolving() const;													// a solve is running, its moves are queued when it is done
+	bool isSolved() const;
+	const CubeModelNxN& getCube() const;
+
+	void processInputCmd(const std::string strcmd);
+	void queueMove(const LayerMove& move);
+	void raycastPick(const int sx, const int sy, XMFLOAT4X4 mproj, XMFLOAT4X4 mview);
+
+	std::vector<Move> cubeMoves;											// moves on the interface buttons
+
+private:
+
+	void rotateCubeSide(const LayerMove& move);											// rotate cube
+
+	void storeEntities();
+	void createCubeNotations();
+	void setPieceEntityPivot(const LayerTurn& turn);
+	void paintFace(UINT eface);
+	void resetCentralPivot();
+	void pollScramble();
+	void pollSolve();
+
+	std::shared_ptr<Registry> registry;
+	HierarchySystem* hierarchySystem;											// reparents pieces to the pivot and back
+	CommandBuffers* commandBuffers;												// CTurning tags, applied after the systems ran
+	View<CTransform, CHierarchy, CDraw, CBoundingBox> view;						// pools resolved once in onInit
+	int mWndWidth, mWndHeight;
+
+	bool cubeRotInMotion, rotTargetReached;
+	XMFLOAT3 rotationTarget;
+
+	UINT entityCntlPivot;													//Central pivot entity
+	QueryID queryFace;														//CFace face mesh entities
+	QueryID queryPiece;														//CPiece piece mesh entities
+	QueryID queryPickable;													// pieces that are not turning
+	std::vector<UINT> entitiesPiecesInRot;									// pieces that rotate around pivot
+
+	// pieces never leave their home slot for longer than a turn animation, the cube model holds the actual state
+	struct PieceSlot {
+		UINT entity;
+		int position[3];														// layer on each axis, 0 on the negative side
+		XMFLOAT4X4 mxhome;														// local matrix in the slot
+	};
+
+	CubeModelNxN cube;
+	LayerTurn currentTurn;													// turn being animated
+	std::vector<PieceSlot> pieceSlots;
+	std::vector<UINT> slotsInLayer[3];										// slots sorted by layer on each axis, so a turn only visits its own pieces
+	std::vector<UINT> layerStart[3];										// layer l of an axis in slotsInLayer[axis][layerStart[axis][l]..[l + 1])
+	std::vector<UINT> pieceSlotOfEntity;										// entity index -> index into pieceSlots
+	std::vector<uint16_t> faceletOfEntity;										// entity index -> facelet shown by that face
+
+	std::queue<LayerMove> queueCmd;
+
+	// the running solve and the state it started from, the solution is dropped if the cube moved in the meantime
+	struct SolveResult {
+		bool solved;
+		std::vector<Move> moves;
+	};
+	std::future<SolveResult> pendingSolve;
+	std::future<std::vector<Move>> pendingScramble;
+	CubeModel solveState;
+	Random random;															// seeded once, shuffles draw from it
+	XMFLOAT3 rotVelocity, currRotation;
+
+};
+
+
@@ -0,0 +1,264 @@
+#include "HierarchySystem.h"
+#include "Helper.h"
+
+#include <algorithm>
+
+using namespace DirectX;
+
+
+void HierarchySystem::onInit(std::shared_ptr<Registry> registry) {
+	this->registry = registry;
+	this->view = registry->getView<CTransform, CHierarchy>();
+	queryNodes = registry->registerQuery(registry->getSignature<CTransform, CHierarchy>());
+
+	rebuild();
+	lastTick = registry->getTick();
+}
+
+
+void HierarchySystem::rebuild() {
+	// every entity with both components is a node. entityParent is the source of truth: a parent that is not a node (any
+	// more) makes the entity a root, and the child lists drop stale entries and gain children created since the last build
+	auto& entities = registry->getQueryEntities(queryNodes);
+	nodes.clear();
+	std::fill(nodeOfEntity.begin(), nodeOfEntity.end(), InvalidIndex);
+	for (auto e : entities) {
+		if (entityIndex(e) >= nodeOfEntity.size())
+			nodeOfEntity.resize(entityIndex(e) + 1, InvalidIndex);
+		nodeOfEntity[entityIndex(e)] = static_cast<UINT>(nodes.size());
+		nodes.push_back({ e, InvalidIndex, 0, view.get<CTransform>(e).mxlocal });
+	}
+
+	for (auto e : entities) {
+		auto& cHrchy = view.get<CHierarchy>(e);
+		if (findNode(cHrchy.entityParent) == InvalidIndex)
+			cHrchy.entityParent = NullEntity;
+	}
+	std::vector<uint8_t> listed(nodes.size(), 0);
+	for (auto e : entities) {
+		auto& children = view.get<CHierarchy>(e).childEntities;
+		children.erase(std::remove_if(children.begin(), children.end(), [&](UINT child) {
+			UINT node = findNode(child);
+			if (node == InvalidIndex || listed[node] || view.get<CHierarchy>(child).entityParent != e)
+				return true;
+			listed[node] = 1;
+			return false;
+		}), children.end());
+	}
+	for (auto e : entities) {
+		UINT parent = view.get<CHierarchy>(e).entityParent;
+		if (parent != NullEntity && !listed[findNode(e)])
+			view.get<CHierarchy>(parent).childEntities.push_back(e);
+	}
+
+	// depth from the parent chain, only done here. setParent keeps it up to date afterwards
+	for (auto& node : nodes) {
+		for (UINT p = view.get<CHierarchy>(node.entity).entityParent; p != NullEntity; p = view.get<CHierarchy>(p).entityParent)
+			node.depth++;
+	}
+
+	// where each child sits in its parent's list, so setParent can unlink it without a search
+	for (auto e : entities) {
+		auto& children = view.get<CHierarchy>(e).childEntities;
+		for (UINT k = 0; k < children.size(); k++) {
+			if (entityIndex(children[k]) >= childSlotOfEntity.size())
+				childSlotOfEntity.resize(entityIndex(children[k]) + 1, InvalidIndex);
+			childSlotOfEntity[entityIndex(children[k])] = k;
+		}
+	}
+	nodePass.assign(nodes.size(), 0);
+	stack.reserve(nodes.size());
+	sortNodes();
+
+	// parents sit before their children, so one pass front to back computes every world matrix
+	pass++;
+	for (UINT i = 0; i < nodes.size(); i++)
+		updateNode(i);
+
+	transformVersion = view.pool<CTransform>().structureVersion;
+	hierarchyVersion = view.pool<CHierarchy>().structureVersion;
+}
+
+
+bool HierarchySystem::syncNodes() {
+	// true when the nodes had to be rebuilt, which also recomputed every world matrix
+	if (view.pool<CTransform>().structureVersion == transformVersion && view.pool<CHierarchy>().structureVersion == hierarchyVersion)
+		return false;
+	rebuild();
+	return true;
+}
+
+
+UINT HierarchySystem::findNode(UINT entity) const {
+	if (entity == NullEntity || entityIndex(entity) >= nodeOfEntity.size())
+		return InvalidIndex;
+	UINT node = nodeOfEntity[entityIndex(entity)];
+	return node != InvalidIndex && nodes[node].entity == entity ? node : InvalidIndex;
+}
+
+
+void HierarchySystem::onUpdate() {
+	if (syncNodes()) {
+		lastTick = registry->getTick();
+		return;
+	}
+
+	// nodes whose local matrix or parent changed since the last pass, in depth order. a changed parent comes before its
+	// changed children and its subtree walk covers them, so every node is recomputed at most once
+	changed.clear();
+	registry->getChanged<CTransform>(lastTick, changed);
+	registry->getChanged<CHierarchy>(lastTick, changed);
+
+	dirtyNodes.clear();
+	for (auto e : changed) {
+		UINT node = findNode(e);
+		if (node != InvalidIndex)
+			dirtyNodes.push_back(node);
+	}
+	std::sort(dirtyNodes.begin(), dirtyNodes.end());
+
+	pass++;
+	for (auto node : dirtyNodes) {
+		if (nodePass[node] == pass)
+			continue;
+
+		updateNode(node);
+		stack.push_back(nodes[node].entity);
+		while (!stack.empty()) {
+			UINT e = stack.back();
+			stack.pop_back();
+			for (auto child : view.get<CHierarchy>(e).childEntities) {
+				updateNode(nodeOfEntity[entityIndex(child)]);
+				stack.push_back(child);
+			}
+		}
+	}
+
+	lastTick = registry->getTick();
+}
+
+
+void HierarchySystem::updateNode(UINT i) {
+	auto& node = nodes[i];
+	auto& cTransform = view.get<CTransform>(node.entity);
+	XMMATRIX mxworld = XMLoadFloat4x4(&cTransform.mxlocal);
+	if (node.parent != InvalidIndex)
+		mxworld = mxworld * XMLoadFloat4x4(&nodes[node.parent].mxworld);			// final position = local mat * parent mat
+
+	XMStoreFloat4x4(&node.mxworld, mxworld);
+	cTransform.mxmodel = node.mxworld;
+
+	// third row is the z axis of the object in world space, normalized since pieces of big cubes are scaled down
+	XMFLOAT3 forward;
+	XMStoreFloat3(&forward, XMVector3Normalize(mxworld.r[2]));
+	cTransform.forward = XMFLOAT3(
+		roundoff(forward.x, 1.f),
+		roundoff(forward.y, 1.f),
+		roundoff(forward.z, 1.f));
+
+	registry->markChanged<CTransform>(node.entity);
+	nodePass[i] = pass;
+}
+
+
+void HierarchySystem::setParent(UINT entity, UINT parent) {
+	// entities created since the last update get their nodes first. both ends have to be nodes
+	syncNodes();
+	if (findNode(entity) == InvalidIndex || (parent != NullEntity && findNode(parent) == InvalidIndex))
+		return;
+
+	auto& cHrchy = view.get<CHierarchy>(entity);
+	if (cHrchy.entityParent == parent)
+		return;
+
+	// keep the child lists of both parents in sync. the last child takes the place of the removed one
+	if (cHrchy.entityParent != NullEntity) {
+		auto& siblings = view.get<CHierarchy>(cHrchy.entityParent).childEntities;
+		UINT slot = childSlotOfEntity[entityIndex(entity)];
+		siblings[slot] = siblings.back();
+		childSlotOfEntity[entityIndex(siblings[slot])] = slot;
+		siblings.pop_back();
+	}
+	if (parent != NullEntity) {
+		auto& children = view.get<CHierarchy>(parent).childEntities;
+		childSlotOfEntity[entityIndex(entity)] = static_cast<UINT>(children.size());
+		children.push_back(entity);
+	}
+
+	cHrchy.entityParent = parent;
+	registry->markChanged<CHierarchy>(entity);
+
+	// move the subtree to its new depths, parents first so every child lands below its parent again
+	UINT depth = parent == NullEntity ? 0 : nodes[nodeOfEntity[entityIndex(parent)]].depth + 1;
+	moveToDepth(nodeOfEntity[entityIndex(entity)], depth);
+	nodes[nodeOfEntity[entityIndex(entity)]].parent = parent == NullEntity ? InvalidIndex : nodeOfEntity[entityIndex(parent)];
+
+	stack.push_back(entity);
+	while (!stack.empty()) {
+		UINT e = stack.back();
+		stack.pop_back();
+
+		UINT childDepth = nodes[nodeOfEntity[entityIndex(e)]].depth + 1;
+		for (auto child : view.get<CHierarchy>(e).childEntities) {
+			moveToDepth(nodeOfEntity[entityIndex(child)], childDepth);
+			stack.push_back(child);
+		}
+	}
+}
+
+
+void HierarchySystem::moveToDepth(UINT node, UINT depth) {
+	// one swap per level: going deeper the node trades places with the last node of its range and the next range grows
+	// down over it, going up it trades with the first node and its range shrinks past it
+	if (depth + 2 > depthStart.size())
+		depthStart.resize(depth + 2, static_cast<UINT>(nodes.size()));
+
+	UINT d = nodes[node].depth;
+	for (; d < depth; d++) {
+		UINT last = --depthStart[d + 1];
+		swapNodes(node, last);
+		node = last;
+	}
+	for (; d > depth; d--) {
+		UINT first = depthStart[d]++;
+		swapNodes(node, first);
+		node = first;
+	}
+	nodes[node].depth = depth;
+}
+
+
+void HierarchySystem::swapNodes(UINT a, UINT b) {
+	if (a == b)
+		return;
+
+	std::swap(nodes[a], nodes[b]);
+	nodeOfEntity[entityIndex(nodes[a].entity)] = a;
+	nodeOfEntity[entityIndex(nodes[b].entity)] = b;
+
+	// the children of both hold the node index of their parent
+	for (auto child : view.get<CHierarchy>(nodes[a].entity).childEntities)
+		nodes[nodeOfEntity[entityIndex(child)]].parent = a;
+	for (auto child : view.get<CHierarchy>(nodes[b].entity).childEntities)
+		nodes[nodeOfEntity[entityIndex(child)]].parent = b;
+}
+
+
+void HierarchySystem::sortNodes() {
+	// full sort by depth, only done in rebuild. setParent keeps the ranges up to date afterwards
+	std::stable_sort(nodes.begin(), nodes.end(), [](const Node& a, const Node& b) { return a.depth < b.depth; });
+
+	UINT maxDepth = nodes.empty() ? 0 : nodes.back().depth;
+	depthStart.assign(maxDepth + 2, 0);
+	for (auto& node : nodes)
+		depthStart[node.depth + 1]++;
+	for (UINT d = 0; d <= maxDepth; d++)
+		depthStart[d + 1] += depthStart[d];
+
+	for (UINT i = 0; i < nodes.size(); i++)
+		nodeOfEntity[entityIndex(nodes[i].entity)] = i;
+	for (auto& node : nodes) {
+		UINT entityParent = view.get<CHierarchy>(node.entity).entityParent;
+		node.parent = entityParent != NullEntity ? nodeOfEntity[entityIndex(entityParent)] : InvalidIndex;
+	}
+}
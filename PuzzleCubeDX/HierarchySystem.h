@@ -0,0 +1,54 @@
+#pragma once
+#include "stdafx.h"
+#include "Components.h"
+#include "Registry.h"
+
+
+// keeps every entity with CTransform and CHierarchy in one flat array grouped by depth, each node holding the index of its
+// parent node and its world matrix. parents always sit before their children, so world matrices for any depth are
+// computed front to back. each update only walks the subtrees under nodes whose transform or parent changed since the
+// last one. order inside a depth range does not matter, so reparenting moves each node of the subtree across the range
+// boundaries with one swap per level and only fixes up the nodes that were swapped. entities that gain or lose a
+// CTransform or CHierarchy after onInit (eg. through a CommandBuffer or destroyEntity) make the next update rebuild the
+// nodes from scratch
+class HierarchySystem {
+public:
+	void onInit(std::shared_ptr<Registry> registry);
+	void onUpdate();
+
+	// attach entity with its subtree to parent, NullEntity makes it a root. the local matrix is kept as it is
+	void setParent(UINT entity, UINT parent);
+
+private:
+	struct Node {
+		UINT entity;
+		UINT parent;															// node index of the parent, InvalidIndex for roots
+		UINT depth;
+		XMFLOAT4X4 mxworld;
+	};
+
+	void rebuild();
+	bool syncNodes();
+	UINT findNode(UINT entity) const;
+	void sortNodes();
+	void updateNode(UINT node);
+	void moveToDepth(UINT node, UINT depth);
+	void swapNodes(UINT a, UINT b);
+
+	std::shared_ptr<Registry> registry;
+	View<CTransform, CHierarchy> view;											// pools resolved once in onInit
+	QueryID queryNodes = 0;
+	UINT transformVersion = 0;													// pool structure versions the nodes were built from
+	UINT hierarchyVersion = 0;
+
+	std::vector<Node> nodes;													// sorted by depth
+	std::vector<UINT> depthStart;												// depth d in nodes[depthStart[d]..depthStart[d + 1])
+	std::vector<UINT> nodeOfEntity;												// entity index -> node index
+	std::vector<UINT> childSlotOfEntity;										// entity index -> position in its parent's childEntities
+	std::vector<UINT> nodePass;													// pass in which each node was last recomputed
+	std::vector<UINT> changed;													// scratch, entities changed since the last pass
+	std::vector<UINT> dirtyNodes;												// scratch, their nodes in depth order
+	std::vector<UINT> stack;													// scratch for walking subtrees
+	UINT pass = 0;
+	UINT lastTick = 0;															// registry tick of the last onUpdate
+};
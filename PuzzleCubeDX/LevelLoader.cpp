@@ -1,289 +1,272 @@
-#include "LevelLoader.h"
-#include <iostream>
-
-#ifndef TINYOBJLOADER_IMPLEMENTATION
-#define TINYOBJLOADER_IMPLEMENTATION
-#endif
-#include "tiny_obj_loader.h"
-
-
-// cubes have 0.5 edge lengths
-XMFLOAT3 centerPiecesLoc[]{
-	{0.f, 0.f, 0.5f},						
-	{0.5f, 0.f, 0.f},						
-	{0.f, 0.f, -0.5f},						
-	{-0.5f, 0.f, 0.f},					
-	{0.f, 0.5f, 0.f},						
-	{0.f, -0.5f, 0.f}
-};
-XMFLOAT3 centerPiecesRot[]{
-	{0.f, 0.f, 0.f},
-	{0.f, XM_PIDIV2, 0.f},
-	{0.f, XM_PI, 0.f},
-	{0.f, XM_PI + XM_PIDIV2, 0.f},
-	{XM_PI + XM_PIDIV2, 0.f, 0.f},
-	{XM_PIDIV2, 0.f, 0.f}
-};
-
-XMFLOAT3 cornerPiecesLoc[]{
-	{-0.5f, 0.5f, 0.5f},
-	{-0.5f, -0.5f, 0.5f},
-	{0.5f, -0.5f, 0.5f},
-	{0.5f, 0.5f, 0.5f},
-
-	{-0.5f, 0.5f, -0.5f},
-	{-0.5f, -0.5f, -0.5f},
-	{0.5f, -0.5f, -0.5f},
-	{0.5f, 0.5f, -0.5f}
-};
-XMFLOAT3 cornerPiecesRot[]{
-	{0.f, 0.f, 0.f},
-	{0.f, 0.f, XM_PIDIV2},
-	{0.f, 0.f, XM_PI},
-	{0.f, 0.f, XM_PI + XM_PIDIV2},
-
-	{0.f, XM_PI + XM_PIDIV2, 0.f},
-	{0.f, XM_PI + XM_PIDIV2, XM_PIDIV2},
-	{0.f, XM_PIDIV2, XM_PI},
-	{0.f, XM_PIDIV2, XM_PI + XM_PIDIV2}
-};
-
-XMFLOAT3 crossPiecesLoc[]{
-	{0.f, 0.5f, 0.5f},
-	{-0.5f, 0.f, 0.5f},
-	{0.f, -0.5f, 0.5f},
-	{0.5f, 0.f, 0.5f},
-
-	{0.f, 0.5f, -0.5f},
-	{-0.5f, 0.f, -0.5f},
-	{0.f, -0.5f, -0.5f},
-	{0.5f, 0.f, -0.5f},
-
-	{-0.5f, 0.5f, 0.f},
-	{0.5f, 0.5f, 0.f},
-	{-0.5f, -0.5f, 0.f},
-	{0.5f, -0.5f, 0.f},
-
-};
-
-XMFLOAT3 crossPiecesRot[]{
-	{0.f, 0.f, 0.f},
-	{0.f, 0.f, XM_PIDIV2},
-	{0.f, 0.f, XM_PI},
-	{0.f, 0.f, XM_PI + XM_PIDIV2},
-
-	{0.f, XM_PI, 0.f},
-	{0.f, XM_PIDIV2 + XM_PI, XM_PIDIV2},
-	{0.f, XM_PI, XM_PI},
-	{0.f, XM_PIDIV2, XM_PI + XM_PIDIV2},
-
-	{0.f, XM_PIDIV2 + XM_PI, 0.f},
-	{0.f, XM_PIDIV2, 0.f},
-	{0.f, XM_PIDIV2 + XM_PI, XM_PI},
-	{0.f, XM_PIDIV2, XM_PI},
-
-};
-
-void LevelLoader::loadLevel(std::shared_ptr<Registry> registry) {
-	// construct the cube
-	this->registry = registry;
-
-	createEntities();
-	assembleLevel();
-}
-
-
-void LevelLoader::assembleLevel() {
-	UINT i = 0;
-	for (auto& e : entitiesPieces[PieceType::PIECE_CORNER]) {
-		auto& ctrans = registry->getComponent<CTransform>(e);
-		ctrans.pos = cornerPiecesLoc[i];
-		ctrans.rot = cornerPiecesRot[i];
-
-		// create local space matrices
-		// model matrix = scale * rot * trans
-		XMStoreFloat4x4(
-			&ctrans.mxlocal, 
-			XMMatrixRotationRollPitchYawFromVector(XMLoadFloat3(&ctrans.rot)) * XMMatrixTranslationFromVector(XMLoadFloat3(&ctrans.pos)));
-		i++;
-	}
-	i = 0;
-	for (auto& e : entitiesPieces[PieceType::PIECE_CENTER]) {
-		auto& ctrans = registry->getComponent<CTransform>(e);
-		ctrans.pos = centerPiecesLoc[i];
-		ctrans.rot = centerPiecesRot[i];
-		XMStoreFloat4x4(
-			&ctrans.mxlocal,
-			XMMatrixRotationRollPitchYawFromVector(XMLoadFloat3(&ctrans.rot)) * XMMatrixTranslationFromVector(XMLoadFloat3(&ctrans.pos)));
-		i++;
-	}
-	i = 0;
-	for (auto& e : entitiesPieces[PieceType::PIECE_CROSS]) {
-		auto& ctrans = registry->getComponent<CTransform>(e);
-		ctrans.pos = crossPiecesLoc[i];
-		ctrans.rot = crossPiecesRot[i];
-		XMStoreFloat4x4(
-			&ctrans.mxlocal,
-			XMMatrixRotationRollPitchYawFromVector(XMLoadFloat3(&ctrans.rot)) * XMMatrixTranslationFromVector(XMLoadFloat3(&ctrans.pos)));
-		i++;
-	}
-}
-
-
-void LevelLoader::createEntities() {
-	// load pivots
-	auto e = registry->createEntity();
-	registry->addComponent<CCentralPivot>(e);
-	registry->addComponent<CTransform>(e);
-
-	for (int i = 0; i < 6; i++) {
-		e = registry->createEntity();
-		registry->addComponent<CPivot>(e);
-		auto& transform = registry->addComponent<CTransform>(e);
-	}
-
-	// load pieces and thier faces
-	for (int i = 0; i < 8; i++)
-		createPieceEntity(PieceType::PIECE_CORNER);
-	for (int i = 0; i < 6; i++)
-		createPieceEntity(PieceType::PIECE_CENTER);
-	for (int i = 0; i < 12; i++)
-		createPieceEntity(PieceType::PIECE_CROSS);
-	
-}
-
-void LevelLoader::createPieceEntity(PieceType pieceType) {
-	// create pieces and faces without any world space translation. that comes later when assembling the cube
-	auto ePiece = registry->createEntity();
-	auto& hierrPiece = registry->addComponent<CHierarchy>(ePiece);									// each piece has multiple child faces entities in its heirarchy
-	registry->addComponent<CPiece>(ePiece);
-	registry->addComponent<CTransform>(ePiece);
-	CDraw& cdraw = setEntityDraw(ePiece, "Piece.obj", true);
-	cdraw.colorIndex = 6;														// 7th color is the piece color
-
-
-	switch (pieceType) {
-	case PieceType::PIECE_CENTER:
-	{
-
-		hierrPiece.childEntities.push_back(
-			createFaceEntity(ePiece, "Face_center.obj", XMFLOAT3(0.f, 0.f, 0.25f))
-		);
-	}
-
-		break;
-	case PieceType::PIECE_CROSS:
-	{
-			// 2 faces on cross, back and top
-		hierrPiece.childEntities.push_back(
-			createFaceEntity(ePiece, "Face_cross.obj", XMFLOAT3(0.f, 0.f, 0.25f))
-		);
-		hierrPiece.childEntities.push_back(
-			createFaceEntity(ePiece, "Face_cross.obj", XMFLOAT3(0.f, 0.25f, 0.f), XMFLOAT3(XM_PIDIV2 + XM_PI, 0.f, XM_PI))
-		);
-	}
-
-		break;
-
-	case PieceType::PIECE_CORNER:
-	{
-		// 3 faces on cross, back and left
-		hierrPiece.childEntities.push_back(
-			createFaceEntity(ePiece, "Face_corner.obj", XMFLOAT3(0.f, 0.f, 0.25f))			// front center, facing the back of piece since forward vector will be 0,0,1
-		);
-		hierrPiece.childEntities.push_back(
-			createFaceEntity(ePiece, "Face_corner.obj", XMFLOAT3(0.f, 0.25f, 0.f), XMFLOAT3(XM_PIDIV2 + XM_PI, 0.f, 0.f))	// top
-		);
-		hierrPiece.childEntities.push_back(
-			createFaceEntity(ePiece, "Face_corner.obj", XMFLOAT3(-0.25f, 0.f, 0.f), XMFLOAT3(0.f, -XM_PIDIV2, 0.f))    // left
-		);
-	}
-		break;
-	}
-
-
-	// store for cube assembly later
-	entitiesPieces[pieceType].push_back(ePiece);
-}
-
-UINT LevelLoader::createFaceEntity(const UINT ePiece, std::string strModelFile, XMFLOAT3 translation, XMFLOAT3 rot) {
-	auto eface = registry->createEntity();
-	registry->addComponent<CFace>(eface);
-	auto& ctrans = registry->addComponent<CTransform>(eface);
-	ctrans.pos = translation;										// front center, facing the back of piecesince forward vector will be 0,0,1
-	ctrans.rot = rot;
-
-	XMStoreFloat4x4(
-		&ctrans.mxlocal,
-		XMMatrixRotationRollPitchYawFromVector(XMLoadFloat3(&ctrans.rot)) * XMMatrixTranslationFromVector(XMLoadFloat3(&translation)));
-
-	registry->addComponent<CHierarchy>(eface, ePiece);
-	setEntityDraw(eface, strModelFile);
-
-	return eface;
-}
-
-
-CDraw& LevelLoader::setEntityDraw(UINT& entity, std::string strFilename, bool createOBB) {
-	// store data from obj file in map and use it again if already loaded instead of loading model again 
-	if (mapModelData.find(strFilename) == mapModelData.end()) {
-	
-		tinyobj::ObjReaderConfig readerConfig;
-		readerConfig.mtl_search_path = "./";
-		readerConfig.triangulate = true;
-		tinyobj::ObjReader reader;
-		
-		//TODO: these error messages
-		std::string strFilePath = "./Assets/" + strFilename;
-		if (!reader.ParseFromFile(strFilePath, readerConfig)) {
-			if (!reader.Error().empty()) {
-				std::cerr << "TinyObjReader: " << reader.Error() << std::endl;
-			}
-		}
-		if (!reader.Warning().empty()) {
-			std::cerr << "TinyObjReader: " << reader.Warning() << std::endl;
-		}
-
-		auto& attrib = reader.GetAttrib();
-		auto& shapes = reader.GetShapes();
-		
-		// only processing and sending position data to shader for now. not processing normals
-		mapModelData[strFilename].vertexData = attrib.vertices;		
-		for (size_t s = 0; s < shapes.size(); s++) {
-			std::vector<uint16_t> indices;
-			for(auto& index : shapes[s].mesh.indices)
-				indices.push_back(index.vertex_index);
-			mapModelData[strFilename].indexData.insert(mapModelData[strFilename].indexData.end(), indices.begin(), indices.end());
-		}
-	}
-
-	vertBuffData.insert(vertBuffData.end(), mapModelData[strFilename].vertexData.begin(), mapModelData[strFilename].vertexData.end());
-	indexBuffData.insert(indexBuffData.end(), mapModelData[strFilename].indexData.begin(), mapModelData[strFilename].indexData.end());
-
-	// add draw comp to the currently held entity
-	CDraw& cdraw = registry->addComponent<CDraw>(entity, drawIndex++, baseVertex, startIndex, mapModelData[strFilename].indexData.size());
-
-	// bounding box only for pieces
-	if (createOBB) {
-		auto& vertexData = mapModelData[strFilename].vertexData;
-		auto numvertices = vertexData.size();
-		std::vector<XMFLOAT3> xmvertexData;										// vertex data in xmfloat3 format for bounding box
-		for (int i = 0; i < numvertices; i+=3) {
-			xmvertexData.push_back(XMFLOAT3(vertexData[i], vertexData[i + 1], vertexData[i + 2]));
-		}
-
-		auto& cbb = registry->addComponent<CBoundingBox>(entity);
-		BoundingOrientedBox::CreateFromPoints(cbb.obb, xmvertexData.size(), xmvertexData.data(), sizeof(XMFLOAT3));
-		
-		auto center = cbb.obb.Extents;
-
-	}
-
-
-	// baseVertex will require num vertices. vertexData is full float sequence of x,y,z. To get num vertices, vertexData / 3 (3 = float3(x,y,z)) 
-	baseVertex += (mapModelData[strFilename].vertexData.size() / 3.f);
-	startIndex += mapModelData[strFilename].indexData.size();
-	
-
-	return cdraw;
-}
+#include "LevelLoader.h"
+#include "Log.h"
+#include "MeshCache.h"
+
+#ifndef TINYOBJLOADER_IMPLEMENTATION
+#define TINYOBJLOADER_IMPLEMENTATION
+#endif
+#include "tiny_obj_loader.h"
+
+#include <algorithm>
+
+
+void LevelLoader::loadLevel(std::shared_ptr<Registry> registry, uint16_t cubeSize) {
+	// construct the cube
+	this->registry = registry;
+	this->cubeSize = std::min(std::max(cubeSize, MinCubeSize), MaxCubeSize);
+
+	createEntities();
+}
+
+
+void LevelLoader::createEntities() {
+	// load pivots
+	auto e = registry->createEntity();
+	registry->addComponent<CCentralPivot>(e);
+	registry->addComponent<CTransform>(e);
+	registry->addComponent<CHierarchy>(e);										// root of the pieces while they rotate
+
+	for (int i = 0; i < 6; i++) {
+		e = registry->createEntity();
+		registry->addComponent<CPivot>(e);
+		auto& transform = registry->addComponent<CTransform>(e);
+	}
+
+	// load pieces and thier faces, one on every grid position of the surface. the inside of the cube stays empty
+	int n = cubeSize;
+	for (int x = 0; x < n; x++) {
+		for (int y = 0; y < n; y++) {
+			for (int z = 0; z < n; z++) {
+				bool inner = x > 0 && x < n - 1 && y > 0 && y < n - 1 && z > 0 && z < n - 1;
+				if (inner)
+					continue;
+				int position[3] = { x, y, z };
+				createPieceEntity(position);
+			}
+		}
+	}
+}
+
+void LevelLoader::createPieceEntity(const int position[3]) {
+	auto ePiece = registry->createEntity();
+	auto& chierarchy = registry->addComponent<CHierarchy>(ePiece);				// each piece has multiple child faces entities in its heirarchy
+	auto& cpiece = registry->addComponent<CPiece>(ePiece);
+	for (int k = 0; k < 3; k++)
+		cpiece.position[k] = position[k];
+	auto& ctrans = registry->addComponent<CTransform>(ePiece);
+	CDraw& cdraw = setEntityDraw(ePiece, "Piece.obj", true);
+	cdraw.colorIndex = 6;														// 7th color is the piece color
+
+	// outward normals of the sides this piece shows, taken in z x y order. the piece meshes have their faces on local
+	// +z, +y and -x, the rotation below lines those up with the normals
+	XMFLOAT3 normals[3];
+	int numNormals = 0;
+	for (int axis : { 2, 0, 1 }) {
+		if (position[axis] != 0 && position[axis] != cubeSize - 1)
+			continue;
+		float sign = position[axis] == 0 ? -1.f : 1.f;
+		normals[numNormals++] = XMFLOAT3(axis == 0 ? sign : 0.f, axis == 1 ? sign : 0.f, axis == 2 ? sign : 0.f);
+	}
+
+	XMVECTOR front = XMLoadFloat3(&normals[0]), top = XMVectorSet(0.f, 1.f, 0.f, 0.f);
+	PieceType pieceType = numNormals == 3 ? PieceType::PIECE_CORNER : numNormals == 2 ? PieceType::PIECE_CROSS : PieceType::PIECE_CENTER;
+	switch (pieceType) {
+	case PieceType::PIECE_CENTER:
+		// up or down facing centers keep the back edge on top
+		if (normals[0].y != 0.f)
+			top = XMVectorSet(0.f, 0.f, -normals[0].y, 0.f);
+		break;
+	case PieceType::PIECE_CROSS:
+		top = XMLoadFloat3(&normals[1]);
+		break;
+	case PieceType::PIECE_CORNER:
+		// local left is front x top, which picks the one of the two remaining normals that keeps the rotation proper
+		top = XMLoadFloat3(&normals[1]);
+		if (XMVector3NotEqual(XMVector3Cross(front, top), XMLoadFloat3(&normals[2])))
+			top = XMLoadFloat3(&normals[2]);
+		break;
+	default:
+		break;
+	}
+
+	// rows are where local x, y and z end up
+	XMMATRIX mxrot = XMMatrixIdentity();
+	mxrot.r[0] = XMVector3Cross(top, front);
+	mxrot.r[1] = top;
+	mxrot.r[2] = front;
+
+	// the whole cube keeps the size of the 3x3, pieces at 0.5 spacing scaled down by 3 / size
+	float spacing = 1.5f / cubeSize;
+	float half = (cubeSize - 1) / 2.f;
+	ctrans.pos = XMFLOAT3((position[0] - half) * spacing, (position[1] - half) * spacing, (position[2] - half) * spacing);
+
+	// model matrix = scale * rot * trans
+	XMStoreFloat4x4(
+		&ctrans.mxlocal,
+		XMMatrixScaling(3.f / cubeSize, 3.f / cubeSize, 3.f / cubeSize) * mxrot * XMMatrixTranslationFromVector(XMLoadFloat3(&ctrans.pos)));
+
+	// the pools grow in chunks and never move a component, so chierarchy stays valid while the faces add theirs
+	switch (pieceType) {
+	case PieceType::PIECE_CENTER:
+	{
+
+		chierarchy.childEntities.push_back(
+			createFaceEntity(ePiece, "Face_center.obj", XMFLOAT3(0.f, 0.f, 0.25f))
+		);
+	}
+
+		break;
+	case PieceType::PIECE_CROSS:
+	{
+			// 2 faces on cross, back and top
+		chierarchy.childEntities.push_back(
+			createFaceEntity(ePiece, "Face_cross.obj", XMFLOAT3(0.f, 0.f, 0.25f))
+		);
+		chierarchy.childEntities.push_back(
+			createFaceEntity(ePiece, "Face_cross.obj", XMFLOAT3(0.f, 0.25f, 0.f), XMFLOAT3(XM_PIDIV2 + XM_PI, 0.f, XM_PI))
+		);
+	}
+
+		break;
+
+	case PieceType::PIECE_CORNER:
+	{
+		// 3 faces on cross, back and left
+		chierarchy.childEntities.push_back(
+			createFaceEntity(ePiece, "Face_corner.obj", XMFLOAT3(0.f, 0.f, 0.25f))			// front center, facing the back of piece since forward vector will be 0,0,1
+		);
+		chierarchy.childEntities.push_back(
+			createFaceEntity(ePiece, "Face_corner.obj", XMFLOAT3(0.f, 0.25f, 0.f), XMFLOAT3(XM_PIDIV2 + XM_PI, 0.f, 0.f))	// top
+		);
+		chierarchy.childEntities.push_back(
+			createFaceEntity(ePiece, "Face_corner.obj", XMFLOAT3(-0.25f, 0.f, 0.f), XMFLOAT3(0.f, -XM_PIDIV2, 0.f))    // left
+		);
+	}
+		break;
+	}
+}
+
+UINT LevelLoader::createFaceEntity(const UINT ePiece, std::string strModelFile, XMFLOAT3 translation, XMFLOAT3 rot) {
+	auto eface = registry->createEntity();
+	registry->addComponent<CFace>(eface);
+	auto& ctrans = registry->addComponent<CTransform>(eface);
+	ctrans.pos = translation;										// front center, facing the back of piecesince forward vector will be 0,0,1
+	ctrans.rot = rot;
+
+	XMStoreFloat4x4(
+		&ctrans.mxlocal,
+		XMMatrixRotationRollPitchYawFromVector(XMLoadFloat3(&ctrans.rot)) * XMMatrixTranslationFromVector(XMLoadFloat3(&translation)));
+
+	registry->addComponent<CHierarchy>(eface, ePiece);
+	setEntityDraw(eface, strModelFile);
+
+	return eface;
+}
+
+
+bool LevelLoader::loadMesh(const std::string& strFilename) {
+	// meshes come from a binary .mesh next to the .obj, mapped and copied straight into the buffers. the .mesh is built
+	// from the .obj on first use and again whenever the .obj changes, a .mesh without its .obj is used as it is
+	std::string strFilePath = "./Assets/" + strFilename;
+	std::string strCachePath = strFilePath.substr(0, strFilePath.find_last_of('.')) + ".mesh";
+
+	uint64_t sourceHash = 0;
+	bool hasSource = hashFile(strFilePath, sourceHash);
+	MeshFile cache;
+	bool cached = cache.open(strCachePath) && (!hasSource || cache.getHeader().sourceHash == sourceHash);
+
+	std::vector<float> positions;
+	std::vector<uint32_t> indices;
+	if (!cached) {
+		cache.close();
+		if (!hasSource) {
+			LOG_ERROR(Loader, "no %s or %s", strFilePath.c_str(), strCachePath.c_str());
+			return false;
+		}
+
+		tinyobj::ObjReaderConfig readerConfig;
+		readerConfig.mtl_search_path = "./";
+		readerConfig.triangulate = true;
+		tinyobj::ObjReader reader;
+		
+		if (!reader.ParseFromFile(strFilePath, readerConfig)) {
+			if (!reader.Error().empty()) {
+				LOG_ERROR(Loader, "TinyObjReader: %s", reader.Error().c_str());
+			}
+			return false;
+		}
+		if (!reader.Warning().empty()) {
+			LOG_WARN(Loader, "TinyObjReader: %s", reader.Warning().c_str());
+		}
+
+		// only processing and sending position data to shader for now. not processing normals
+		positions = reader.GetAttrib().vertices;
+		for (auto& shape : reader.GetShapes()) {
+			for (auto& index : shape.mesh.indices)
+				indices.push_back(index.vertex_index);
+		}
+
+		// a read only assets folder just means parsing again next time
+		cached = writeMeshFile(strCachePath, positions, indices, sourceHash) && cache.open(strCachePath);
+		if (!cached)
+			LOG_WARN(Loader, "could not write %s", strCachePath.c_str());
+		else
+			LOG_INFO(Loader, "built %s", strCachePath.c_str());
+	}
+
+	const float* vertexData = cached ? cache.getPositions() : positions.data();
+	uint32_t vertexCount = cached ? cache.getHeader().vertexCount : static_cast<uint32_t>(positions.size() / 3);
+	uint32_t indexCount = cached ? cache.getHeader().indexCount : static_cast<uint32_t>(indices.size());
+
+	// every mesh goes into the vertex and index buffers once, all entities drawing it share that range
+	auto& meshData = mapModelData[strFilename];
+	meshData.meshIndex = static_cast<UINT>(meshes.size());
+	meshes.push_back({ baseVertex, startIndex, indexCount });
+	vertBuffData.insert(vertBuffData.end(), vertexData, vertexData + vertexCount * 3);
+	// the file keeps 16 bit indices when they fit, widened here to the 32 bit buffer
+	if (cached && cache.getHeader().indexSize == 2)
+		indexBuffData.insert(indexBuffData.end(), cache.getIndices16(), cache.getIndices16() + indexCount);
+	else if (cached)
+		indexBuffData.insert(indexBuffData.end(), cache.getIndices32(), cache.getIndices32() + indexCount);
+	else
+		indexBuffData.insert(indexBuffData.end(), indices.begin(), indices.end());
+
+	baseVertex += vertexCount;
+	startIndex += indexCount;
+
+	// bounding box in mesh space, the same for every entity of the mesh
+	float boundsMin[3], boundsMax[3];
+	if (cached) {
+		std::copy(cache.getHeader().boundsMin, cache.getHeader().boundsMin + 3, boundsMin);
+		std::copy(cache.getHeader().boundsMax, cache.getHeader().boundsMax + 3, boundsMax);
+	}
+	else {
+		computeBounds(vertexData, vertexCount, boundsMin, boundsMax);
+	}
+	BoundingBox aabb;
+	BoundingBox::CreateFromPoints(aabb, XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(boundsMin)), XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(boundsMax)));
+	BoundingOrientedBox::CreateFromBoundingBox(meshData.obb, aabb);
+	return true;
+}
+
+CDraw& LevelLoader::setEntityDraw(UINT& entity, std::string strFilename, bool createOBB) {
+	// load every mesh once, entities drawing it again reuse it
+	if (mapModelData.find(strFilename) == mapModelData.end() && !loadMesh(strFilename)) {
+		// draws nothing instead of failing the level
+		mapModelData[strFilename].meshIndex = static_cast<UINT>(meshes.size());
+		meshes.push_back({ baseVertex, startIndex, 0 });
+	}
+
+	// add draw comp to the currently held entity
+	auto& meshData = mapModelData[strFilename];
+	auto& mesh = meshes[meshData.meshIndex];
+	CDraw& cdraw = registry->addComponent<CDraw>(entity, drawIndex++, mesh.baseVertex, mesh.startIndex, mesh.indexCount, meshData.meshIndex);
+
+	// bounding box only for pieces
+	if (createOBB) {
+		auto& cbb = registry->addComponent<CBoundingBox>(entity);
+		cbb.obb = meshData.obb;
+	}
+
+	return cdraw;
+}
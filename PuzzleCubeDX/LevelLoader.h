@@ -1,40 +1,43 @@
-// pso and shader processing class
-#pragma once
-#include "stdafx.h"
-#include "Registry.h"
-
-
-#include <map>
-
-struct MeshData {
-	// these 2 objects store the vertex and index raw data
-	std::vector<float> vertexData;
-	std::vector<uint16_t> indexData;
-};
-
-class LevelLoader {
-public:
-	void loadLevel(std::shared_ptr<Registry> registry);
-
-	std::vector<float> vertBuffData;
-	std::vector<uint16_t> indexBuffData;
-
-private:
-	void createEntities();
-	CDraw& setEntityDraw(UINT& entity, std::string strFilename, bool createOBB = false);
-	void assembleLevel();
-
-	void createPieceEntity(PieceType pieceType);
-	UINT createFaceEntity(const UINT ePiece, std::string strModelFile, XMFLOAT3 translation, XMFLOAT3 rot = XMFLOAT3(0.f, 0.f, 0.f));
-
-	std::shared_ptr<Registry> registry;
-
-	std::map<std::string, MeshData> mapModelData;
-
-	// entities based on piece type
-	std::map<PieceType, std::vector<UINT>> entitiesPieces;
-
-	UINT drawIndex = 0, baseVertex = 0, startIndex = 0;
-
-};
-
+// pso and shader processing class
+#pragma once
+#include "stdafx.h"
+#include "Components.h"
+#include "Registry.h"
+#include "CubeModelNxN.h"
+#include "DrawPackets.h"
+
+
+#include <map>
+
+struct MeshData {
+	UINT meshIndex;																// range in the shared buffers, LevelLoader::meshes
+	BoundingOrientedBox obb;
+};
+
+class LevelLoader {
+public:
+	// builds a cube of size x size x size pieces, clamped to MinCubeSize..MaxCubeSize
+	void loadLevel(std::shared_ptr<Registry> registry, uint16_t cubeSize = 3);
+
+	std::vector<float> vertBuffData;
+	std::vector<uint32_t> indexBuffData;										// 32 bit, a mesh may have more than 64k vertices
+	std::vector<MeshRange> meshes;												// one per unique mesh, by CDraw::meshIndex
+
+private:
+	void createEntities();
+	CDraw& setEntityDraw(UINT& entity, std::string strFilename, bool createOBB = false);
+	bool loadMesh(const std::string& strFilename);
+
+	void createPieceEntity(const int position[3]);
+	UINT createFaceEntity(const UINT ePiece, std::string strModelFile, XMFLOAT3 translation, XMFLOAT3 rot = XMFLOAT3(0.f, 0.f, 0.f));
+
+	std::shared_ptr<Registry> registry;
+
+	std::map<std::string, MeshData> mapModelData;
+
+	uint16_t cubeSize = 3;
+
+	UINT drawIndex = 0, baseVertex = 0, startIndex = 0;
+
+};
+
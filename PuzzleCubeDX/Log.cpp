@@ -0,0 +1,158 @@
+#include "Log.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#endif
+
+namespace {
+	const char* levelNames[] = { "trace", "debug", "info", "warn", "error" };
+
+	const char* categoryName(LogCategory category) {
+		switch (category) {
+		case LogCategory::Registry: return "registry";
+		case LogCategory::Loader: return "loader";
+		case LogCategory::Gameplay: return "gameplay";
+		case LogCategory::Render: return "render";
+		case LogCategory::Solver: return "solver";
+		}
+		return "";
+	}
+
+	// bounded multi producer single consumer queue. every slot has a sequence number: a producer claims position pos
+	// when the slot's sequence equals pos and publishes it as pos + 1, the consumer frees it for the next lap as
+	// pos + Capacity. producers only spin on the claim compare exchange, never on the consumer
+	class Logger {
+	public:
+		Logger() {
+			for (uint64_t i = 0; i < Log::Capacity; i++)
+				slots[i].sequence.store(i, std::memory_order_relaxed);
+			flushThread = std::thread(&Logger::flushLoop, this);
+		}
+
+		~Logger() {
+			stopping.store(true, std::memory_order_release);
+			flushThread.join();
+		}
+
+		void write(LogLevel level, LogCategory category, const char* format, va_list args) {
+			uint64_t pos = tail.load(std::memory_order_relaxed);
+			Slot* slot;
+			for (;;) {
+				slot = &slots[pos & (Log::Capacity - 1)];
+				int64_t diff = static_cast<int64_t>(slot->sequence.load(std::memory_order_acquire) - pos);
+				if (diff == 0) {
+					if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (diff < 0) {
+					// full, the flush thread is a whole lap behind
+					dropped.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+				else {
+					pos = tail.load(std::memory_order_relaxed);
+				}
+			}
+
+			slot->level = level;
+			slot->category = category;
+			vsnprintf(slot->text, Log::MessageSize, format, args);
+			slot->sequence.store(pos + 1, std::memory_order_release);
+		}
+
+		void flush() {
+			uint64_t target = tail.load(std::memory_order_acquire);
+			while (flushed.load(std::memory_order_acquire) < target)
+				std::this_thread::yield();
+		}
+
+		uint64_t getDroppedCount() const {
+			return dropped.load(std::memory_order_relaxed);
+		}
+
+	private:
+		struct Slot {
+			std::atomic<uint64_t> sequence;
+			LogLevel level;
+			LogCategory category;
+			char text[Log::MessageSize];
+		};
+
+		void flushLoop() {
+			std::string batch;
+			for (;;) {
+				bool stop = stopping.load(std::memory_order_acquire);
+
+				// take every published message in order, stop at the first slot still being written
+				while (true) {
+					Slot& slot = slots[head & (Log::Capacity - 1)];
+					if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+						break;
+
+					batch += "[";
+					batch += levelNames[static_cast<uint8_t>(slot.level)];
+					batch += "][";
+					batch += categoryName(slot.category);
+					batch += "] ";
+					batch += slot.text;
+					batch += "\n";
+
+					slot.sequence.store(head + Log::Capacity, std::memory_order_release);
+					head++;
+				}
+
+				if (!batch.empty()) {
+#ifdef _WIN32
+					OutputDebugStringA(batch.c_str());
+#endif
+					fwrite(batch.data(), 1, batch.size(), stderr);
+					fflush(stderr);
+					batch.clear();
+				}
+				flushed.store(head, std::memory_order_release);
+
+				if (stop)
+					break;
+				std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			}
+		}
+
+		Slot slots[Log::Capacity];
+		alignas(64) std::atomic<uint64_t> tail{ 0 };							// next position to claim by producers
+		alignas(64) std::atomic<uint64_t> flushed{ 0 };							// positions below this reached the sink
+		std::atomic<uint64_t> dropped{ 0 };
+		std::atomic<bool> stopping{ false };
+		uint64_t head = 0;														// next position to read, flush thread only
+		std::thread flushThread;
+	};
+
+	Logger& getLogger() {
+		static Logger logger;
+		return logger;
+	}
+}
+
+void Log::write(LogLevel level, LogCategory category, const char* format, ...) {
+	va_list args;
+	va_start(args, format);
+	getLogger().write(level, category, format, args);
+	va_end(args);
+}
+
+void Log::flush() {
+	getLogger().flush();
+}
+
+uint64_t Log::getDroppedCount() {
+	return getLogger().getDroppedCount();
+}
@@ -0,0 +1,65 @@
+// compile time log levels and categories
+#pragma once
+#include <cstdint>
+
+// LOG_LEVEL and LOG_CATEGORIES can be set in the project's preprocessor definitions. messages below the level or outside
+// the categories are discarded at compile time, their arguments are never evaluated
+#ifndef LOG_LEVEL
+#ifdef _DEBUG
+#define LOG_LEVEL 1																// debug
+#else
+#define LOG_LEVEL 3																// warn
+#endif
+#endif
+
+#ifndef LOG_CATEGORIES
+#define LOG_CATEGORIES 0xffffffffu
+#endif
+
+enum class LogLevel : uint8_t {
+	Trace,
+	Debug,
+	Info,
+	Warn,
+	Error,
+	Off
+};
+
+enum class LogCategory : uint32_t {
+	Registry = 1 << 0,
+	Loader = 1 << 1,
+	Gameplay = 1 << 2,
+	Render = 1 << 3,
+	Solver = 1 << 4
+};
+
+constexpr bool logEnabled(LogLevel level, LogCategory category) {
+	return static_cast<uint8_t>(level) >= LOG_LEVEL && (static_cast<uint32_t>(category) & LOG_CATEGORIES) != 0;
+}
+
+// messages are formatted printf style straight into a slot of a fixed size lock free ring buffer and written out by a
+// background thread, so logging never waits on I/O. when the ring is full the message is dropped and counted
+class Log {
+public:
+	static constexpr uint32_t MessageSize = 256;								// longer messages are truncated
+	static constexpr uint32_t Capacity = 1024;									// ring slots, power of two
+
+	static void write(LogLevel level, LogCategory category, const char* format, ...);
+
+	// block until everything written so far reached the sink
+	static void flush();
+
+	static uint64_t getDroppedCount();
+};
+
+#define LOG(level, category, ...)																	\
+	do {																							\
+		if constexpr (logEnabled(LogLevel::level, LogCategory::category))							\
+			Log::write(LogLevel::level, LogCategory::category, __VA_ARGS__);						\
+	} while (0)
+
+#define LOG_TRACE(category, ...) LOG(Trace, category, __VA_ARGS__)
+#define LOG_DEBUG(category, ...) LOG(Debug, category, __VA_ARGS__)
+#define LOG_INFO(category, ...) LOG(Info, category, __VA_ARGS__)
+#define LOG_WARN(category, ...) LOG(Warn, category, __VA_ARGS__)
+#define LOG_ERROR(category, ...) LOG(Error, category, __VA_ARGS__)
@@ -0,0 +1,34 @@
+// read only memory mapped file
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// maps a whole file read only. the pages come from the os page cache, so processes mapping the same file share one
+// copy and nothing is read until it is touched
+class MappedFile {
+public:
+	MappedFile() = default;
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool open(const std::string& path);
+	void close();
+
+	bool isOpen() const;
+	const uint8_t* getData() const;
+	size_t getSize() const;
+
+private:
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+#ifdef _WIN32
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+#endif
+};
+
+// moves from onto to, replacing to in one step (MoveFileEx on windows, rename elsewhere), so a reader finds either the
+// old file or the whole new one. for files written to a temporary name first
+bool replaceFile(const std::string& from, const std::string& to);
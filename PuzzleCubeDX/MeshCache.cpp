@@ -0,0 +1,127 @@
+#include "MeshCache.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+	const char MeshMagic[4] = { 'P', 'C', 'M', 'S' };
+	const uint32_t MeshVersion = 1;
+
+	static_assert(sizeof(MeshFileHeader) == 64, "mesh files are read straight into the header");
+
+	size_t streamBytes(const MeshFileHeader& header) {
+		return static_cast<size_t>(header.vertexCount) * 3 * sizeof(float) + static_cast<size_t>(header.indexCount) * header.indexSize;
+	}
+}
+
+
+uint64_t hashBytes(const void* data, size_t size, uint64_t hash) {
+	auto bytes = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+bool hashFile(const std::string& path, uint64_t& hash) {
+	MappedFile file;
+	if (!file.open(path))
+		return false;
+	hash = hashBytes(file.getData(), file.getSize());
+	return true;
+}
+
+void computeBounds(const float* positions, uint32_t vertexCount, float boundsMin[3], float boundsMax[3]) {
+	for (int k = 0; k < 3; k++) {
+		boundsMin[k] = vertexCount ? positions[k] : 0.f;
+		boundsMax[k] = boundsMin[k];
+	}
+	for (uint32_t v = 1; v < vertexCount; v++) {
+		for (int k = 0; k < 3; k++) {
+			boundsMin[k] = std::min(boundsMin[k], positions[v * 3 + k]);
+			boundsMax[k] = std::max(boundsMax[k], positions[v * 3 + k]);
+		}
+	}
+}
+
+bool writeMeshFile(const std::string& path, const std::vector<float>& positions, const std::vector<uint32_t>& indices, uint64_t sourceHash) {
+	MeshFileHeader header = {};
+	std::copy(MeshMagic, MeshMagic + 4, header.magic);
+	header.version = MeshVersion;
+	header.sourceHash = sourceHash;
+	header.vertexCount = static_cast<uint32_t>(positions.size() / 3);
+	header.indexCount = static_cast<uint32_t>(indices.size());
+
+	uint32_t maxIndex = indices.empty() ? 0 : *std::max_element(indices.begin(), indices.end());
+	header.indexSize = maxIndex <= 0xffff ? 2 : 4;
+	std::vector<uint16_t> indices16;
+	if (header.indexSize == 2)
+		indices16.assign(indices.begin(), indices.end());
+	const void* indexData = header.indexSize == 2 ? static_cast<const void*>(indices16.data()) : indices.data();
+	size_t indexBytes = indices.size() * header.indexSize;
+	size_t positionBytes = header.vertexCount * 3 * sizeof(float);
+
+	computeBounds(positions.data(), header.vertexCount, header.boundsMin, header.boundsMax);
+	header.dataHash = hashBytes(indexData, indexBytes, hashBytes(positions.data(), positionBytes));
+
+	std::string tempPath = path + ".tmp";
+	FILE* file = fopen(tempPath.c_str(), "wb");
+	if (!file)
+		return false;
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+		fwrite(positions.data(), 1, positionBytes, file) == positionBytes &&
+		fwrite(indexData, 1, indexBytes, file) == indexBytes;
+	written = fclose(file) == 0 && written;
+
+	if (!written || !replaceFile(tempPath, path)) {
+		std::remove(tempPath.c_str());
+		return false;
+	}
+	return true;
+}
+
+bool MeshFile::open(const std::string& path) {
+	close();
+	if (!file.open(path))
+		return false;
+
+	auto candidate = reinterpret_cast<const MeshFileHeader*>(file.getData());
+	bool valid = file.getSize() >= sizeof(MeshFileHeader) && std::equal(MeshMagic, MeshMagic + 4, candidate->magic) &&
+		candidate->version == MeshVersion &&
+		(candidate->indexSize == 2 || candidate->indexSize == 4) &&
+		file.getSize() == sizeof(MeshFileHeader) + streamBytes(*candidate) &&
+		hashBytes(file.getData() + sizeof(MeshFileHeader), streamBytes(*candidate)) == candidate->dataHash;
+	if (!valid) {
+		file.close();
+		return false;
+	}
+
+	header = candidate;
+	return true;
+}
+
+void MeshFile::close() {
+	file.close();
+	header = nullptr;
+}
+
+const MeshFileHeader& MeshFile::getHeader() const {
+	return *header;
+}
+
+const float* MeshFile::getPositions() const {
+	return reinterpret_cast<const float*>(file.getData() + sizeof(MeshFileHeader));
+}
+
+const uint16_t* MeshFile::getIndices16() const {
+	if (header->indexSize != 2)
+		return nullptr;
+	return reinterpret_cast<const uint16_t*>(file.getData() + sizeof(MeshFileHeader) + header->vertexCount * 3 * sizeof(float));
+}
+
+const uint32_t* MeshFile::getIndices32() const {
+	if (header->indexSize != 4)
+		return nullptr;
+	return reinterpret_cast<const uint32_t*>(file.getData() + sizeof(MeshFileHeader) + header->vertexCount * 3 * sizeof(float));
+}
@@ -0,0 +1,49 @@
+// precompiled binary meshes
+#pragma once
+#include "MappedFile.h"
+
+#include <string>
+#include <vector>
+
+// a .mesh file is this header, the vertex stream (x y z floats per vertex) and the index stream (16 bit when every
+// index fits, else 32 bit). sourceHash is the hash of the .obj the mesh was built from, so a cache older than its
+// source gets rebuilt, dataHash covers both streams
+struct MeshFileHeader {
+	char magic[4];
+	uint32_t version;
+	uint64_t sourceHash;
+	uint64_t dataHash;
+	uint32_t vertexCount;
+	uint32_t indexCount;
+	uint32_t indexSize;															// 2 or 4 bytes
+	uint32_t reserved;
+	float boundsMin[3];
+	float boundsMax[3];
+};
+
+// 64 bit FNV-1a
+uint64_t hashBytes(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325ull);
+bool hashFile(const std::string& path, uint64_t& hash);
+
+// axis aligned bounds of x y z positions, all 0 without any
+void computeBounds(const float* positions, uint32_t vertexCount, float boundsMin[3], float boundsMax[3]);
+
+// writes through a temporary file and a rename, so nothing ever maps half a mesh
+bool writeMeshFile(const std::string& path, const std::vector<float>& positions, const std::vector<uint32_t>& indices, uint64_t sourceHash);
+
+// a mapped .mesh file, used in place without parsing
+class MeshFile {
+public:
+	// false if the file is missing or malformed. whether it is up to date is for the caller to check on sourceHash
+	bool open(const std::string& path);
+	void close();
+
+	const MeshFileHeader& getHeader() const;
+	const float* getPositions() const;
+	const uint16_t* getIndices16() const;										// null unless indexSize is 2
+	const uint32_t* getIndices32() const;										// null unless indexSize is 4
+
+private:
+	MappedFile file;
+	const MeshFileHeader* header = nullptr;
+};
@@ -0,0 +1,376 @@
+#include "MoveKernels.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define MOVE_KERNELS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// gcc and clang only emit SSSE3 and AVX2 instructions in functions marked for them, msvc emits them anywhere
+#if defined(MOVE_KERNELS_X86) && defined(__GNUC__)
+#define TARGET_SSSE3 __attribute__((target("ssse3")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSSE3
+#define TARGET_AVX2
+#endif
+
+namespace {
+	const uint8_t BlockStart[4] = { 0, 16, 32, NumFacelets - 16 };
+
+	// the SIMD cubie kernels read cp and co (and ep and eo) as one run of bytes
+	static_assert(offsetof(CubieCube, co) == offsetof(CubieCube, cp) + CornerCount, "corner arrays must be adjacent");
+	static_assert(offsetof(CubieCube, ep) == offsetof(CubieCube, co) + CornerCount, "edge arrays must follow the corners");
+	static_assert(offsetof(CubieCube, eo) == offsetof(CubieCube, ep) + EdgeCount, "edge arrays must be adjacent");
+	static_assert(sizeof(CubieCube) == 2 * (CornerCount + EdgeCount), "CubieCube must not be padded");
+
+	struct Kernels {
+		void (*permuteFacelets)(Facelets& facelets, const Facelets& permutation, const FaceletShuffle& shuffle);
+		void (*multiplyCorners)(CubieCube& cube, const CubieCube& move);
+		void (*multiplyEdges)(CubieCube& cube, const CubieCube& move);
+		void (*applyFaceletMove)(const FaceletBatch& in, FaceletBatch& out, const Facelets& permutation);
+		void (*applyCubieMove)(const CubieBatch& in, CubieBatch& out, const CubieCube& move);
+	};
+
+	// scalar
+
+	void permuteFaceletsScalar(Facelets& facelets, const Facelets& permutation, const FaceletShuffle&) {
+		Facelets turned;
+		for (int i = 0; i < NumFacelets; i++)
+			turned[i] = facelets[permutation[i]];
+		facelets = turned;
+	}
+
+	void multiplyCornersScalar(CubieCube& cube, const CubieCube& move) {
+		uint8_t perm[CornerCount], ori[CornerCount];
+		for (int i = 0; i < CornerCount; i++) {
+			perm[i] = cube.cp[move.cp[i]];
+			ori[i] = (cube.co[move.cp[i]] + move.co[i]) % 3;
+		}
+		std::copy(perm, perm + CornerCount, cube.cp);
+		std::copy(ori, ori + CornerCount, cube.co);
+	}
+
+	void multiplyEdgesScalar(CubieCube& cube, const CubieCube& move) {
+		uint8_t perm[EdgeCount], ori[EdgeCount];
+		for (int i = 0; i < EdgeCount; i++) {
+			perm[i] = cube.ep[move.ep[i]];
+			ori[i] = cube.eo[move.ep[i]] ^ move.eo[i];
+		}
+		std::copy(perm, perm + EdgeCount, cube.ep);
+		std::copy(ori, ori + EdgeCount, cube.eo);
+	}
+
+	void applyFaceletMoveScalar(const FaceletBatch& in, FaceletBatch& out, const Facelets& permutation) {
+		for (int i = 0; i < NumFacelets; i++)
+			memcpy(out.facelets[i], in.facelets[permutation[i]], BatchWidth);
+	}
+
+	void applyCubieMoveScalar(const CubieBatch& in, CubieBatch& out, const CubieCube& move) {
+		for (int i = 0; i < CornerCount; i++) {
+			memcpy(out.cp[i], in.cp[move.cp[i]], BatchWidth);
+			for (int k = 0; k < BatchWidth; k++) {
+				uint8_t twist = in.co[move.cp[i]][k] + move.co[i];
+				out.co[i][k] = twist >= 3 ? twist - 3 : twist;
+			}
+		}
+		for (int i = 0; i < EdgeCount; i++) {
+			memcpy(out.ep[i], in.ep[move.ep[i]], BatchWidth);
+			for (int k = 0; k < BatchWidth; k++)
+				out.eo[i][k] = in.eo[move.ep[i]][k] ^ move.eo[i];
+		}
+	}
+
+	const Kernels scalarKernels = {
+		permuteFaceletsScalar, multiplyCornersScalar, multiplyEdgesScalar, applyFaceletMoveScalar, applyCubieMoveScalar
+	};
+
+#ifdef MOVE_KERNELS_X86
+	// SSSE3
+
+	// every output block is the or of one pshufb per input block, the controls zero the bytes other blocks provide
+	TARGET_SSSE3 void permuteFaceletsSSSE3(Facelets& facelets, const Facelets&, const FaceletShuffle& shuffle) {
+		uint8_t* data = facelets.data();
+		__m128i in[4], out[4];
+		for (int b = 0; b < 4; b++)
+			in[b] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + BlockStart[b]));
+
+		for (int o = 0; o < 4; o++) {
+			__m128i block = _mm_shuffle_epi8(in[0], _mm_load_si128(reinterpret_cast<const __m128i*>(shuffle.control[0][o])));
+			for (int b = 1; b < 4; b++)
+				block = _mm_or_si128(block, _mm_shuffle_epi8(in[b], _mm_load_si128(reinterpret_cast<const __m128i*>(shuffle.control[b][o]))));
+			out[o] = block;
+		}
+
+		// the last block overlaps the third, both hold the same values there
+		for (int o = 0; o < 4; o++)
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(data + BlockStart[o]), out[o]);
+	}
+
+	// cp and co are one register, gathered with a single control. the twist add only touches the co half, and
+	// min(x, x - 3) is x mod 3 for x < 6 since x - 3 wraps around for x < 3
+	TARGET_SSSE3 void multiplyCornersSSSE3(CubieCube& cube, const CubieCube& move) {
+		__m128i corners = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cube.cp));
+		__m128i movePerm = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(move.cp));
+		__m128i control = _mm_unpacklo_epi64(movePerm, _mm_add_epi8(movePerm, _mm_set1_epi8(CornerCount)));
+		__m128i twist = _mm_slli_si128(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(move.co)), 8);
+
+		__m128i result = _mm_add_epi8(_mm_shuffle_epi8(corners, control), twist);
+		result = _mm_min_epu8(result, _mm_sub_epi8(result, _mm_set_epi64x(0x0303030303030303ll, 0)));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(cube.cp), result);
+	}
+
+	// ep and eo are 24 bytes, read as ep[0..15] and ep[8..23] (ep 8..11 then eo). the first register gathers ep, the
+	// second gathers eo into its bytes 4..15 and takes the new ep 8..11 into bytes 0..3, then both are stored over the
+	// same range so the second store fixes the bytes the first one wrote past ep
+	TARGET_SSSE3 void multiplyEdgesSSSE3(CubieCube& cube, const CubieCube& move) {
+		__m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cube.ep));
+		__m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cube.ep + 8));
+		__m128i movePerm = _mm_loadu_si128(reinterpret_cast<const __m128i*>(move.ep));
+		__m128i headMask = _mm_set_epi32(0, 0, 0, -1);
+
+		__m128i perm = _mm_shuffle_epi8(low, movePerm);
+
+		__m128i flipControl = _mm_add_epi8(_mm_slli_si128(movePerm, 4), _mm_set_epi32(0x04040404, 0x04040404, 0x04040404, static_cast<int>(0x80808080)));
+		__m128i moveFlip = _mm_andnot_si128(headMask, _mm_loadu_si128(reinterpret_cast<const __m128i*>(move.ep + 8)));
+		__m128i flip = _mm_xor_si128(_mm_shuffle_epi8(high, flipControl), moveFlip);
+		flip = _mm_or_si128(flip, _mm_and_si128(_mm_srli_si128(perm, 8), headMask));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(cube.ep), perm);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(cube.ep + 8), flip);
+	}
+
+	TARGET_SSSE3 void applyFaceletMoveSSSE3(const FaceletBatch& in, FaceletBatch& out, const Facelets& permutation) {
+		for (int i = 0; i < NumFacelets; i++) {
+			auto source = reinterpret_cast<const __m128i*>(in.facelets[permutation[i]]);
+			auto target = reinterpret_cast<__m128i*>(out.facelets[i]);
+			_mm_store_si128(target, _mm_load_si128(source));
+			_mm_store_si128(target + 1, _mm_load_si128(source + 1));
+		}
+	}
+
+	TARGET_SSSE3 void applyCubieMoveSSSE3(const CubieBatch& in, CubieBatch& out, const CubieCube& move) {
+		__m128i three = _mm_set1_epi8(3);
+		for (int i = 0; i < CornerCount; i++) {
+			auto perm = reinterpret_cast<const __m128i*>(in.cp[move.cp[i]]);
+			auto twist = reinterpret_cast<const __m128i*>(in.co[move.cp[i]]);
+			__m128i moveTwist = _mm_set1_epi8(static_cast<char>(move.co[i]));
+			for (int h = 0; h < 2; h++) {
+				_mm_store_si128(reinterpret_cast<__m128i*>(out.cp[i]) + h, _mm_load_si128(perm + h));
+				__m128i sum = _mm_add_epi8(_mm_load_si128(twist + h), moveTwist);
+				_mm_store_si128(reinterpret_cast<__m128i*>(out.co[i]) + h, _mm_min_epu8(sum, _mm_sub_epi8(sum, three)));
+			}
+		}
+		for (int i = 0; i < EdgeCount; i++) {
+			auto perm = reinterpret_cast<const __m128i*>(in.ep[move.ep[i]]);
+			auto flip = reinterpret_cast<const __m128i*>(in.eo[move.ep[i]]);
+			__m128i moveFlip = _mm_set1_epi8(static_cast<char>(move.eo[i]));
+			for (int h = 0; h < 2; h++) {
+				_mm_store_si128(reinterpret_cast<__m128i*>(out.ep[i]) + h, _mm_load_si128(perm + h));
+				_mm_store_si128(reinterpret_cast<__m128i*>(out.eo[i]) + h, _mm_xor_si128(_mm_load_si128(flip + h), moveFlip));
+			}
+		}
+	}
+
+	const Kernels ssse3Kernels = {
+		permuteFaceletsSSSE3, multiplyCornersSSSE3, multiplyEdgesSSSE3, applyFaceletMoveSSSE3, applyCubieMoveSSSE3
+	};
+
+	// AVX2
+
+	// vpshufb only shuffles within 128 bit lanes, so every input block is copied to both lanes and one register makes
+	// two output blocks. control[b][o] and control[b][o + 1] are next to each other for that
+	TARGET_AVX2 void permuteFaceletsAVX2(Facelets& facelets, const Facelets&, const FaceletShuffle& shuffle) {
+		uint8_t* data = facelets.data();
+		__m256i in[4];
+		for (int b = 0; b < 4; b++)
+			in[b] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + BlockStart[b])));
+
+		__m256i out[2];
+		for (int pair = 0; pair < 2; pair++) {
+			__m256i blocks = _mm256_shuffle_epi8(in[0], _mm256_load_si256(reinterpret_cast<const __m256i*>(shuffle.control[0][pair * 2])));
+			for (int b = 1; b < 4; b++)
+				blocks = _mm256_or_si256(blocks, _mm256_shuffle_epi8(in[b], _mm256_load_si256(reinterpret_cast<const __m256i*>(shuffle.control[b][pair * 2]))));
+			out[pair] = blocks;
+		}
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data), out[0]);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(data + BlockStart[2]), _mm256_castsi256_si128(out[1]));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(data + BlockStart[3]), _mm256_extracti128_si256(out[1], 1));
+	}
+
+	TARGET_AVX2 void applyFaceletMoveAVX2(const FaceletBatch& in, FaceletBatch& out, const Facelets& permutation) {
+		for (int i = 0; i < NumFacelets; i++) {
+			_mm256_store_si256(reinterpret_cast<__m256i*>(out.facelets[i]),
+				_mm256_load_si256(reinterpret_cast<const __m256i*>(in.facelets[permutation[i]])));
+		}
+	}
+
+	TARGET_AVX2 void applyCubieMoveAVX2(const CubieBatch& in, CubieBatch& out, const CubieCube& move) {
+		__m256i three = _mm256_set1_epi8(3);
+		for (int i = 0; i < CornerCount; i++) {
+			_mm256_store_si256(reinterpret_cast<__m256i*>(out.cp[i]), _mm256_load_si256(reinterpret_cast<const __m256i*>(in.cp[move.cp[i]])));
+			__m256i sum = _mm256_add_epi8(_mm256_load_si256(reinterpret_cast<const __m256i*>(in.co[move.cp[i]])),
+				_mm256_set1_epi8(static_cast<char>(move.co[i])));
+			_mm256_store_si256(reinterpret_cast<__m256i*>(out.co[i]), _mm256_min_epu8(sum, _mm256_sub_epi8(sum, three)));
+		}
+		for (int i = 0; i < EdgeCount; i++) {
+			_mm256_store_si256(reinterpret_cast<__m256i*>(out.ep[i]), _mm256_load_si256(reinterpret_cast<const __m256i*>(in.ep[move.ep[i]])));
+			_mm256_store_si256(reinterpret_cast<__m256i*>(out.eo[i]), _mm256_xor_si256(
+				_mm256_load_si256(reinterpret_cast<const __m256i*>(in.eo[move.ep[i]])), _mm256_set1_epi8(static_cast<char>(move.eo[i]))));
+		}
+	}
+
+	// a single cubie state fits in 128 bits, wider registers would not help it
+	const Kernels avx2Kernels = {
+		permuteFaceletsAVX2, multiplyCornersSSSE3, multiplyEdgesSSSE3, applyFaceletMoveAVX2, applyCubieMoveAVX2
+	};
+
+	InstructionSet detectInstructionSet() {
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		int maxLeaf = info[0];
+		__cpuid(info, 1);
+		bool ssse3 = (info[2] & (1 << 9)) != 0;
+		bool osSavesYmm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+		bool avx2 = false;
+		if (maxLeaf >= 7 && osSavesYmm) {
+			__cpuidex(info, 7, 0);
+			avx2 = (info[1] & (1 << 5)) != 0;
+		}
+#else
+		__builtin_cpu_init();
+		bool ssse3 = __builtin_cpu_supports("ssse3");
+		bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+		return avx2 ? InstructionSet::AVX2 : ssse3 ? InstructionSet::SSSE3 : InstructionSet::Scalar;
+	}
+#else
+	InstructionSet detectInstructionSet() {
+		return InstructionSet::Scalar;
+	}
+#endif
+
+	const Kernels& getKernels(InstructionSet set) {
+#ifdef MOVE_KERNELS_X86
+		if (set == InstructionSet::AVX2)
+			return avx2Kernels;
+		if (set == InstructionSet::SSSE3)
+			return ssse3Kernels;
+#endif
+		return scalarKernels;
+	}
+
+	struct Dispatch {
+		InstructionSet supported, active;
+		const Kernels* kernels;
+
+		Dispatch() {
+			supported = active = detectInstructionSet();
+			kernels = &getKernels(active);
+		}
+	};
+
+	Dispatch& getDispatch() {
+		static Dispatch dispatch;
+		return dispatch;
+	}
+}
+
+
+InstructionSet getSupportedInstructionSet() {
+	return getDispatch().supported;
+}
+
+InstructionSet getInstructionSet() {
+	return getDispatch().active;
+}
+
+InstructionSet setInstructionSet(InstructionSet set) {
+	auto& dispatch = getDispatch();
+	dispatch.active = std::min(set, dispatch.supported);
+	dispatch.kernels = &getKernels(dispatch.active);
+	return dispatch.active;
+}
+
+const char* getInstructionSetName(InstructionSet set) {
+	switch (set) {
+	case InstructionSet::SSSE3:
+		return "SSSE3";
+	case InstructionSet::AVX2:
+		return "AVX2";
+	default:
+		return "scalar";
+	}
+}
+
+void makeFaceletShuffle(const Facelets& permutation, FaceletShuffle& shuffle) {
+	memset(shuffle.control, 0x80, sizeof(shuffle.control));
+	for (int o = 0; o < 4; o++) {
+		for (int j = 0; j < 16; j++) {
+			uint8_t source = permutation[BlockStart[o] + j];
+			int b = source < 48 ? source / 16 : 3;
+			shuffle.control[b][o][j] = static_cast<uint8_t>(source - BlockStart[b]);
+		}
+	}
+}
+
+void permuteFacelets(Facelets& facelets, const Facelets& permutation, const FaceletShuffle& shuffle) {
+	getDispatch().kernels->permuteFacelets(facelets, permutation, shuffle);
+}
+
+void multiplyCorners(CubieCube& cube, const CubieCube& move) {
+	getDispatch().kernels->multiplyCorners(cube, move);
+}
+
+void multiplyEdges(CubieCube& cube, const CubieCube& move) {
+	getDispatch().kernels->multiplyEdges(cube, move);
+}
+
+void applyMove(const FaceletBatch& in, FaceletBatch& out, const Facelets& permutation) {
+	getDispatch().kernels->applyFaceletMove(in, out, permutation);
+}
+
+void applyMove(const CubieBatch& in, CubieBatch& out, const CubieCube& move) {
+	getDispatch().kernels->applyCubieMove(in, out, move);
+}
+
+
+void FaceletBatch::set(uint8_t k, const Facelets& state) {
+	for (int i = 0; i < NumFacelets; i++)
+		facelets[i][k] = state[i];
+}
+
+void FaceletBatch::get(uint8_t k, Facelets& state) const {
+	for (int i = 0; i < NumFacelets; i++)
+		state[i] = facelets[i][k];
+}
+
+void CubieBatch::set(uint8_t k, const CubieCube& cube) {
+	for (int i = 0; i < CornerCount; i++) {
+		cp[i][k] = cube.cp[i];
+		co[i][k] = cube.co[i];
+	}
+	for (int i = 0; i < EdgeCount; i++) {
+		ep[i][k] = cube.ep[i];
+		eo[i][k] = cube.eo[i];
+	}
+}
+
+void CubieBatch::get(uint8_t k, CubieCube& cube) const {
+	for (int i = 0; i < CornerCount; i++) {
+		cube.cp[i] = cp[i][k];
+		cube.co[i] = co[i][k];
+	}
+	for (int i = 0; i < EdgeCount; i++) {
+		cube.ep[i] = ep[i][k];
+		cube.eo[i] = eo[i][k];
+	}
+}
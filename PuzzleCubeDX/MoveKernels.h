@@ -0,0 +1,60 @@
+// byte shuffle kernels that apply moves to cube states
+#pragma once
+#include "CubieCube.h"
+
+// the kernels come in a plain c++ version and x86 versions using pshufb (SSSE3) and 256 bit registers (AVX2). the best
+// one the cpu runs is picked on first use, every set gives the same results
+enum class InstructionSet : uint8_t {
+	Scalar,
+	SSSE3,
+	AVX2
+};
+
+InstructionSet getSupportedInstructionSet();
+InstructionSet getInstructionSet();
+
+// switch to another set, eg. to compare them. clamped to what the cpu supports, returns the set now in use. not meant
+// to be called while other threads apply moves
+InstructionSet setInstructionSet(InstructionSet set);
+const char* getInstructionSetName(InstructionSet set);
+
+// pshufb controls of a facelet permutation. the 54 facelets are read and written as 4 blocks of 16, the last one
+// starting at facelet 38 so nothing past the array is touched. control[in][out] picks the bytes of output block out
+// that come from input block in and zeroes the rest
+struct FaceletShuffle {
+	alignas(32) uint8_t control[4][4][16];
+};
+
+void makeFaceletShuffle(const Facelets& permutation, FaceletShuffle& shuffle);
+
+// facelets[i] = facelets[permutation[i]], shuffle made from the same permutation
+void permuteFacelets(Facelets& facelets, const Facelets& permutation, const FaceletShuffle& shuffle);
+
+// cube = cube * move, the corner or edge half of CubieCube::multiply
+void multiplyCorners(CubieCube& cube, const CubieCube& move);
+void multiplyEdges(CubieCube& cube, const CubieCube& move);
+
+constexpr uint8_t BatchWidth = 32;
+
+// BatchWidth states in structure of arrays form, facelet i of state k at facelets[i][k]. a move moves whole rows, so it
+// costs about the same as on a single state. batches of fewer states leave the other lanes unused
+struct FaceletBatch {
+	alignas(32) uint8_t facelets[NumFacelets][BatchWidth];
+
+	void set(uint8_t k, const Facelets& state);
+	void get(uint8_t k, Facelets& state) const;
+};
+
+struct CubieBatch {
+	alignas(32) uint8_t cp[CornerCount][BatchWidth];
+	alignas(32) uint8_t co[CornerCount][BatchWidth];
+	alignas(32) uint8_t ep[EdgeCount][BatchWidth];
+	alignas(32) uint8_t eo[EdgeCount][BatchWidth];
+
+	void set(uint8_t k, const CubieCube& cube);
+	void get(uint8_t k, CubieCube& cube) const;
+};
+
+// out = in with the same move applied to every state. in and out must not be the same batch
+void applyMove(const FaceletBatch& in, FaceletBatch& out, const Facelets& permutation);
+void applyMove(const CubieBatch& in, CubieBatch& out, const CubieCube& move);
@@ -0,0 +1,375 @@
+#include "Notation.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace {
+	// base index of a move letter in Move order (face, slice, wide, rotation), -1 if it is not one
+	int baseOfLetter(char c) {
+		const char* letters = "RLUFDBMESrlufdbXYZ";
+		for (int i = 0; letters[i]; i++) {
+			if (letters[i] == c)
+				return i;
+		}
+		if (c == 'x' || c == 'y' || c == 'z')
+			return 15 + (c - 'x');
+		return -1;
+	}
+
+	// move for a base turned n quarter turns clockwise, MoveCount if it cancels out
+	Move moveOf(int base, int n) {
+		int quarters = ((n % 4) + 4) % 4;
+		if (quarters == 0)
+			return MoveCount;
+		return static_cast<Move>(base * 3 + (quarters == 1 ? 0 : quarters == 2 ? 2 : 1));
+	}
+
+	// recursive descent over the text, one method per grammar rule. T is Move for the 3x3 or LayerMove for cubes of
+	// any size, only single moves parse differently
+	template <typename T>
+	class Parser {
+	public:
+		Parser(const std::string& text, uint16_t size = 3) : text(text), size(size) {}
+
+		bool parse(std::vector<T>& moves) {
+			if (!parseSequence(moves))
+				return false;
+			if (pos < text.length())
+				return fail("unexpected '" + std::string(1, text[pos]) + "'");
+			return true;
+		}
+
+		std::string error;
+
+	private:
+		// items until the end of the text or a closing character of an enclosing group
+		bool parseSequence(std::vector<T>& moves) {
+			for (;;) {
+				skipSpace();
+				if (pos >= text.length() || text[pos] == ')' || text[pos] == ']' || text[pos] == ',' || text[pos] == ':')
+					return true;
+				if (!parseItem(moves))
+					return false;
+				if (moves.size() > MaxCompiledMoves)
+					return fail("sequence too long");
+			}
+		}
+
+		bool parseItem(std::vector<T>& moves) {
+			char c = text[pos];
+			if (c == '(') {
+				pos++;
+				std::vector<T> group;
+				if (!parseSequence(group) || !expect(')'))
+					return false;
+				return appendGroup(group, moves);
+			}
+			if (c == '[') {
+				pos++;
+				std::vector<T> a, b;
+				if (!parseSequence(a))
+					return false;
+				skipSpace();
+				if (pos >= text.length() || (text[pos] != ',' && text[pos] != ':'))
+					return fail("expected ',' or ':'");
+				bool conjugate = text[pos++] == ':';
+				if (!parseSequence(b) || !expect(']'))
+					return false;
+
+				// [A, B] = A B A' B', [A: B] = A B A'
+				std::vector<T> group = a;
+				group.insert(group.end(), b.begin(), b.end());
+				invertMoves(a);
+				group.insert(group.end(), a.begin(), a.end());
+				if (!conjugate) {
+					invertMoves(b);
+					group.insert(group.end(), b.begin(), b.end());
+				}
+				return appendGroup(group, moves);
+			}
+			return parseMove(moves);
+		}
+
+		bool parseMove(std::vector<T>& moves);
+
+		// repeat count and prime after a group
+		bool appendGroup(std::vector<T>& group, std::vector<T>& moves) {
+			size_t count = parseCount();
+			if (pos < text.length() && text[pos] == '\'') {
+				invertMoves(group);
+				pos++;
+			}
+			if (moves.size() + group.size() * count > MaxCompiledMoves)
+				return fail("sequence too long");
+			for (size_t i = 0; i < count; i++)
+				moves.insert(moves.end(), group.begin(), group.end());
+			return true;
+		}
+
+		int parseCount() {
+			if (pos >= text.length() || !isdigit(static_cast<unsigned char>(text[pos])))
+				return 1;
+			int n = 0;
+			while (pos < text.length() && isdigit(static_cast<unsigned char>(text[pos]))) {
+				n = std::min(n * 10 + (text[pos] - '0'), 1000000);
+				pos++;
+			}
+			return n;
+		}
+
+		bool expect(char c) {
+			skipSpace();
+			if (pos >= text.length() || text[pos] != c)
+				return fail("expected '" + std::string(1, c) + "'");
+			pos++;
+			return true;
+		}
+
+		void skipSpace() {
+			while (pos < text.length() && isspace(static_cast<unsigned char>(text[pos])))
+				pos++;
+		}
+
+		bool fail(const std::string& message) {
+			error = "column " + std::to_string(pos + 1) + ": " + message;
+			return false;
+		}
+
+		const std::string& text;
+		uint16_t size;
+		size_t pos = 0;
+	};
+
+	template <>
+	bool Parser<Move>::parseMove(std::vector<Move>& moves) {
+		int base = baseOfLetter(text[pos]);
+		if (base < 0)
+			return fail("unknown move '" + std::string(1, text[pos]) + "'");
+		pos++;
+
+		// Rw is the same as r
+		if (base < 6 && pos < text.length() && text[pos] == 'w') {
+			base += 9;
+			pos++;
+		}
+
+		int n = parseCount();
+		if (pos < text.length() && (text[pos] == '\'' || text[pos] == 'i')) {
+			n = -n;
+			pos++;
+		}
+
+		Move move = moveOf(base, n);
+		if (move != MoveCount)
+			moves.push_back(move);
+		return true;
+	}
+
+	// face moves take layer numbers in front: 3R is the third layer alone, 3Rw (3r) the outer three and 2-3Rw the
+	// second and third
+	template <>
+	bool Parser<LayerMove>::parseMove(std::vector<LayerMove>& moves) {
+		bool numbered = isdigit(static_cast<unsigned char>(text[pos])) != 0;
+		bool range = false;
+		int first = 0, last = 0;
+		if (numbered) {
+			last = parseCount();
+			if (pos < text.length() && text[pos] == '-') {
+				pos++;
+				if (pos >= text.length() || !isdigit(static_cast<unsigned char>(text[pos])))
+					return fail("expected a layer number");
+				first = last;
+				last = parseCount();
+				range = true;
+			}
+			if (pos >= text.length())
+				return fail("expected a face move");
+		}
+
+		int base = baseOfLetter(text[pos]);
+		if (base < 0)
+			return fail("unknown move '" + std::string(1, text[pos]) + "'");
+
+		// Rw and r are the same, both wide
+		bool wide = base >= 9 && base < 15;
+		if (wide)
+			base -= 9;
+		pos++;
+		if (base < 6 && pos < text.length() && text[pos] == 'w') {
+			wide = true;
+			pos++;
+		}
+		if (numbered && base >= 6)
+			return fail("layer numbers only go with face moves");
+
+		if (!numbered) {
+			first = 1;
+			last = wide ? 2 : 1;
+		}
+		else if (!range) {
+			first = wide ? 1 : last;
+		}
+		if (first < 1 || first > last || last > size)
+			return fail("no layers " + std::to_string(first) + "-" + std::to_string(last) + " on a " +
+				std::to_string(size) + "x" + std::to_string(size));
+
+		int n = parseCount();
+		if (pos < text.length() && (text[pos] == '\'' || text[pos] == 'i')) {
+			n = -n;
+			pos++;
+		}
+
+		Move move = moveOf(base, n);
+		if (move != MoveCount)
+			moves.push_back(LayerMove(move, static_cast<uint16_t>(first), static_cast<uint16_t>(last)));
+		return true;
+	}
+
+	// quarter turns of each of the 3 layers along an axis, 2 bits per layer
+	int addLayers(int state, const CubeTurn& turn) {
+		for (int layer = 0; layer < 3; layer++) {
+			if (turn.layers & (1 << layer)) {
+				int shift = layer * 2;
+				int quarters = ((state >> shift) + turn.quarterTurns) & 3;
+				state = (state & ~(3 << shift)) | (quarters << shift);
+			}
+		}
+		return state;
+	}
+
+	// fewest moves reaching every combination of layer turns on each axis, found breadth first once. at most 3 are
+	// needed, one per layer. moves are tried in Move order so faces win over slices, wide moves and rotations on ties
+	struct AxisTables {
+		std::vector<Move> shortest[3][64];
+
+		AxisTables() {
+			for (int axis = 0; axis < 3; axis++) {
+				bool found[64] = {};
+				found[0] = true;
+				std::vector<int> frontier = { 0 };
+				while (!frontier.empty()) {
+					std::vector<int> next;
+					for (int state : frontier) {
+						for (int m = 0; m < MoveCount; m++) {
+							auto& turn = getMoveInfo(static_cast<Move>(m)).turn;
+							if (turn.axis != axis)
+								continue;
+							int reached = addLayers(state, turn);
+							if (found[reached])
+								continue;
+							found[reached] = true;
+							shortest[axis][reached] = shortest[axis][state];
+							shortest[axis][reached].push_back(static_cast<Move>(m));
+							next.push_back(reached);
+						}
+					}
+					frontier.swap(next);
+				}
+			}
+		}
+	};
+
+	const AxisTables& getAxisTables() {
+		static AxisTables axisTables;
+		return axisTables;
+	}
+}
+
+
+bool compileNotation(const std::string& text, std::vector<Move>& moves, std::string* error) {
+	Parser<Move> parser(text);
+	std::vector<Move> compiled;
+	if (!parser.parse(compiled)) {
+		if (error)
+			*error = parser.error;
+		return false;
+	}
+	moves.insert(moves.end(), compiled.begin(), compiled.end());
+	return true;
+}
+
+bool compileNotation(const std::string& text, uint16_t size, std::vector<LayerMove>& moves, std::string* error) {
+	Parser<LayerMove> parser(text, size);
+	std::vector<LayerMove> compiled;
+	if (!parser.parse(compiled)) {
+		if (error)
+			*error = parser.error;
+		return false;
+	}
+	moves.insert(moves.end(), compiled.begin(), compiled.end());
+	return true;
+}
+
+void simplifyMoves(std::vector<Move>& moves) {
+	auto& tables = getAxisTables();
+
+	// moves on one axis commute, so each run of them only matters by its net turn per layer. merging a run can empty it
+	// and bring two runs on the same axis together, which then merge in turn as the output is built
+	std::vector<Move> simplified;
+	for (auto move : moves) {
+		int axis = getMoveInfo(move).turn.axis;
+
+		// take the trailing run of the output back with the same axis and fold the new move into it
+		int state = 0;
+		while (!simplified.empty() && getMoveInfo(simplified.back()).turn.axis == axis) {
+			state = addLayers(state, getMoveInfo(simplified.back()).turn);
+			simplified.pop_back();
+		}
+		state = addLayers(state, getMoveInfo(move).turn);
+
+		auto& shortest = tables.shortest[axis][state];
+		simplified.insert(simplified.end(), shortest.begin(), shortest.end());
+	}
+	moves.swap(simplified);
+}
+
+void invertMoves(std::vector<Move>& moves) {
+	std::reverse(moves.begin(), moves.end());
+	for (auto& move : moves)
+		move = getInverseMove(move);
+}
+
+std::string toNotation(const std::vector<Move>& moves) {
+	std::string text;
+	for (auto move : moves) {
+		if (!text.empty())
+			text += ' ';
+		text += getMoveInfo(move).notation;
+	}
+	return text;
+}
+
+void invertMoves(std::vector<LayerMove>& moves) {
+	std::reverse(moves.begin(), moves.end());
+	for (auto& move : moves)
+		move = getInverseMove(move);
+}
+
+std::string toNotation(const std::vector<LayerMove>& moves) {
+	std::string text;
+	for (auto& move : moves) {
+		if (!text.empty())
+			text += ' ';
+		auto notation = getMoveInfo(move.base).notation;
+		if (!move.isFaceMove()) {
+			text += notation;
+			continue;
+		}
+
+		// shortest form: R, Rw, 3Rw, 3R or 2-3Rw
+		bool wide = move.first != move.last || move.first > 1;
+		if (move.first == 1 && move.last > 2)
+			text += std::to_string(move.last);
+		else if (move.first > 1 && move.first == move.last) {
+			text += std::to_string(move.first);
+			wide = false;
+		}
+		else if (move.first > 1)
+			text += std::to_string(move.first) + "-" + std::to_string(move.last);
+		text += notation[0];
+		if (wide)
+			text += 'w';
+		text += notation + 1;
+	}
+	return text;
+}
@@ -0,0 +1,33 @@
+// cube notation compiler
+#pragma once
+#include "CubeModel.h"
+#include "CubeModelNxN.h"
+
+#include <string>
+#include <vector>
+
+constexpr size_t MaxCompiledMoves = 100000;										// guard against repeat counts blowing up
+
+// compile standard notation into move ids:
+//  - faces R L U F D B, slices M E S, wide moves Rw or r, rotations x y z (X Y Z)
+//  - a turn count and/or prime after a move: R2, R', R2', R3. the legacy "i" suffix (Ri) still works
+//  - groups with a repeat count and optional prime: (R U R' U')6, (R U)'
+//  - commutators [A, B] = A B A' B' and conjugates [A: B] = A B A', both nest
+// returns false and fills error (if given) with the position and cause when the text is not valid
+bool compileNotation(const std::string& text, std::vector<Move>& moves, std::string* error = nullptr);
+
+// the same for a cube of the given size, with layer numbers before face moves: 3R turns the third layer alone, 3Rw (or
+// 3r) the outer three and 2-3Rw the second and third. R and Rw stay the outer one and two layers, slices M E S turn
+// every layer between the outer ones
+bool compileNotation(const std::string& text, uint16_t size, std::vector<LayerMove>& moves, std::string* error = nullptr);
+
+// merge runs of consecutive moves on the same axis into the fewest moves with the same effect, eg. R R' vanishes,
+// R R becomes R2 and R M' L' becomes x'
+void simplifyMoves(std::vector<Move>& moves);
+
+// inverse sequence, reversed with every move inverted
+void invertMoves(std::vector<Move>& moves);
+void invertMoves(std::vector<LayerMove>& moves);
+
+std::string toNotation(const std::vector<Move>& moves);
+std::string toNotation(const std::vector<LayerMove>& moves);
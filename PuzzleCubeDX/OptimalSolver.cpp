@@ -0,0 +1,365 @@
+#include "OptimalSolver.h"
+#include "Scheduler.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <mutex>
+
+namespace {
+	const char DatabaseMagic[4] = { 'P', 'C', 'P', 'D' };
+	const uint32_t DatabaseVersion = 1;
+	const uint8_t NumMoves = 18;
+	const uint8_t Unvisited = DistanceTable::Unvisited;
+	const uint32_t EdgeGroupSize = 6;
+
+	struct DatabaseHeader {
+		char magic[4];
+		uint32_t version;
+		uint32_t cornerStates;
+		uint32_t edgeStates;
+	};
+
+	const size_t CornerBytes = NumCornerStates / 2;
+	const size_t EdgeBytes = NumEdgeStates / 2;
+	const size_t DatabaseSize = sizeof(DatabaseHeader) + CornerBytes + 2 * EdgeBytes;
+
+	// the same layout as DistanceTable, two entries per byte with the even index in the low nibble
+	inline uint8_t getEntry(const uint8_t* table, uint32_t index) {
+		return DistanceTable::get(table, index);
+	}
+
+	inline uint8_t getEntry(const std::atomic<uint8_t>* table, uint32_t index) {
+		return DistanceTable::get(table, index);
+	}
+
+	inline bool setEntry(std::atomic<uint8_t>* table, uint32_t index, uint8_t value) {
+		return DistanceTable::setUnvisited(table, index, value);
+	}
+
+	bool isRedundant(uint8_t move, int previous) {
+		if (previous < 0)
+			return false;
+		int face = move / 3, previousFace = previous / 3;
+		if (face == previousFace)
+			return true;
+		return getMoveInfo(static_cast<Move>(move)).turn.axis == getMoveInfo(static_cast<Move>(previous)).turn.axis && face < previousFace;
+	}
+
+	// edges firstEdge .. firstEdge + 5 of a cube as a position rank and a flip bit per tracked edge
+	void getEdgeGroup(const CubieCube& cube, uint8_t firstEdge, uint32_t& position, uint8_t& flip) {
+		uint8_t slots[EdgeGroupSize];
+		flip = 0;
+		for (uint8_t slot = 0; slot < EdgeCount; slot++) {
+			uint8_t k = cube.ep[slot] - firstEdge;
+			if (k < EdgeGroupSize) {
+				slots[k] = slot;
+				flip |= cube.eo[slot] << k;
+			}
+		}
+		position = rankPartialPermutation(slots, EdgeGroupSize, EdgeCount);
+	}
+
+	// breadth first from the solved state, one sweep over the table per depth. early depths push from the frontier to
+	// its unvisited neighbours, once the frontier outgrows what is left the unvisited entries look for a neighbour in
+	// the frontier instead, which stops at the first hit
+	template <typename Neighbour>
+	void buildDatabase(ThreadPool& pool, std::atomic<uint8_t>* table, uint32_t size, uint32_t solved, Neighbour neighbour) {
+		for (uint32_t i = 0; i < size / 2; i++)
+			table[i].store(0xff, std::memory_order_relaxed);
+		setEntry(table, solved, 0);
+
+		const uint32_t grainSize = 1 << 16;
+		uint64_t frontier = 1, remaining = size - 1;
+		for (uint8_t depth = 0; remaining > 0 && frontier > 0; depth++) {
+			std::atomic<uint64_t> found{ 0 };
+			bool backward = frontier > remaining;
+
+			pool.parallelFor(size, grainSize, [&](UINT begin, UINT end) {
+				uint64_t count = 0;
+				for (uint32_t i = begin; i < end; i++) {
+					uint8_t entry = getEntry(table, i);
+					if (backward) {
+						if (entry != Unvisited)
+							continue;
+						for (uint8_t m = 0; m < NumMoves; m++) {
+							if (getEntry(table, neighbour(i, m)) == depth) {
+								count += setEntry(table, i, depth + 1);
+								break;
+							}
+						}
+					}
+					else if (entry == depth) {
+						for (uint8_t m = 0; m < NumMoves; m++)
+							count += setEntry(table, neighbour(i, m), depth + 1);
+					}
+				}
+				found += count;
+			});
+
+			frontier = found;
+			remaining -= frontier;
+			LOG_DEBUG(Solver, "pattern database depth %u: %llu states", depth + 1, static_cast<unsigned long long>(frontier));
+		}
+	}
+
+	struct SearchState {
+		uint16_t cornerPerm, twist;
+		uint32_t edgePosition[2];
+		uint8_t edgeFlip[2];
+	};
+}
+
+
+// one subtree of an iteration, every job has its own path and node count
+struct OptimalSearch {
+	const OptimalSolver& solver;
+	const std::atomic<bool>& stop;
+	Move path[32];
+	uint64_t nodes = 0;
+
+	OptimalSearch(const OptimalSolver& solver, const std::atomic<bool>& stop) : solver(solver), stop(stop) {}
+
+	SearchState apply(const SearchState& state, uint8_t m) const {
+		SearchState next;
+		next.cornerPerm = solver.cornerPermMove[state.cornerPerm * NumMoves + m];
+		next.twist = solver.twistMove[state.twist * NumMoves + m];
+		for (int g = 0; g < 2; g++) {
+			uint32_t entry = state.edgePosition[g] * NumMoves + m;
+			next.edgePosition[g] = solver.edgePositionMove[entry];
+			next.edgeFlip[g] = state.edgeFlip[g] ^ solver.edgeFlipMove[entry];
+		}
+		return next;
+	}
+
+	// a lower bound on the moves left
+	uint8_t getDistance(const SearchState& state) const {
+		uint8_t distance = getEntry(solver.cornerDatabase, state.cornerPerm * NumTwist + state.twist);
+		for (int g = 0; g < 2; g++)
+			distance = std::max(distance, getEntry(solver.edgeDatabases[g], state.edgePosition[g] * 64 + state.edgeFlip[g]));
+		return distance;
+	}
+
+	// getDistance(state) < togo, the corners first since they prune the most. every lookup is a likely cache miss so
+	// the edge tables are only read when the corners did not prune
+	bool isWithin(const SearchState& state, uint8_t togo) const {
+		return getEntry(solver.cornerDatabase, state.cornerPerm * NumTwist + state.twist) < togo &&
+			getEntry(solver.edgeDatabases[0], state.edgePosition[0] * 64 + state.edgeFlip[0]) < togo &&
+			getEntry(solver.edgeDatabases[1], state.edgePosition[1] * 64 + state.edgeFlip[1]) < togo;
+	}
+
+	bool search(const SearchState& state, uint8_t depth, uint8_t togo) {
+		if (togo == 0)
+			return getDistance(state) == 0;
+		if (stop.load(std::memory_order_relaxed))
+			return false;
+
+		for (uint8_t m = 0; m < NumMoves; m++) {
+			if (isRedundant(m, depth > 0 ? path[depth - 1] : -1))
+				continue;
+
+			// nodes counts every generated state, pruned or not
+			nodes++;
+			SearchState next = apply(state, m);
+			if (!isWithin(next, togo))
+				continue;
+
+			path[depth] = static_cast<Move>(m);
+			if (search(next, depth + 1, togo - 1))
+				return true;
+		}
+		return false;
+	}
+};
+
+
+OptimalSolver::OptimalSolver() {
+
+}
+
+OptimalSolver::~OptimalSolver() {
+
+}
+
+bool OptimalSolver::init(const std::string& path) {
+	auto startTime = std::chrono::steady_clock::now();
+	threadPool = std::make_unique<ThreadPool>();
+	buildMoveTables();
+
+	if (!mapDatabases(path)) {
+		LOG_INFO(Solver, "generating pattern databases %s", path.c_str());
+		if (!generateDatabases(path) || !mapDatabases(path)) {
+			LOG_ERROR(Solver, "could not create pattern databases %s", path.c_str());
+			return false;
+		}
+	}
+
+	LOG_INFO(Solver, "pattern databases ready in %.2fs", std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count());
+	ready.store(true, std::memory_order_release);
+	return true;
+}
+
+bool OptimalSolver::isReady() const {
+	return ready.load(std::memory_order_acquire);
+}
+
+void OptimalSolver::buildMoveTables() {
+	Move faceMoves[NumMoves];
+	for (uint8_t m = 0; m < NumMoves; m++)
+		faceMoves[m] = static_cast<Move>(m);
+
+	buildMoveTable<CornerPermCoord>(cornerPermMove, faceMoves, NumMoves);
+	buildMoveTable<TwistCoord>(twistMove, faceMoves, NumMoves);
+
+	// the tracked edges are 0..5 on an otherwise arbitrary cube, the other group moves the same way. the flips are
+	// collected next to the positions, so no separate flip coordinate is needed
+	typedef EdgePositionCoord<0> EdgeCoord;
+	edgePositionMove.resize(EdgeCoord::Size * NumMoves);
+	edgeFlipMove.resize(EdgeCoord::Size * NumMoves);
+	threadPool->parallelFor(EdgeCoord::Size, 4096, [this](UINT begin, UINT end) {
+		CubieCube cube;
+		for (uint32_t rank = begin; rank < end; rank++) {
+			EdgeCoord::set(cube, rank);
+			for (uint8_t m = 0; m < NumMoves; m++) {
+				CubieCube moved = cube;
+				EdgeCoord::multiply(moved, CubieCube::getMoveCube(static_cast<Move>(m)));
+				getEdgeGroup(moved, 0, edgePositionMove[rank * NumMoves + m], edgeFlipMove[rank * NumMoves + m]);
+			}
+		}
+	});
+}
+
+bool OptimalSolver::generateDatabases(const std::string& path) {
+	static_assert(sizeof(std::atomic<uint8_t>) == 1, "databases are written straight from the atomic tables");
+
+	// written to a temporary name and renamed, so a process mapping the file never sees half of it
+	std::string tempPath = path + ".tmp";
+	std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+	if (!out)
+		return false;
+
+	DatabaseHeader header;
+	std::copy(DatabaseMagic, DatabaseMagic + 4, header.magic);
+	header.version = DatabaseVersion;
+	header.cornerStates = NumCornerStates;
+	header.edgeStates = NumEdgeStates;
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	std::unique_ptr<std::atomic<uint8_t>[]> table(new std::atomic<uint8_t>[CornerBytes]);
+	buildDatabase(*threadPool, table.get(), NumCornerStates, 0, [this](uint32_t index, uint8_t m) {
+		return static_cast<uint32_t>(cornerPermMove[(index / NumTwist) * NumMoves + m]) * NumTwist + twistMove[(index % NumTwist) * NumMoves + m];
+	});
+	out.write(reinterpret_cast<const char*>(table.get()), CornerBytes);
+
+	// the groups only differ in where their solved state is
+	table.reset(new std::atomic<uint8_t>[EdgeBytes]);
+	for (uint8_t firstEdge = 0; firstEdge < EdgeCount; firstEdge += EdgeGroupSize) {
+		uint32_t solvedPosition;
+		uint8_t solvedFlip;
+		getEdgeGroup(CubieCube(), firstEdge, solvedPosition, solvedFlip);
+
+		buildDatabase(*threadPool, table.get(), NumEdgeStates, solvedPosition * 64, [this](uint32_t index, uint8_t m) {
+			uint32_t entry = (index / 64) * NumMoves + m;
+			return edgePositionMove[entry] * 64 + ((index % 64) ^ edgeFlipMove[entry]);
+		});
+		out.write(reinterpret_cast<const char*>(table.get()), EdgeBytes);
+	}
+
+	out.close();
+	if (!out || !replaceFile(tempPath, path)) {
+		std::remove(tempPath.c_str());
+		return false;
+	}
+	return true;
+}
+
+bool OptimalSolver::mapDatabases(const std::string& path) {
+	if (!file.open(path))
+		return false;
+
+	auto header = reinterpret_cast<const DatabaseHeader*>(file.getData());
+	if (file.getSize() != DatabaseSize || !std::equal(DatabaseMagic, DatabaseMagic + 4, header->magic) ||
+		header->version != DatabaseVersion || header->cornerStates != NumCornerStates || header->edgeStates != NumEdgeStates) {
+		LOG_WARN(Solver, "ignoring pattern databases %s, wrong format", path.c_str());
+		file.close();
+		return false;
+	}
+
+	cornerDatabase = file.getData() + sizeof(DatabaseHeader);
+	edgeDatabases[0] = cornerDatabase + CornerBytes;
+	edgeDatabases[1] = edgeDatabases[0] + EdgeBytes;
+	return true;
+}
+
+bool OptimalSolver::solve(const CubeModel& cube, std::vector<Move>& solution, SolveStats* stats, uint8_t maxLength) const {
+	CubieCube cubie;
+	if (!cubie.fromFacelets(cube))
+		return false;
+	return solve(cubie, solution, stats, maxLength);
+}
+
+bool OptimalSolver::solve(const CubieCube& cube, std::vector<Move>& solution, SolveStats* stats, uint8_t maxLength) const {
+	if (!isReady())
+		return false;
+
+	auto startTime = std::chrono::steady_clock::now();
+	SearchState start;
+	start.cornerPerm = cube.getCornerPerm();
+	start.twist = cube.getTwist();
+	getEdgeGroup(cube, 0, start.edgePosition[0], start.edgeFlip[0]);
+	getEdgeGroup(cube, EdgeGroupSize, start.edgePosition[1], start.edgeFlip[1]);
+
+	std::atomic<bool> found{ false };
+	std::atomic<uint64_t> nodes{ 0 };
+	std::mutex solutionMutex;
+	maxLength = std::min<uint8_t>(maxLength, 31);
+
+	OptimalSearch root(*this, found);
+	uint8_t distance = root.getDistance(start);
+	if (distance == 0) {
+		solution.clear();
+		found = true;
+	}
+
+	for (uint8_t bound = std::max<uint8_t>(distance, 1); bound <= maxLength && !found; bound++) {
+		// the first two moves of the tree are the jobs, the rest of each subtree is searched on one thread
+		std::vector<std::function<void()>> jobs;
+		for (uint8_t m1 = 0; m1 < NumMoves; m1++) {
+			for (uint8_t m2 = 0; m2 < NumMoves; m2++) {
+				if (bound >= 2 ? isRedundant(m2, m1) : m2 > 0)
+					continue;
+
+				jobs.push_back([&, m1, m2] {
+					OptimalSearch search(*this, found);
+					uint8_t depth = bound >= 2 ? 2 : 1;
+					SearchState state = search.apply(start, m1);
+					search.path[0] = static_cast<Move>(m1);
+					if (depth == 2) {
+						state = search.apply(state, m2);
+						search.path[1] = static_cast<Move>(m2);
+					}
+
+					if (!found && search.isWithin(state, bound - depth + 1) && search.search(state, depth, bound - depth)) {
+						std::lock_guard<std::mutex> lock(solutionMutex);
+						if (!found.exchange(true))
+							solution.assign(search.path, search.path + bound);
+					}
+					nodes += search.nodes + depth;
+				});
+			}
+		}
+		threadPool->run(jobs);
+	}
+
+	SolveStats result;
+	result.nodes = nodes;
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	LOG_DEBUG(Solver, "optimal search: %zu moves, %llu nodes, %.2fM nodes/s", found ? solution.size() : 0,
+		static_cast<unsigned long long>(result.nodes), result.getNodesPerSecond() / 1e6);
+	if (stats)
+		*stats = result;
+	return found;
+}
@@ -0,0 +1,56 @@
+// optimal cube solver
+#pragma once
+#include "CubieCube.h"
+#include "Coordinates.h"
+#include "MappedFile.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+constexpr uint32_t NumEdgePositions = EdgePositionCoord<0>::Size;				// 12! / 6! places of 6 tracked edges
+constexpr uint32_t NumCornerStates = NumCornerPerm * NumTwist;					// 88179840
+constexpr uint32_t NumEdgeStates = NumEdgePositions * 64;						// 42577920, with 2^6 flips
+
+// Korf's IDA* with pattern databases. the heuristic is the max of the exact distances of the corners alone and of two
+// groups of 6 edges alone (UR UF UL UB DR DF and DL DB FR FL BL BR), so every solution found is the shortest one.
+// the databases hold one distance per state in 4 bits, about 86MB on disk. they are generated once, then mapped read
+// only so every process solving at the same time shares the same pages
+class OptimalSolver {
+public:
+	OptimalSolver();
+	~OptimalSolver();
+
+	// map the databases in path, generating the file first if it is missing or from another version. generating runs
+	// a breadth first search over every state on all cores, expect tens of seconds
+	bool init(const std::string& path);
+	bool isReady() const;
+
+	// shortest sequence of face moves solving the cube, if there is one of at most maxLength moves. the tree below the
+	// first two moves is split over the worker threads. stats (if given) gets the nodes visited and the time taken
+	bool solve(const CubeModel& cube, std::vector<Move>& solution, SolveStats* stats = nullptr, uint8_t maxLength = 20) const;
+	bool solve(const CubieCube& cube, std::vector<Move>& solution, SolveStats* stats = nullptr, uint8_t maxLength = 20) const;
+
+private:
+	friend struct OptimalSearch;
+
+	void buildMoveTables();
+	bool generateDatabases(const std::string& path);
+	bool mapDatabases(const std::string& path);
+
+	// move tables, coordinate * 18 + move
+	std::vector<uint16_t> cornerPermMove;
+	std::vector<uint16_t> twistMove;
+	std::vector<uint32_t> edgePositionMove;										// same table for both edge groups
+	std::vector<uint8_t> edgeFlipMove;											// tracked edges flipped by the move, bit per edge
+
+	MappedFile file;
+	const uint8_t* cornerDatabase = nullptr;									// cornerPerm * NumTwist + twist
+	const uint8_t* edgeDatabases[2] = {};										// edgePosition * 64 + flips
+
+	std::unique_ptr<ThreadPool> threadPool;
+	std::atomic<bool> ready{ false };
+};
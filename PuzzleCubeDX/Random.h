@@ -0,0 +1,54 @@
+// seedable pseudo random numbers
+#pragma once
+#include <cstdint>
+
+// xoshiro256** seeded through splitmix64. much faster than rand() with far better statistics, and a seed gives the
+// same sequence on every platform and compiler. one instance per thread, it is not synchronized
+class Random {
+public:
+	Random(uint64_t seed = 0) {
+		setSeed(seed);
+	}
+
+	// stream picks one of many independent sequences for the same seed, eg. one per scramble of a bulk run
+	void setSeed(uint64_t seed, uint64_t stream = 0) {
+		uint64_t x = seed ^ (stream * 0xd1342543de82ef95ull);
+		for (auto& s : state) {
+			x += 0x9e3779b97f4a7c15ull;
+			uint64_t z = x;
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+			s = z ^ (z >> 31);
+		}
+	}
+
+	uint64_t next() {
+		uint64_t result = rotl(state[1] * 5, 7) * 9;
+		uint64_t t = state[1] << 17;
+		state[2] ^= state[0];
+		state[3] ^= state[1];
+		state[1] ^= state[2];
+		state[0] ^= state[3];
+		state[2] ^= t;
+		state[3] = rotl(state[3], 45);
+		return result;
+	}
+
+	// uniform in [0, bound) without the bias of next() % bound (Lemire's multiply and reject)
+	uint32_t below(uint32_t bound) {
+		uint64_t product = (next() >> 32) * bound;
+		if (static_cast<uint32_t>(product) < bound) {
+			uint32_t threshold = (0u - bound) % bound;
+			while (static_cast<uint32_t>(product) < threshold)
+				product = (next() >> 32) * bound;
+		}
+		return static_cast<uint32_t>(product >> 32);
+	}
+
+private:
+	static uint64_t rotl(uint64_t x, int k) {
+		return (x << k) | (x >> (64 - k));
+	}
+
+	uint64_t state[4];
+};
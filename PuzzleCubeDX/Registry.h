@@ -1,137 +1,475 @@
-// entity registry
-#pragma once
-#include "Components.h"
-
-#include <bitset>
-#include <algorithm>
-
-#include <iostream>
-
-
-// component pool init
-constexpr UINT MaxComponents = 16;
-constexpr UINT MaxEntities = 256;									// small project 256 entities is fine
-
-// bitset to quickly identify what components an entity has
-typedef std::bitset<MaxComponents> Signature;
-
-class IComponent {
-public:
-	static UINT nextID;
-};
-
-template <typename T>
-class Component : public IComponent {
-public:
-	static UINT getID() {
-		static UINT typeID = nextID++;
-		return typeID;
-	}
-};
-
-class IPool {
-public:
-	virtual ~IPool() = default;
-};
-
-// pools created for each type of component. eg, Pool<CTransform> stores all CTransform components of all entities. 
-// Accessed by using entity id as index for the compData vector. eg, entity id = 0; compData[0] => gives CTransform of 0th index entity 
-template <typename T>
-class Pool : public IPool{
-public:
-	Pool() { 
-		compData.resize(MaxEntities);							// reserve comp data for maxentities
-	}
-	std::vector<T> compData;
-};
-
-
-class Registry {
-public:
-	Registry() : currentEntity(0), nextEntity(0) {
-		signatures.resize(MaxEntities);
-	}
-
-
-	UINT createEntity() {
-		currentEntity = nextEntity;
-		entities.push_back(nextEntity++);
-		return currentEntity;
-	}
-
-	template <typename T, typename ...TArgs>
-	T& addComponent(UINT entity, TArgs&& ...args) {
-		auto compTypeID = Component<T>::getID();
-
-		// resize pool vector to store new component pool data
-		if (compTypeID >= compPools.size()) {
-			compPools.resize(compTypeID + 1, nullptr);
-		}
-		
-		if (!compPools[compTypeID]) {
-			compPools[compTypeID] = std::make_shared<Pool<T>>();
-		}
-
-		// get that component's pool
-		std::shared_ptr<Pool<T>> compPool = std::static_pointer_cast<Pool<T>>(compPools[compTypeID]);
-
-		T component(std::forward<TArgs>(args)...);
-		compPool->compData.size();
-		compPool->compData[entity] = component;
-
-		// set signature for entity
-		signatures[entity].set(compTypeID);
-
-		auto str = signatures[entity].to_string();
-		std::cout << str << std::endl;
-
-		return compPool->compData[entity];
-	}
-	
-	template <typename T>
-	T& getComponent(UINT entity) {
-		auto compTypeID = Component<T>::getID();
-		
-		std::shared_ptr<Pool<T>> compPool = std::static_pointer_cast<Pool<T>>(compPools[compTypeID]);
-
-		return static_cast<T&>(compPool->compData[entity]);
-	}
-
-	template <typename T>
-	bool hasComponent(UINT& entity) {
-		// check if entity has that comp from its signature
-		auto compTypeID = Component<T>::getID();
-		return signatures[entity].test(compTypeID);
-	}
-
-	// used by system to generate signatures to then get entities that possess those specific components
-	template <typename T>
-	UINT getComponentTypeID() {
-		return Component<T>::getID();
-	}
-
-	std::vector<UINT> getEntitiesFromSignature(Signature& signatureMatch) {
-		std::vector<UINT> signatureEntities;
-		
-		UINT index = 0;
-		std::for_each(signatures.begin(), signatures.end(), [&](const auto& signature) {
-			auto result = signature & signatureMatch;
-
-			if (result.any())
-				signatureEntities.push_back(index);
-			index++;
-			});
-
-		return signatureEntities;
-	}
-
-private:
-
-	std::vector<std::shared_ptr<IPool>> compPools;
-	std::vector<Signature> signatures;										//signatures of each entity
-
-	std::vector<UINT> entities;
-	UINT currentEntity;
-	UINT nextEntity;
-
-};
+// entity registry
+#pragma once
+#include "Entity.h"
+#include "Log.h"
+
+#include <bitset>
+#include <algorithm>
+#include <cassert>
+#include <vector>
+#include <memory>
+#include <tuple>
+
+
+
+// component pool init
+constexpr UINT MaxComponents = 16;
+constexpr UINT EntityChunkSize = 1024;								// entity slots and component storage grow by this many at a time
+constexpr UINT InvalidIndex = ~0u;									// empty slot in sparse index arrays
+
+// bitset to quickly identify what components an entity has
+typedef std::bitset<MaxComponents> Signature;
+
+class IComponent {
+public:
+	static UINT nextID;
+};
+
+template <typename T>
+class Component : public IComponent {
+public:
+	static UINT getID() {
+		static UINT typeID = nextID++;
+		return typeID;
+	}
+};
+
+class IPool {
+public:
+	virtual ~IPool() = default;
+	virtual void remove(UINT entity, UINT tick) = 0;
+};
+
+// grows one fixed size chunk at a time, so growing never moves existing elements and references stay valid.
+// elements inside a chunk are contiguous
+template <typename T>
+class ChunkedArray {
+public:
+	T& operator[](UINT index) {
+		return chunks[index / EntityChunkSize][index % EntityChunkSize];
+	}
+
+	T& back() {
+		return (*this)[count - 1];
+	}
+
+	void push_back(T&& value) {
+		if (count == chunks.size() * EntityChunkSize)
+			chunks.push_back(std::make_unique<T[]>(EntityChunkSize));
+		(*this)[count++] = std::move(value);
+	}
+
+	void pop_back() {
+		// reset the slot so components holding memory (eg. CHierarchy children) release it now
+		back() = T();
+		count--;
+	}
+
+	UINT size() const {
+		return count;
+	}
+
+private:
+	std::vector<std::unique_ptr<T[]>> chunks;
+	UINT count = 0;
+};
+
+// pools created for each type of component. eg, Pool<CTransform> stores all CTransform components of all entities.
+// Sparse set: sparse[entity index] gives the index into the packed dense arrays, so compData and entities have no holes.
+// eg, entity index = 5 with sparse[5] = 0; compData[0] => gives CTransform of entity 5 and entities[0] == handle of entity 5
+// removing swaps the last component into the hole, which moves that one component. growing never moves components.
+// the dense side keeps full handles, so a stale handle to a recycled slot does not match the new owner's component
+template <typename T>
+class Pool : public IPool{
+public:
+	bool has(UINT entity) const {
+		UINT index = entityIndex(entity);
+		return index < sparse.size() && sparse[index] != InvalidIndex && entities[sparse[index]] == entity;
+	}
+
+	T& insert(UINT entity, T&& component, UINT tick) {
+		UINT index = entityIndex(entity);
+
+		// overwrite if entity already has this component
+		if (has(entity)) {
+			compData[sparse[index]] = std::move(component);
+			stamp(sparse[index], tick);
+			return compData[sparse[index]];
+		}
+
+		// sparse index only grows to the chunk holding the highest entity that owns this component
+		if (index >= sparse.size())
+			sparse.resize((index / EntityChunkSize + 1) * EntityChunkSize, InvalidIndex);
+
+		sparse[index] = compData.size();
+		structureVersion++;
+		entities.push_back(entity);
+		changeTicks.push_back(tick);
+		logChange(entity, tick);
+		compData.push_back(std::move(component));
+		return compData.back();
+	}
+
+	// the component moved into the hole counts as changed at tick, its dense index (eg. a cbuffer slot) is new
+	void remove(UINT entity, UINT tick) override {
+		if (!has(entity))
+			return;
+
+		UINT index = entityIndex(entity);
+		UINT denseIndex = sparse[index];
+		UINT last = compData.size() - 1;
+
+		// move last component into the hole
+		if (denseIndex != last) {
+			compData[denseIndex] = std::move(compData[last]);
+			entities[denseIndex] = entities[last];
+			changeTicks[denseIndex] = changeTicks[last];
+			sparse[entityIndex(entities[denseIndex])] = denseIndex;
+			stamp(denseIndex, tick);
+		}
+
+		compData.pop_back();
+		entities.pop_back();
+		changeTicks.pop_back();
+		sparse[index] = InvalidIndex;
+		structureVersion++;
+	}
+
+	T& get(UINT entity) {
+		assert(has(entity));
+		return compData[sparse[entityIndex(entity)]];
+	}
+
+	UINT size() const {
+		return compData.size();
+	}
+
+	void markChanged(UINT entity, UINT tick) {
+		assert(has(entity));
+		stamp(sparse[entityIndex(entity)], tick);
+	}
+
+	bool changedSince(UINT entity, UINT tick) const {
+		assert(has(entity));
+		return changeTicks[sparse[entityIndex(entity)]] > tick;
+	}
+
+	// entities whose component changed after tick, without walking the whole pool: the change log is in tick order, so
+	// only its tail past tick is read. an entry counts while it is the entity's latest stamp
+	void getChanged(UINT tick, std::vector<UINT>& changed) const {
+		auto first = std::partition_point(changeLog.begin(), changeLog.end(), [tick](const Change& c) { return c.tick <= tick; });
+		for (auto it = first; it != changeLog.end(); ++it) {
+			if (isLatest(*it))
+				changed.push_back(it->entity);
+		}
+	}
+
+	std::vector<UINT> sparse;												// entity index -> dense index
+	std::vector<UINT> entities;												// dense index -> entity handle
+	std::vector<UINT> changeTicks;											// dense index -> registry tick of the last change
+	ChunkedArray<T> compData;												// packed components, same order as entities
+	UINT structureVersion = 0;												// bumped on every add and remove, dense indices may have moved
+
+private:
+	struct Change {
+		UINT entity;
+		UINT tick;
+	};
+
+	// ticks only grow, so a component is logged the first time it is stamped in a tick and the log stays in tick order
+	void stamp(UINT denseIndex, UINT tick) {
+		if (changeTicks[denseIndex] == tick)
+			return;
+		changeTicks[denseIndex] = tick;
+		logChange(entities[denseIndex], tick);
+	}
+
+	void logChange(UINT entity, UINT tick) {
+		// entries overtaken by a later stamp or a remove are dropped once they outnumber the live ones, so the log stays
+		// within a few entries per component
+		if (changeLog.size() >= 2 * size() + EntityChunkSize) {
+			changeLog.erase(std::remove_if(changeLog.begin(), changeLog.end(), [this](const Change& c) { return !isLatest(c); }),
+				changeLog.end());
+		}
+		changeLog.push_back({ entity, tick });
+	}
+
+	bool isLatest(const Change& change) const {
+		return has(change.entity) && changeTicks[sparse[entityIndex(change.entity)]] == change.tick;
+	}
+
+	std::vector<Change> changeLog;											// (entity, tick) of every stamp, oldest first
+};
+
+// cached handle to the typed pools of a fixed set of components. systems resolve it once in onInit
+// and then look up components per entity without going through the registry's pool vector
+template <typename ...T>
+class View {
+public:
+	View() = default;
+	View(Pool<T>*... pools) : pools(pools...) {}
+
+	template <typename C>
+	C& get(UINT entity) {
+		return std::get<Pool<C>*>(pools)->get(entity);
+	}
+
+	template <typename C>
+	Pool<C>& pool() {
+		return *std::get<Pool<C>*>(pools);
+	}
+
+private:
+	std::tuple<Pool<T>*...> pools;
+};
+
+typedef UINT QueryID;
+
+// registered query kept up to date by the registry as components are added. an entity matches when it has
+// every component in all, at least one component in any (skipped if any is empty) and none of the components in none
+struct Query {
+	Signature all, any, none;
+
+	std::vector<UINT> entities;												// live matching set of entity handles
+	std::vector<UINT> sparse;												// entity index -> index into entities
+
+	bool matches(const Signature& signature) const {
+		return (signature & all) == all && (any.none() || (signature & any).any()) && (signature & none).none();
+	}
+
+	bool contains(UINT entity) const {
+		UINT index = entityIndex(entity);
+		return index < sparse.size() && sparse[index] != InvalidIndex;
+	}
+
+	void insert(UINT entity) {
+		UINT index = entityIndex(entity);
+		if (index >= sparse.size())
+			sparse.resize((index / EntityChunkSize + 1) * EntityChunkSize, InvalidIndex);
+		sparse[index] = static_cast<UINT>(entities.size());
+		entities.push_back(entity);
+	}
+
+	void remove(UINT entity) {
+		// swap with last so the set stays packed
+		UINT denseIndex = sparse[entityIndex(entity)];
+		UINT last = entities.back();
+		entities[denseIndex] = last;
+		sparse[entityIndex(last)] = denseIndex;
+		entities.pop_back();
+		sparse[entityIndex(entity)] = InvalidIndex;
+	}
+};
+class Registry {
+public:
+	UINT createEntity() {
+		UINT index;
+		if (!freeSlots.empty()) {
+			// recycle a destroyed slot, its generation was bumped on destroy
+			index = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		else {
+			index = static_cast<UINT>(entities.size());
+
+			// grow slot storage one chunk at a time
+			if (index == signatures.size()) {
+				signatures.resize(signatures.size() + EntityChunkSize);
+				generations.resize(generations.size() + EntityChunkSize, 0);
+			}
+			entities.push_back(NullEntity);
+		}
+
+		UINT entity = makeEntity(index, generations[index]);
+		entities[index] = entity;
+		return entity;
+	}
+
+	void destroyEntity(UINT entity) {
+		if (!isAlive(entity))
+			return;
+
+		UINT index = entityIndex(entity);
+
+		// remove every component the entity owns
+		for (UINT compTypeID = 0; compTypeID < compPools.size(); compTypeID++) {
+			if (signatures[index].test(compTypeID))
+				compPools[compTypeID]->remove(entity, currentTick);
+		}
+
+		Signature oldSignature = signatures[index];
+		signatures[index].reset();
+		updateQueries(entity, oldSignature);
+
+		// stale the handle and put the slot up for reuse
+		generations[index] = (generations[index] + 1) % PendingGeneration;
+		entities[index] = NullEntity;
+		freeSlots.push_back(index);
+	}
+
+	// false for destroyed entities and for old handles whose slot has been recycled
+	bool isAlive(UINT entity) const {
+		UINT index = entityIndex(entity);
+		return entity != NullEntity && index < entities.size() && entities[index] == entity;
+	}
+
+	template <typename T, typename ...TArgs>
+	T& addComponent(UINT entity, TArgs&& ...args) {
+		assert(isAlive(entity));
+		auto compTypeID = Component<T>::getID();
+		UINT index = entityIndex(entity);
+
+		T& component = getPool<T>().insert(entity, T(std::forward<TArgs>(args)...), currentTick);
+
+		// set signature for entity
+		Signature oldSignature = signatures[index];
+		signatures[index].set(compTypeID);
+		updateQueries(entity, oldSignature);
+
+		LOG_TRACE(Registry, "entity %u add component %u, signature %s", entity, compTypeID, signatures[index].to_string().c_str());
+
+		return component;
+	}
+
+	template <typename T>
+	void removeComponent(UINT entity) {
+		auto compTypeID = Component<T>::getID();
+		UINT index = entityIndex(entity);
+		if (!isAlive(entity) || !signatures[index].test(compTypeID))
+			return;
+
+		getPool<T>().remove(entity, currentTick);
+
+		Signature oldSignature = signatures[index];
+		signatures[index].reset(compTypeID);
+		updateQueries(entity, oldSignature);
+	}
+	
+	template <typename T>
+	T& getComponent(UINT entity) {
+		// raw pool pointer, no shared_ptr copy so no atomic refcount traffic per call
+		assert(isAlive(entity));
+		auto compTypeID = Component<T>::getID();
+		return static_cast<Pool<T>*>(compPools[compTypeID].get())->get(entity);
+	}
+
+	// packed pool of a component type, used by systems to walk all components of that type without holes
+	// pools are never freed or moved once created so the returned reference can be cached by systems
+	template <typename T>
+	Pool<T>& getPool() {
+		auto compTypeID = Component<T>::getID();
+
+		// resize pool vector to store new component pool data
+		if (compTypeID >= compPools.size()) {
+			compPools.resize(compTypeID + 1);
+		}
+
+		if (!compPools[compTypeID]) {
+			compPools[compTypeID] = std::make_unique<Pool<T>>();
+		}
+
+		return *static_cast<Pool<T>*>(compPools[compTypeID].get());
+	}
+
+	// typed pool pointers for a set of components resolved once, see View
+	template <typename ...T>
+	View<T...> getView() {
+		return View<T...>(&getPool<T>()...);
+	}
+
+	template <typename T>
+	bool hasComponent(UINT entity) {
+		// check if entity has that comp from its signature, a stale handle has nothing
+		auto compTypeID = Component<T>::getID();
+		return isAlive(entity) && signatures[entityIndex(entity)].test(compTypeID);
+	}
+
+	// used by system to generate signatures to then get entities that possess those specific components
+	template <typename T>
+	UINT getComponentTypeID() {
+		return Component<T>::getID();
+	}
+
+	// change tracking. components are stamped with the current tick when added or marked changed. a system keeps the tick
+	// returned by advanceTick at the end of its run and next time asks for what changed since then
+	UINT getTick() const {
+		return currentTick;
+	}
+
+	// start a new tick and return the one that just ended
+	UINT advanceTick() {
+		return currentTick++;
+	}
+
+	template <typename T>
+	void markChanged(UINT entity) {
+		getPool<T>().markChanged(entity, currentTick);
+	}
+
+	template <typename T>
+	bool changedSince(UINT entity, UINT tick) {
+		return getPool<T>().changedSince(entity, tick);
+	}
+
+	// entities whose T changed after tick, read from the pool's change log so the cost follows the number of changes
+	template <typename T>
+	void getChanged(UINT tick, std::vector<UINT>& changed) {
+		getPool<T>().getChanged(tick, changed);
+	}
+
+	// signature with the bits of all the given component types set
+	template <typename ...T>
+	Signature getSignature() {
+		Signature signature;
+		(signature.set(Component<T>::getID()), ...);
+		return signature;
+	}
+
+	// register a query once and iterate its live set with getQueryEntities, no rescan of all signatures per call
+	QueryID registerQuery(const Signature& all, const Signature& any = Signature(), const Signature& none = Signature()) {
+		Query query;
+		query.all = all;
+		query.any = any;
+		query.none = none;
+
+		// initial fill from the entities that already exist, after this the set is maintained incrementally
+		for (auto& e : entities) {
+			if (e != NullEntity && query.matches(signatures[entityIndex(e)]))
+				query.insert(e);
+		}
+
+		queries.push_back(std::move(query));
+		return static_cast<QueryID>(queries.size() - 1);
+	}
+
+	const std::vector<UINT>& getQueryEntities(QueryID queryID) const {
+		return queries[queryID].entities;
+	}
+
+private:
+
+	std::vector<std::unique_ptr<IPool>> compPools;
+	std::vector<Signature> signatures;										//signatures of each entity slot
+
+	// add or drop the entity from every query whose match result changed with its signature
+	void updateQueries(UINT entity, const Signature& oldSignature) {
+		const Signature& signature = signatures[entityIndex(entity)];
+		for (auto& query : queries) {
+			bool matched = query.matches(oldSignature);
+			bool matches = query.matches(signature);
+			if (matches && !matched)
+				query.insert(entity);
+			else if (matched && !matches)
+				query.remove(entity);
+		}
+	}
+
+	std::vector<Query> queries;
+
+	std::vector<UINT> entities;												// slot index -> live handle, NullEntity if the slot is free
+	std::vector<UINT> generations;											// current generation of each slot
+	std::vector<UINT> freeSlots;											// destroyed slots ready for reuse
+
+	UINT currentTick = 1;													// 0 is "never ran" so everything counts as changed
+
+};
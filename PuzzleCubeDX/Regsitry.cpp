@@ -1,3 +1,3 @@
-#include "Registry.h"
-
-UINT IComponent::nextID = 0;
+#include "Registry.h"
+
+UINT IComponent::nextID = 0;
@@ -1,315 +1,288 @@
-#include "RenderSystem.h"
-#include "Helper.h"
-
-#include <algorithm>
-
-using namespace DirectX;
-
-float angle = 0.f;
-
-
-void RenderSystem::onUpdateTransformations() {
-	// update all model matrices of every piece and face in the CBuffer
-	// update perobj cbuffer with all entities model matrix
-	XMMATRIX mxmodel, mxlocal;
-	std::vector<CBuffPerObj> cbPerObjects;
-	int i = 0;
-	auto cbObjSize = calcConstantBufferByteSize(sizeof(CBuffPerObj));
-	for (auto& e : entitiesDraw) {
-		auto& cTransform = registry->getComponent<CTransform>(e);
-		auto cDraw = registry->getComponent<CDraw>(e);
-		auto& cHrchy = registry->getComponent<CHierarchy>(e);
-
-		mxlocal = XMLoadFloat4x4(&cTransform.mxlocal);
-
-		// TODO: Add proper scaling matrix for pieces and faces
-		// full hierarical relationship final position
-		if (cHrchy.entityParent != -1) {			
-			auto& transParent = registry->getComponent<CTransform>(cHrchy.entityParent);
-
-			// final position = local mat * parent mat 
-			mxmodel =  mxlocal * XMLoadFloat4x4(&transParent.mxmodel);
-		}
-		else {
-			// model matrix = scale * rot * trans
-			mxmodel = mxlocal;
-		}
-		
-		XMStoreFloat4x4(&cTransform.mxmodel, mxmodel);
-
-
-		CBuffPerObj cbObj;
-		XMStoreFloat4x4(&cbObj.matModel, XMMatrixTranspose(mxmodel));							// remember to transpose
-		cbObj.colorIndex = cDraw.colorIndex;
-
-		cTransform.forward = XMFLOAT3(
-			roundoff(cbObj.matModel._13, 1.f),
-			roundoff(cbObj.matModel._23, 1.f),
-			roundoff(cbObj.matModel._33, 1.f));
-
-		memcpy(&pCBPerObj[i * cbObjSize], &cbObj, sizeof(CBuffPerObj));
-		i++;
-	}
-}
-
-void RenderSystem::onUpdateView(const float& radius, const float& theta, const float& phi) {
-	// Convert Spherical to Cartesian coordinates for camera
-	float x = radius * sinf(phi) * cosf(theta);
-	float z = radius * sinf(phi) * sinf(theta);
-	float y = radius * cosf(phi);
-
-	// fixed view for now
-	XMVECTOR pos = XMVectorSet(x, y, z, 1.f);
-	XMVECTOR target = XMVectorZero();
-	XMVECTOR up = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
-	XMMATRIX xmview = XMMatrixLookAtLH(pos, target, up);
-
-	CBuffPerPass cbufViewProj;
-	XMStoreFloat4x4(&cbufViewProj.matView, XMMatrixTranspose(xmview));					// remember to transpose
-	XMStoreFloat4x4(&cbufViewProj.matProj, XMMatrixTranspose(XMLoadFloat4x4(&mproj)));
-
-	memcpy(pCBPerPass, &cbufViewProj, sizeof(CBuffPerPass));
-	
-	XMStoreFloat4x4(&mview, xmview);
-}
-
-void RenderSystem::onDraw(ID3D12GraphicsCommandList* commandList) {
-	// bind cbv to shader
-	ID3D12DescriptorHeap* descriptorHeaps[] = { mCbvHeap.Get() };
-	commandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
-	
-	commandList->SetGraphicsRootSignature(mRootSignature.Get());
-
-	// bind perPass
-	commandList->SetGraphicsRootConstantBufferView(1, resCBPerPass->GetGPUVirtualAddress());
-
-	//// and bind to descriptortable for root signature
-	//commandList->SetGraphicsRootDescriptorTable(0, mCbvHeap->GetGPUDescriptorHandleForHeapStart());
-	
-	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-	commandList->IASetVertexBuffers(0, 1, &vertBuffView);
-	commandList->IASetIndexBuffer(&indexBuffView);
-
-	// loop over entities to draw
-	CDraw cdraw;
-	auto cbObjByteSize = calcConstantBufferByteSize(sizeof(pCBPerObj));
-	UINT i = 0;
-	for (auto& enttDraw : entitiesDraw) {
-		cdraw = registry->getComponent<CDraw>(enttDraw);
-
-		D3D12_GPU_VIRTUAL_ADDRESS cbAddress = resCBPerObj->GetGPUVirtualAddress();
-		cbAddress += (i * cbObjByteSize);
-		
-		// root parameter versioning
-		commandList->SetGraphicsRootConstantBufferView(0, cbAddress);
-		commandList->DrawIndexedInstanced(cdraw.indexCount, 1, cdraw.startIndex, cdraw.baseVertex, 0);
-		
-		i++;
-	}
-}
-
-void RenderSystem::onInit(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, std::shared_ptr<Registry> registry, const float aspectRatio, std::vector<float>& vertices, std::vector<uint16_t>& indices) {
-	this->registry = registry;
-
-
-	initBuffers(device, cmdList, vertices, indices);
-	storeDrawableEntities();
-	createConstantBuffers(device);
-	createRootSignature(device);
-
-	XMStoreFloat4x4(&mproj, XMMatrixPerspectiveFovLH(0.25f * DirectX::XM_PI, aspectRatio, 1.f, 1000.f));
-
-	// update the constant buffer matrices 
-	onUpdateTransformations();
-}
-
-void RenderSystem::storeDrawableEntities() {
-	// create signature for filtering entities with CDraw comp
-	Signature signature;
-	signature.set(registry->getComponentTypeID<CDraw>());
-
-	// store all drawable entities that have CDraw
-	entitiesDraw = registry->getEntitiesFromSignature(signature);
-}
-
-void RenderSystem::createConstantBuffers(ID3D12Device* device) {
-	mCbvSrvDescriptorSize = device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-	size_t numDrawEntities = entitiesDraw.size();
-
-	// descriptors for all drawable entities perObject and 1 (at last pos) for perPass cbuffer
-	// and then extra free descriptors for imgui
-	numCBuffDescriptors = numDrawEntities + 1 + 64;
-
-	// cbuffer descriptor heap
-	D3D12_DESCRIPTOR_HEAP_DESC cbHeapDesc;
-	cbHeapDesc.NumDescriptors = numCBuffDescriptors;
-	cbHeapDesc.NodeMask = 0;
-	cbHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-	cbHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-	ThrowIfFailed(
-		device->CreateDescriptorHeap(&cbHeapDesc, IID_PPV_ARGS(mCbvHeap.GetAddressOf()))
-	);
-
-	// first perobject, create cbv for each entity
-	// create buffer resource first
-	auto cbObjSize = calcConstantBufferByteSize(sizeof(CBuffPerObj));
-	auto cbuffSize = cbObjSize * numDrawEntities;
-	auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-	auto resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(cbuffSize);
-	ThrowIfFailed(
-		device->CreateCommittedResource(
-			&heapProperties,
-			D3D12_HEAP_FLAG_NONE,
-			&resourceDesc,
-			D3D12_RESOURCE_STATE_GENERIC_READ,
-			nullptr,
-			IID_PPV_ARGS(&resCBPerObj))
-	);
-	// data mapping pointer
-	resCBPerObj->Map(0, nullptr, reinterpret_cast<void**>(&pCBPerObj));
-
-	// now create cbv for each entity perobject data
-	for (UINT i = 0; i < numDrawEntities; i++) {
-
-		// get pointer at offset to the ith position inside the constant buffer resource
-		D3D12_GPU_VIRTUAL_ADDRESS cbAddress = resCBPerObj->GetGPUVirtualAddress();
-		cbAddress += (i * cbObjSize);
-
-		// get handle at ith position from the cbv heap
-		auto handle = CD3DX12_CPU_DESCRIPTOR_HANDLE(mCbvHeap->GetCPUDescriptorHandleForHeapStart());
-		handle.Offset(i, mCbvSrvDescriptorSize);
-
-		D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc;
-		cbvDesc.BufferLocation = cbAddress;
-		cbvDesc.SizeInBytes = cbObjSize;
-		device->CreateConstantBufferView(&cbvDesc, handle);
-	}
-
-	
-	// 2nd, the perPass cbuffer
-	cbuffSize = calcConstantBufferByteSize(sizeof(CBuffPerPass));
-	heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-	resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(cbuffSize);
-	ThrowIfFailed(
-		device->CreateCommittedResource(
-			&heapProperties,
-			D3D12_HEAP_FLAG_NONE,
-			&resourceDesc,
-			D3D12_RESOURCE_STATE_GENERIC_READ,
-			0, IID_PPV_ARGS(&resCBPerPass))
-	);
-	resCBPerPass->Map(0, nullptr, reinterpret_cast<void**>(&pCBPerPass));
-
-	// handle at the last position on heap
-	auto handle = CD3DX12_CPU_DESCRIPTOR_HANDLE(mCbvHeap->GetCPUDescriptorHandleForHeapStart());
-	handle.Offset(numDrawEntities, mCbvSrvDescriptorSize);
-
-	D3D12_GPU_VIRTUAL_ADDRESS cbAddress = resCBPerPass->GetGPUVirtualAddress();
-	D3D12_CONSTANT_BUFFER_VIEW_DESC cbPerPassDesc;
-	cbPerPassDesc.BufferLocation = cbAddress;
-	cbPerPassDesc.SizeInBytes = cbuffSize;
-	device->CreateConstantBufferView(&cbPerPassDesc, handle);
-}
-
-void RenderSystem::createRootSignature(ID3D12Device* device) {
-	CD3DX12_ROOT_PARAMETER slotRootParameter[2];
-
-	slotRootParameter[0].InitAsConstantBufferView(0);
-	slotRootParameter[1].InitAsConstantBufferView(1);
-
-	CD3DX12_ROOT_SIGNATURE_DESC rootSigDesc(2, slotRootParameter, 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
-
-	//TOEDIT
-	ComPtr<ID3DBlob> serializedRootSig = nullptr;
-	ComPtr<ID3DBlob> errorBlob = nullptr;
-	HRESULT hr = D3D12SerializeRootSignature(&rootSigDesc, D3D_ROOT_SIGNATURE_VERSION_1, serializedRootSig.GetAddressOf(), errorBlob.GetAddressOf());
-	if (errorBlob != nullptr) {
-		::OutputDebugStringA((char*)errorBlob->GetBufferPointer());
-	}
-	ThrowIfFailed(hr);
-
-
-	ThrowIfFailed(
-		device->CreateRootSignature(0, serializedRootSig->GetBufferPointer(), serializedRootSig->GetBufferSize(), IID_PPV_ARGS(&mRootSignature))
-	);
-}
-
-void RenderSystem::initBuffers(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, std::vector<float>& vertices, std::vector<uint16_t>& indices) {
-	// init default heap buffers and views
-	const UINT64 vertBufferSize = sizeof(float) * vertices.size();
-	const UINT64 indexBufferSize = sizeof(std::uint16_t) * indices.size();
-
-	vertBuffDefault = loadBufferDataIntoDefaultHeap(device, cmdList, vertices.data(), vertBufferSize, vertBuffUpload);
-
-	indexBuffDefault = loadBufferDataIntoDefaultHeap(device, cmdList, indices.data(), indexBufferSize, indexBuffUpload);
-
-	vertBuffView.BufferLocation = vertBuffDefault->GetGPUVirtualAddress();
-	vertBuffView.SizeInBytes = vertBufferSize;
-	vertBuffView.StrideInBytes = sizeof(float) * 3;								// only position data of vector3 for now to send to shader
-
-	indexBuffView.BufferLocation = indexBuffDefault->GetGPUVirtualAddress();
-	indexBuffView.Format = DXGI_FORMAT_R16_UINT;
-	indexBuffView.SizeInBytes = indexBufferSize;
-}
-
-ComPtr<ID3D12Resource> RenderSystem::loadBufferDataIntoDefaultHeap(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, const void* bufferData, UINT64 bufferByteSize, ComPtr<ID3D12Resource>& resUploadBuffer) {
-	ComPtr<ID3D12Resource> resDefaultBuffer;
-
-	// TODO: set resource state directly to copy destination
-	// default heap resource
-	auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
-	auto resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(bufferByteSize);
-	ThrowIfFailed(
-		device->CreateCommittedResource(
-			&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDesc,
-			D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(resDefaultBuffer.GetAddressOf()))
-	);
-
-	// intermediate upload heap resource
-	heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-	ThrowIfFailed(
-		device->CreateCommittedResource(
-			&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDesc,
-			D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(resUploadBuffer.GetAddressOf()))
-	);
-
-	// data type to be copied into default buffer resource
-	D3D12_SUBRESOURCE_DATA subData = {};
-	subData.pData = bufferData;
-	subData.RowPitch = bufferByteSize;
-	subData.SlicePitch = subData.RowPitch;
-
-
-	// default buff resource transition into copy destination
-	auto resBarrierTransition = CD3DX12_RESOURCE_BARRIER::Transition(resDefaultBuffer.Get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
-	cmdList->ResourceBarrier(1, &resBarrierTransition);
-	
-	UpdateSubresources<1>(cmdList, resDefaultBuffer.Get(), resUploadBuffer.Get(), 0, 0, 1, &subData);
-
-	resBarrierTransition = CD3DX12_RESOURCE_BARRIER::Transition(resDefaultBuffer.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ);
-	cmdList->ResourceBarrier(1, &resBarrierTransition);
-
-	return resDefaultBuffer;
-
-}
-
-
-
-XMFLOAT4X4 RenderSystem::getProjectionMatrix() {
-	return mproj;
-}
-XMFLOAT4X4 RenderSystem::getViewMatrix() {
-	return mview;
-}
-
-ID3D12RootSignature* RenderSystem::getRootSignature() {
-	return mRootSignature.Get();
-}
-
-UINT RenderSystem::getNumCBufferDescriptors() {
-	return numCBuffDescriptors;
-}
-
-ID3D12DescriptorHeap* RenderSystem::getCBVHeap() {
-	return mCbvHeap.Get();
+#include "RenderSystem.h"
+#include "Helper.h"
+#include "Log.h"
+
+#include <algorithm>
+
+using namespace DirectX;
+
+float angle = 0.f;
+
+
+void RenderSystem::onUpdateTransformations() {
+	// write the instance slots of the pieces and faces whose model matrix or draw data changed since the last run.
+	// model matrices themselves are computed by the HierarchySystem
+	auto& transPool = view.pool<CTransform>();
+
+	// walk the packed CDraw pool directly, dense index i is the draw number the packets were built from. adding or
+	// removing a CDraw moves dense indices around, so the packets are grouped again and every slot is written
+	auto& drawPool = view.pool<CDraw>();
+	bool rebuilt = drawPool.structureVersion != drawVersion;
+	if (rebuilt)
+		buildPackets();
+
+	for (UINT i = 0; i < drawPool.size(); i++) {
+		auto e = drawPool.entities[i];
+		if (!rebuilt && drawPool.changeTicks[i] <= lastTransformTick && !transPool.changedSince(e, lastTransformTick))
+			continue;
+
+		auto instance = drawPackets.getInstance(i);
+		if (instance == InvalidInstance)
+			continue;
+
+		auto& cDraw = drawPool.compData[i];
+		auto& cTransform = transPool.get(e);
+
+		InstanceData data = {};
+		XMStoreFloat4x4(&data.matModel, XMMatrixTranspose(XMLoadFloat4x4(&cTransform.mxmodel)));	// remember to transpose
+		data.colorIndex = cDraw.colorIndex;
+
+		memcpy(&pInstances[instance], &data, sizeof(InstanceData));
+	}
+
+	lastTransformTick = registry->advanceTick();
+}
+
+void RenderSystem::onUpdateView(const float& radius, const float& theta, const float& phi) {
+	// Convert Spherical to Cartesian coordinates for camera
+	float x = radius * sinf(phi) * cosf(theta);
+	float z = radius * sinf(phi) * sinf(theta);
+	float y = radius * cosf(phi);
+
+	// fixed view for now
+	XMVECTOR pos = XMVectorSet(x, y, z, 1.f);
+	XMVECTOR target = XMVectorZero();
+	XMVECTOR up = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+	XMMATRIX xmview = XMMatrixLookAtLH(pos, target, up);
+
+	CBuffPerPass cbufViewProj;
+	XMStoreFloat4x4(&cbufViewProj.matView, XMMatrixTranspose(xmview));					// remember to transpose
+	XMStoreFloat4x4(&cbufViewProj.matProj, XMMatrixTranspose(XMLoadFloat4x4(&mproj)));
+
+	memcpy(pCBPerPass, &cbufViewProj, sizeof(CBuffPerPass));
+	
+	XMStoreFloat4x4(&mview, xmview);
+}
+
+void RenderSystem::onDraw(ID3D12GraphicsCommandList* commandList) {
+	// bind cbv to shader
+	ID3D12DescriptorHeap* descriptorHeaps[] = { mCbvHeap.Get() };
+	commandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
+	
+	commandList->SetGraphicsRootSignature(mRootSignature.Get());
+
+	// bind perPass and the instances
+	commandList->SetGraphicsRootConstantBufferView(1, resCBPerPass->GetGPUVirtualAddress());
+	commandList->SetGraphicsRootShaderResourceView(2, resInstances->GetGPUVirtualAddress());
+
+	//// and bind to descriptortable for root signature
+	//commandList->SetGraphicsRootDescriptorTable(0, mCbvHeap->GetGPUDescriptorHandleForHeapStart());
+	
+	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	commandList->IASetVertexBuffers(0, 1, &vertBuffView);
+	commandList->IASetIndexBuffer(&indexBuffView);
+
+	// one draw per mesh. SV_InstanceID starts at 0 whatever the start instance is, so the first slot of the packet
+	// goes in as a root constant instead
+	for (auto& packet : drawPackets.getPackets()) {
+		auto& mesh = meshes[packet.mesh];
+		commandList->SetGraphicsRoot32BitConstant(0, packet.firstInstance, 0);
+		commandList->DrawIndexedInstanced(mesh.indexCount, packet.instanceCount, mesh.startIndex, mesh.baseVertex, 0);
+	}
+}
+
+void RenderSystem::onInit(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, std::shared_ptr<Registry> registry, const float aspectRatio, std::vector<float>& vertices, std::vector<uint32_t>& indices, const std::vector<MeshRange>& meshes) {
+	this->device = device;
+	this->registry = registry;
+	this->view = registry->getView<CTransform, CDraw>();
+	this->meshes = meshes;
+
+	initBuffers(device, cmdList, vertices, indices);
+	createConstantBuffers(device);
+	buildPackets();
+	createRootSignature(device);
+
+	XMStoreFloat4x4(&mproj, XMMatrixPerspectiveFovLH(0.25f * DirectX::XM_PI, aspectRatio, 1.f, 1000.f));
+
+	// update the constant buffer matrices 
+	onUpdateTransformations();
+}
+
+void RenderSystem::createConstantBuffers(ID3D12Device* device) {
+	mCbvSrvDescriptorSize = device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+	// 1 descriptor for the perPass cbuffer and then extra free descriptors for imgui. instances are read through a
+	// root descriptor and need none
+	numCBuffDescriptors = 1 + 64;
+
+	// cbuffer descriptor heap
+	D3D12_DESCRIPTOR_HEAP_DESC cbHeapDesc;
+	cbHeapDesc.NumDescriptors = numCBuffDescriptors;
+	cbHeapDesc.NodeMask = 0;
+	cbHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+	cbHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+	ThrowIfFailed(
+		device->CreateDescriptorHeap(&cbHeapDesc, IID_PPV_ARGS(mCbvHeap.GetAddressOf()))
+	);
+
+	// the perPass cbuffer
+	auto cbuffSize = calcConstantBufferByteSize(sizeof(CBuffPerPass));
+	auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	auto resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(cbuffSize);
+	ThrowIfFailed(
+		device->CreateCommittedResource(
+			&heapProperties,
+			D3D12_HEAP_FLAG_NONE,
+			&resourceDesc,
+			D3D12_RESOURCE_STATE_GENERIC_READ,
+			0, IID_PPV_ARGS(&resCBPerPass))
+	);
+	resCBPerPass->Map(0, nullptr, reinterpret_cast<void**>(&pCBPerPass));
+
+	// handle at the first position on heap
+	auto handle = CD3DX12_CPU_DESCRIPTOR_HANDLE(mCbvHeap->GetCPUDescriptorHandleForHeapStart());
+
+	D3D12_GPU_VIRTUAL_ADDRESS cbAddress = resCBPerPass->GetGPUVirtualAddress();
+	D3D12_CONSTANT_BUFFER_VIEW_DESC cbPerPassDesc;
+	cbPerPassDesc.BufferLocation = cbAddress;
+	cbPerPassDesc.SizeInBytes = cbuffSize;
+	device->CreateConstantBufferView(&cbPerPassDesc, handle);
+}
+
+void RenderSystem::buildPackets() {
+	// the draws are grouped into packets on init and again whenever entities gain or lose a CDraw
+	auto& drawPool = view.pool<CDraw>();
+	std::vector<uint32_t> meshOfDraw(drawPool.size());
+	for (UINT i = 0; i < drawPool.size(); i++)
+		meshOfDraw[i] = drawPool.compData[i].meshIndex;
+	drawPackets.build(meshOfDraw.data(), static_cast<uint32_t>(meshOfDraw.size()), static_cast<uint32_t>(meshes.size()));
+	drawVersion = drawPool.structureVersion;
+	LOG_INFO(Render, "%zu draws in %zu instanced packets", meshOfDraw.size(), drawPackets.getPackets().size());
+
+	// every frame is flushed before the systems run, so the gpu is done with the old buffer when it is replaced
+	if (drawPackets.getNumInstances() > numInstanceSlots || !resInstances)
+		createInstanceBuffer(device);
+}
+
+void RenderSystem::createInstanceBuffer(ID3D12Device* device) {
+	// one InstanceData per drawn entity in an upload heap, mapped for good like the cbuffers. grows by doubling when
+	// more entities are drawn later on
+	numInstanceSlots = std::max<UINT>({ drawPackets.getNumInstances(), 2 * numInstanceSlots, 1 });
+	UINT64 bufferSize = sizeof(InstanceData) * static_cast<UINT64>(numInstanceSlots);
+	auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	auto resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(bufferSize);
+	ThrowIfFailed(
+		device->CreateCommittedResource(
+			&heapProperties,
+			D3D12_HEAP_FLAG_NONE,
+			&resourceDesc,
+			D3D12_RESOURCE_STATE_GENERIC_READ,
+			nullptr,
+			IID_PPV_ARGS(&resInstances))
+	);
+	resInstances->Map(0, nullptr, reinterpret_cast<void**>(&pInstances));
+}
+
+void RenderSystem::createRootSignature(ID3D12Device* device) {
+	CD3DX12_ROOT_PARAMETER slotRootParameter[3];
+
+	slotRootParameter[0].InitAsConstants(1, 0);									// first instance of the packet at b0
+	slotRootParameter[1].InitAsConstantBufferView(1);
+	slotRootParameter[2].InitAsShaderResourceView(0);							// instances at t0
+
+	CD3DX12_ROOT_SIGNATURE_DESC rootSigDesc(3, slotRootParameter, 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+
+	//TOEDIT
+	ComPtr<ID3DBlob> serializedRootSig = nullptr;
+	ComPtr<ID3DBlob> errorBlob = nullptr;
+	HRESULT hr = D3D12SerializeRootSignature(&rootSigDesc, D3D_ROOT_SIGNATURE_VERSION_1, serializedRootSig.GetAddressOf(), errorBlob.GetAddressOf());
+	if (errorBlob != nullptr) {
+		LOG_ERROR(Render, "%s", (char*)errorBlob->GetBufferPointer());
+	}
+	ThrowIfFailed(hr);
+
+
+	ThrowIfFailed(
+		device->CreateRootSignature(0, serializedRootSig->GetBufferPointer(), serializedRootSig->GetBufferSize(), IID_PPV_ARGS(&mRootSignature))
+	);
+}
+
+void RenderSystem::initBuffers(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, std::vector<float>& vertices, std::vector<uint32_t>& indices) {
+	// init default heap buffers and views
+	const UINT64 vertBufferSize = sizeof(float) * vertices.size();
+	const UINT64 indexBufferSize = sizeof(std::uint32_t) * indices.size();
+
+	vertBuffDefault = loadBufferDataIntoDefaultHeap(device, cmdList, vertices.data(), vertBufferSize, vertBuffUpload);
+
+	indexBuffDefault = loadBufferDataIntoDefaultHeap(device, cmdList, indices.data(), indexBufferSize, indexBuffUpload);
+
+	vertBuffView.BufferLocation = vertBuffDefault->GetGPUVirtualAddress();
+	vertBuffView.SizeInBytes = vertBufferSize;
+	vertBuffView.StrideInBytes = sizeof(float) * 3;								// only position data of vector3 for now to send to shader
+
+	indexBuffView.BufferLocation = indexBuffDefault->GetGPUVirtualAddress();
+	indexBuffView.Format = DXGI_FORMAT_R32_UINT;
+	indexBuffView.SizeInBytes = indexBufferSize;
+}
+
+ComPtr<ID3D12Resource> RenderSystem::loadBufferDataIntoDefaultHeap(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, const void* bufferData, UINT64 bufferByteSize, ComPtr<ID3D12Resource>& resUploadBuffer) {
+	ComPtr<ID3D12Resource> resDefaultBuffer;
+
+	// TODO: set resource state directly to copy destination
+	// default heap resource
+	auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+	auto resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(bufferByteSize);
+	ThrowIfFailed(
+		device->CreateCommittedResource(
+			&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDesc,
+			D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(resDefaultBuffer.GetAddressOf()))
+	);
+
+	// intermediate upload heap resource
+	heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	ThrowIfFailed(
+		device->CreateCommittedResource(
+			&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDesc,
+			D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(resUploadBuffer.GetAddressOf()))
+	);
+
+	// data type to be copied into default buffer resource
+	D3D12_SUBRESOURCE_DATA subData = {};
+	subData.pData = bufferData;
+	subData.RowPitch = bufferByteSize;
+	subData.SlicePitch = subData.RowPitch;
+
+
+	// default buff resource transition into copy destination
+	auto resBarrierTransition = CD3DX12_RESOURCE_BARRIER::Transition(resDefaultBuffer.Get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
+	cmdList->ResourceBarrier(1, &resBarrierTransition);
+	
+	UpdateSubresources<1>(cmdList, resDefaultBuffer.Get(), resUploadBuffer.Get(), 0, 0, 1, &subData);
+
+	resBarrierTransition = CD3DX12_RESOURCE_BARRIER::Transition(resDefaultBuffer.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ);
+	cmdList->ResourceBarrier(1, &resBarrierTransition);
+
+	return resDefaultBuffer;
+
+}
+
+
+
+XMFLOAT4X4 RenderSystem::getProjectionMatrix() {
+	return mproj;
+}
+XMFLOAT4X4 RenderSystem::getViewMatrix() {
+	return mview;
+}
+
+ID3D12RootSignature* RenderSystem::getRootSignature() {
+	return mRootSignature.Get();
+}
+
+UINT RenderSystem::getNumCBufferDescriptors() {
+	return numCBuffDescriptors;
+}
+
+ID3D12DescriptorHeap* RenderSystem::getCBVHeap() {
+	return mCbvHeap.Get();
 }
\ No newline at end of file
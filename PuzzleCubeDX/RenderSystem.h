@@ -1,52 +1,60 @@
-#pragma once
-#include "stdafx.h"
-#include "Registry.h"
-
-
-class RenderSystem {
-public:
-	void onInit(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, std::shared_ptr<Registry> registry, const float aspectRatio, std::vector<float>& vertices, std::vector<uint16_t>& indices);
-	void onUpdateTransformations();
-	void onUpdateView(const float& radius, const float& theta, const float& phi);
-	void onDraw(ID3D12GraphicsCommandList* commandList);
-
-	
-	XMFLOAT4X4 getProjectionMatrix();
-	XMFLOAT4X4 getViewMatrix();
-	ID3D12RootSignature* getRootSignature();
-	UINT getNumCBufferDescriptors();
-	ID3D12DescriptorHeap* getCBVHeap();
-
-
-private:
-	void storeDrawableEntities();
-	void createConstantBuffers(ID3D12Device* device);
-	void initBuffers(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, std::vector<float>& vertices, std::vector<uint16_t>& indices);
-	ComPtr<ID3D12Resource> loadBufferDataIntoDefaultHeap(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, const void* bufferData, UINT64 bufferByteSize, ComPtr<ID3D12Resource>& resUploadBuffer);
-	void createRootSignature(ID3D12Device* device);
-
-	std::shared_ptr<Registry> registry;
-
-	ComPtr<ID3D12RootSignature> mRootSignature;
-	ComPtr<ID3D12DescriptorHeap> mCbvHeap;
-	UINT mCbvSrvDescriptorSize;
-	ComPtr<ID3D12Resource> resCBPerObj, resCBPerPass;
-	BYTE *pCBPerPass, *pCBPerObj;												// constant buffer pointer for draw index at b1
-	UINT numCBuffDescriptors;
-
-	XMFLOAT4X4 mproj, mview;
-
-	ComPtr<ID3D12Resource> vertBuffDefault, vertBuffUpload;
-	ComPtr<ID3D12Resource> indexBuffDefault, indexBuffUpload;
-
-	D3D12_VERTEX_BUFFER_VIEW vertBuffView;
-	D3D12_INDEX_BUFFER_VIEW indexBuffView;
-
-	ID3D12GraphicsCommandList* commandList;
-
-	// entities that have CDraw. useful for quick lookup
-	std::vector<UINT> entitiesDraw;
-
-};
-
-
+#pragma once
+#include "stdafx.h"
+#include "Components.h"
+#include "Registry.h"
+#include "DrawPackets.h"
+
+
+class RenderSystem {
+public:
+	void onInit(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, std::shared_ptr<Registry> registry, const float aspectRatio, std::vector<float>& vertices, std::vector<uint32_t>& indices, const std::vector<MeshRange>& meshes);
+	void onUpdateTransformations();
+	void onUpdateView(const float& radius, const float& theta, const float& phi);
+	void onDraw(ID3D12GraphicsCommandList* commandList);
+
+	
+	XMFLOAT4X4 getProjectionMatrix();
+	XMFLOAT4X4 getViewMatrix();
+	ID3D12RootSignature* getRootSignature();
+	UINT getNumCBufferDescriptors();
+	ID3D12DescriptorHeap* getCBVHeap();
+
+
+private:
+	void createConstantBuffers(ID3D12Device* device);
+	void buildPackets();
+	void createInstanceBuffer(ID3D12Device* device);
+	void initBuffers(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, std::vector<float>& vertices, std::vector<uint32_t>& indices);
+	ComPtr<ID3D12Resource> loadBufferDataIntoDefaultHeap(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, const void* bufferData, UINT64 bufferByteSize, ComPtr<ID3D12Resource>& resUploadBuffer);
+	void createRootSignature(ID3D12Device* device);
+
+	ID3D12Device* device;														// for growing the instance buffer
+	std::shared_ptr<Registry> registry;
+	View<CTransform, CDraw> view;												// pools resolved once in onInit
+	UINT lastTransformTick = 0;													// registry tick of the last onUpdateTransformations
+	UINT drawVersion = 0;														// CDraw pool structure version the packets were built from
+
+	ComPtr<ID3D12RootSignature> mRootSignature;
+	ComPtr<ID3D12DescriptorHeap> mCbvHeap;
+	UINT mCbvSrvDescriptorSize;
+	ComPtr<ID3D12Resource> resInstances, resCBPerPass;
+	BYTE* pCBPerPass;
+	InstanceData* pInstances;													// structured buffer at t0, slots handed out by drawPackets
+	UINT numInstanceSlots = 0;													// InstanceData the buffer holds
+	UINT numCBuffDescriptors;
+
+	std::vector<MeshRange> meshes;
+	DrawPacketBuilder drawPackets;												// one instanced draw per mesh
+
+	XMFLOAT4X4 mproj, mview;
+
+	ComPtr<ID3D12Resource> vertBuffDefault, vertBuffUpload;
+	ComPtr<ID3D12Resource> indexBuffDefault, indexBuffUpload;
+
+	D3D12_VERTEX_BUFFER_VIEW vertBuffView;
+	D3D12_INDEX_BUFFER_VIEW indexBuffView;
+
+	ID3D12GraphicsCommandList* commandList;
+};
+
+
@@ -0,0 +1,184 @@
+#include "Scheduler.h"
+
+#include <algorithm>
+
+namespace {
+	thread_local UINT threadIndex = 0;
+	thread_local ThreadPool* currentPool = nullptr;
+}
+
+ThreadPool::ThreadPool(UINT numWorkers) {
+	for (UINT i = 0; i < numWorkers; i++)
+		workers.emplace_back(&ThreadPool::workerLoop, this, i + 1);
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	jobAvailable.notify_all();
+	for (auto& worker : workers)
+		worker.join();
+}
+
+UINT ThreadPool::getWorkerCount() const {
+	return static_cast<UINT>(workers.size());
+}
+
+UINT ThreadPool::getThreadIndex() {
+	return threadIndex;
+}
+
+ThreadPool* ThreadPool::getCurrentPool() {
+	return currentPool;
+}
+
+void ThreadPool::workerLoop(UINT index) {
+	threadIndex = index;
+	currentPool = this;
+
+	while (true) {
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			jobAvailable.wait(lock, [this] { return stopping || !jobs.empty(); });
+			if (stopping && jobs.empty())
+				return;
+			job = jobs.front();
+			jobs.pop_front();
+		}
+
+		(*job.fn)();
+		finishJob(job.batch);
+	}
+}
+
+bool ThreadPool::runOneJob() {
+	Job job;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (jobs.empty())
+			return false;
+		job = jobs.front();
+		jobs.pop_front();
+	}
+
+	(*job.fn)();
+	finishJob(job.batch);
+	return true;
+}
+
+void ThreadPool::finishJob(Batch* batch) {
+	// decrement under the batch lock so the waiting thread can't return and free the batch while we still touch it
+	std::lock_guard<std::mutex> lock(batch->mutex);
+	if (batch->remaining.fetch_sub(1) == 1)
+		batch->done.notify_all();
+}
+
+void ThreadPool::run(std::vector<std::function<void()>>& batchJobs) {
+	if (batchJobs.empty())
+		return;
+
+	// nothing to hand off, run on the calling thread
+	if (batchJobs.size() == 1 || workers.empty()) {
+		for (auto& fn : batchJobs)
+			fn();
+		return;
+	}
+
+	Batch batch;
+	batch.remaining = static_cast<UINT>(batchJobs.size());
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (auto& fn : batchJobs)
+			jobs.push_back({ &fn, &batch });
+	}
+	jobAvailable.notify_all();
+
+	// help out until the queue is empty, then wait for the jobs still running on workers
+	while (batch.remaining.load() > 0 && runOneJob()) {}
+
+	std::unique_lock<std::mutex> lock(batch.mutex);
+	batch.done.wait(lock, [&batch] { return batch.remaining.load() == 0; });
+}
+
+void ThreadPool::parallelFor(UINT count, UINT grainSize, const std::function<void(UINT begin, UINT end)>& fn) {
+	grainSize = std::max(grainSize, 1u);
+
+	std::vector<std::function<void()>> rangeJobs;
+	for (UINT begin = 0; begin < count; begin += grainSize) {
+		UINT end = std::min(begin + grainSize, count);
+		rangeJobs.push_back([&fn, begin, end] { fn(begin, end); });
+	}
+	run(rangeJobs);
+}
+
+
+Scheduler::Scheduler(UINT numWorkers) : threadPool(numWorkers) {
+
+}
+
+void Scheduler::addSystem(std::string name, Signature reads, Signature writes, std::function<void(float)> update) {
+	systems.push_back({ name, reads, writes, update });
+	stagesDirty = true;
+}
+
+bool Scheduler::conflicts(const SystemDesc& a, const SystemDesc& b) const {
+	// write/write or read/write on the same component type
+	return (a.writes & (b.reads | b.writes)).any() || (b.writes & a.reads).any();
+}
+
+void Scheduler::buildStages() {
+	// dependency graph: a system depends on every earlier system it conflicts with.
+	// its stage is one after the latest stage among those, so independent systems share a stage
+	std::vector<UINT> systemStage(systems.size(), 0);
+	stages.clear();
+
+	for (UINT i = 0; i < systems.size(); i++) {
+		UINT stage = 0;
+		for (UINT j = 0; j < i; j++) {
+			if (conflicts(systems[i], systems[j]))
+				stage = std::max(stage, systemStage[j] + 1);
+		}
+		systemStage[i] = stage;
+
+		if (stage >= stages.size())
+			stages.resize(stage + 1);
+		stages[stage].push_back(i);
+	}
+
+	stagesDirty = false;
+}
+
+void Scheduler::onUpdate(const float& deltaTime) {
+	if (stagesDirty)
+		buildStages();
+
+	float dt = deltaTime;
+	for (auto& stage : stages) {
+		std::vector<std::function<void()>> stageJobs;
+		for (auto systemIndex : stage) {
+			auto* system = &systems[systemIndex];
+			stageJobs.push_back([system, dt] { system->update(dt); });
+		}
+		threadPool.run(stageJobs);
+	}
+}
+
+void Scheduler::forEachChunked(const std::vector<UINT>& entities, UINT chunkSize, const std::function<void(UINT entity)>& fn) {
+	threadPool.parallelFor(static_cast<UINT>(entities.size()), chunkSize, [&](UINT begin, UINT end) {
+		for (UINT i = begin; i < end; i++)
+			fn(entities[i]);
+	});
+}
+
+ThreadPool& Scheduler::getThreadPool() {
+	return threadPool;
+}
+
+const std::vector<std::vector<UINT>>& Scheduler::getStages() {
+	if (stagesDirty)
+		buildStages();
+	return stages;
+}
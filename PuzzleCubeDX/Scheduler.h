@@ -0,0 +1,85 @@
+// system scheduler and worker pool
+#pragma once
+#include "Registry.h"
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <string>
+
+// fixed set of worker threads. the thread that waits on a batch also runs jobs so nothing idles
+class ThreadPool {
+public:
+	ThreadPool(UINT numWorkers = std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0);
+	~ThreadPool();
+
+	// run all jobs and return once every one of them finished
+	void run(std::vector<std::function<void()>>& jobs);
+
+	// split [0, count) in ranges of grainSize and call fn(begin, end) for each range in parallel
+	void parallelFor(UINT count, UINT grainSize, const std::function<void(UINT begin, UINT end)>& fn);
+
+	UINT getWorkerCount() const;
+
+	// 0 for threads outside the pool (eg. the window thread), 1..workers for pool threads
+	static UINT getThreadIndex();
+
+	// pool the calling thread is a worker of, nullptr outside any pool. tells apart equal indices of different pools
+	static ThreadPool* getCurrentPool();
+
+private:
+	struct Batch {
+		std::atomic<UINT> remaining{ 0 };
+		std::mutex mutex;
+		std::condition_variable done;
+	};
+
+	struct Job {
+		std::function<void()>* fn;
+		Batch* batch;
+	};
+
+	void workerLoop(UINT threadIndex);
+	bool runOneJob();
+	void finishJob(Batch* batch);
+
+	std::vector<std::thread> workers;
+	std::deque<Job> jobs;
+	std::mutex mutex;
+	std::condition_variable jobAvailable;
+	bool stopping = false;
+};
+
+// systems declare which component types they read and write. systems that don't conflict run at the same time,
+// conflicting systems keep the order they were added in
+class Scheduler {
+public:
+	Scheduler(UINT numWorkers = std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0);
+
+	void addSystem(std::string name, Signature reads, Signature writes, std::function<void(float)> update);
+	void onUpdate(const float& deltaTime);
+
+	// data parallel for_each over a query's entities, split into chunks of chunkSize
+	void forEachChunked(const std::vector<UINT>& entities, UINT chunkSize, const std::function<void(UINT entity)>& fn);
+
+	ThreadPool& getThreadPool();
+	const std::vector<std::vector<UINT>>& getStages();
+
+private:
+	struct SystemDesc {
+		std::string name;
+		Signature reads, writes;
+		std::function<void(float)> update;
+	};
+
+	bool conflicts(const SystemDesc& a, const SystemDesc& b) const;
+	void buildStages();
+
+	ThreadPool threadPool;
+	std::vector<SystemDesc> systems;
+	std::vector<std::vector<UINT>> stages;									// system indices that can run together, in order
+	bool stagesDirty = false;
+};
@@ -0,0 +1,91 @@
+#include "Scrambler.h"
+#include "Scheduler.h"
+#include "Notation.h"
+
+#include <algorithm>
+
+namespace {
+	// Fisher-Yates, returns whether the permutation is odd (every real swap flips the parity)
+	template <typename T>
+	bool shuffle(Random& random, T* values, uint32_t count) {
+		bool odd = false;
+		for (uint32_t i = count - 1; i > 0; i--) {
+			uint32_t j = random.below(i + 1);
+			if (j != i) {
+				std::swap(values[i], values[j]);
+				odd = !odd;
+			}
+		}
+		return odd;
+	}
+}
+
+
+Scrambler::Scrambler(const TwoPhaseSolver& solver) : solver(solver) {
+
+}
+
+CubieCube Scrambler::getRandomState(Random& random) {
+	CubieCube cube;
+	bool cornersOdd = shuffle(random, cube.cp, CornerCount);
+	bool edgesOdd = shuffle(random, cube.ep, EdgeCount);
+
+	// swapping two edges when the parities differ maps exactly two shuffles onto every solvable cube, so it stays uniform
+	if (cornersOdd != edgesOdd)
+		std::swap(cube.ep[EdgeCount - 2], cube.ep[EdgeCount - 1]);
+
+	cube.setTwist(static_cast<uint16_t>(random.below(NumTwist)));
+	cube.setFlip(static_cast<uint16_t>(random.below(NumFlip)));
+	return cube;
+}
+
+void Scrambler::generate(Random& random, std::vector<Move>& scramble) const {
+	scramble.clear();
+
+	if (solver.isReady()) {
+		// a solver only fails on a timeout with nothing found, another state is just as random
+		while (!solver.solve(getRandomState(random), scramble, maxLength, timeoutSeconds)) {}
+		invertMoves(scramble);
+		return;
+	}
+
+	// opposite faces only in increasing order also rules out U D U, which would cancel into U2 D
+	int previous = -1;
+	while (scramble.size() < fallbackLength) {
+		int face = static_cast<int>(random.below(6));
+		if (previous >= 0 && (face == previous || (face < previous &&
+			getMoveInfo(static_cast<Move>(face * 3)).turn.axis == getMoveInfo(static_cast<Move>(previous * 3)).turn.axis)))
+			continue;
+
+		scramble.push_back(static_cast<Move>(face * 3 + random.below(3)));
+		previous = face;
+	}
+}
+
+void Scrambler::generate(ThreadPool& threadPool, uint64_t seed, uint32_t count, std::vector<std::vector<Move>>& scrambles) const {
+	scrambles.resize(count);
+	threadPool.parallelFor(count, 16, [&](UINT begin, UINT end) {
+		Random random;
+		for (UINT i = begin; i < end; i++) {
+			random.setSeed(seed, i);
+			generate(random, scrambles[i]);
+		}
+	});
+}
+
+void Scrambler::generate(Random& random, const CubeModelNxN& cube, std::vector<LayerMove>& scramble) {
+	// the layer is compared along the axis, so R and the opposite L layer count as the same
+	uint16_t n = cube.getSize();
+	scramble.clear();
+	LayerTurn previous = { 0, 0, 0, 0 };
+	while (scramble.size() < 10u * n) {
+		auto face = static_cast<Move>(MoveR + 3 * random.below(6) + random.below(3));
+		auto layer = static_cast<uint16_t>(1 + random.below(n));
+		LayerMove move(face, layer, layer);
+		LayerTurn turn = cube.getTurn(move);
+		if (!scramble.empty() && turn.axis == previous.axis && turn.first == previous.first)
+			continue;
+		previous = turn;
+		scramble.push_back(move);
+	}
+}
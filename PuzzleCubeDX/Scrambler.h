@@ -0,0 +1,38 @@
+// random state scrambles
+#pragma once
+#include "TwoPhaseSolver.h"
+#include "CubeModelNxN.h"
+#include "Random.h"
+
+#include <vector>
+
+class ThreadPool;
+
+// a scramble here is the inverse of a solution to a uniformly random cube, so every reachable state is equally likely
+// and the sequence is short and free of cancellations. this is how official scrambles are made
+class Scrambler {
+public:
+	Scrambler(const TwoPhaseSolver& solver);
+
+	// a uniformly random solvable cube: random corner and edge permutations of matching parity, random twist and flip
+	static CubieCube getRandomState(Random& random);
+
+	// random state scramble of at most maxLength face moves. until the solver tables are ready this falls back to
+	// random moves with no two in a row on the same face, and no opposite faces turned in both orders
+	void generate(Random& random, std::vector<Move>& scramble) const;
+
+	// count scrambles spread over the pool. scramble i only depends on seed and i, so a practice set can be made
+	// again from its seed regardless of the thread count (as long as no search runs into the timeout)
+	void generate(ThreadPool& threadPool, uint64_t seed, uint32_t count, std::vector<std::vector<Move>>& scrambles) const;
+
+	// 10 * size random single layer turns for cubes other than the 3x3, no random state solver covers those. a turn
+	// never follows one on the same layer, it would only merge with it or undo it
+	static void generate(Random& random, const CubeModelNxN& cube, std::vector<LayerMove>& scramble);
+
+	uint8_t maxLength = 22;														// a little above 20 keeps the search fast
+	double timeoutSeconds = 5.0;												// only a guard, 22 moves take milliseconds
+	uint8_t fallbackLength = 25;
+
+private:
+	const TwoPhaseSolver& solver;
+};
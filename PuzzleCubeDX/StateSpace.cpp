@@ -0,0 +1,403 @@
+#include "StateSpace.h"
+#include "Scheduler.h"
+#include "MappedFile.h"
+#include "Random.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+namespace {
+	const char DistanceMagic[4] = { 'P', 'C', 'D', 'T' };
+	const uint32_t DistanceVersion = 1;
+	const UINT GrainSize = 1 << 12;
+	const size_t BlockSize = 1 << 22;											// states read back from a frontier file at once
+	const size_t FlushSize = 1 << 12;											// states a thread collects before appending them
+
+	const Move faceMoves[18] = {
+		MoveR, MoveRi, MoveR2, MoveL, MoveLi, MoveL2, MoveU, MoveUi, MoveU2,
+		MoveF, MoveFi, MoveF2, MoveD, MoveDi, MoveD2, MoveB, MoveBi, MoveB2
+	};
+
+	// the 2x2 is held by its DBL corner, which R, U and F never move
+	const Move pocketMoves[9] = {
+		MoveR, MoveRi, MoveR2, MoveU, MoveUi, MoveU2, MoveF, MoveFi, MoveF2
+	};
+
+	const Move phase2Moves[10] = {
+		MoveU, MoveUi, MoveU2, MoveD, MoveDi, MoveD2, MoveR2, MoveL2, MoveF2, MoveB2
+	};
+
+	// the 7 corners other than DBL, in their slots other than DBL's
+	struct PocketPermCoord {
+		static constexpr uint32_t Size = 5040;									// 7!
+		static uint32_t get(const CubieCube& cube) {
+			uint8_t perm[7];
+			for (uint8_t slot = 0, i = 0; slot < CornerCount; slot++) {
+				if (slot != CornerDBL)
+					perm[i++] = cube.cp[slot] - (cube.cp[slot] > CornerDBL);
+			}
+			return rankPermutation(perm, 7);
+		}
+		static void set(CubieCube& cube, uint32_t coord) {
+			uint8_t perm[7];
+			unrankPermutation(coord, perm, 7);
+			for (uint8_t slot = 0, i = 0; slot < CornerCount; slot++) {
+				if (slot == CornerDBL)
+					cube.cp[slot] = CornerDBL;
+				else {
+					cube.cp[slot] = perm[i] + (perm[i] >= CornerDBL);
+					i++;
+				}
+			}
+		}
+		static void multiply(CubieCube& cube, const CubieCube& move) { cube.cornerMultiply(move); }
+	};
+
+	struct PocketTwistCoord {
+		static constexpr uint32_t Size = 729;									// 3^6, the 7th twist follows
+		static uint32_t get(const CubieCube& cube) {
+			uint8_t twist[7];
+			for (uint8_t slot = 0, i = 0; slot < CornerCount; slot++) {
+				if (slot != CornerDBL)
+					twist[i++] = cube.co[slot];
+			}
+			return rankOrientation(twist, 7, 3);
+		}
+		static void set(CubieCube& cube, uint32_t coord) {
+			uint8_t twist[7];
+			unrankOrientation(coord, twist, 7, 3);
+			for (uint8_t slot = 0, i = 0; slot < CornerCount; slot++)
+				cube.co[slot] = slot == CornerDBL ? 0 : twist[i++];
+		}
+		static void multiply(CubieCube& cube, const CubieCube& move) { cube.cornerMultiply(move); }
+	};
+
+	// state = major * Minor::Size + minor, the same layout the solvers index their tables with
+	template <typename Major, typename Minor>
+	class CoordinatePairSpace : public IStateSpace {
+	public:
+		CoordinatePairSpace(const char* name, const Move* moves, uint8_t numMoves) : name(name), moves(moves), numMoves(numMoves) {
+			buildMoveTable<Major>(majorMove, moves, numMoves);
+			buildMoveTable<Minor>(minorMove, moves, numMoves);
+		}
+
+		const char* getName() const override { return name; }
+		uint64_t getSize() const override { return static_cast<uint64_t>(Major::Size) * Minor::Size; }
+		uint8_t getNumMoves() const override { return numMoves; }
+		const Move* getMoves() const override { return moves; }
+
+		uint64_t getState(const CubieCube& cube) const override {
+			return static_cast<uint64_t>(Major::get(cube)) * Minor::Size + Minor::get(cube);
+		}
+
+		void getNeighbours(uint64_t state, uint64_t* neighbours) const override {
+			uint32_t major = static_cast<uint32_t>(state / Minor::Size), minor = static_cast<uint32_t>(state % Minor::Size);
+			const uint16_t* majorRow = &majorMove[major * numMoves];
+			const uint16_t* minorRow = &minorMove[minor * numMoves];
+			for (uint8_t m = 0; m < numMoves; m++)
+				neighbours[m] = static_cast<uint64_t>(majorRow[m]) * Minor::Size + minorRow[m];
+		}
+
+	private:
+		const char* name;
+		const Move* moves;
+		uint8_t numMoves;
+		std::vector<uint16_t> majorMove, minorMove;
+	};
+
+	// states of one depth. kept in memory up to a limit, past it they go to a file that is read back in blocks
+	class Frontier {
+	public:
+		Frontier(const std::string& path, uint64_t memoryLimit) : path(path), memoryLimit(path.empty() ? UINT64_MAX : memoryLimit) {}
+
+		~Frontier() {
+			clear();
+		}
+
+		// thread safe
+		bool append(const uint64_t* states, size_t count) {
+			if (count == 0)
+				return true;
+			std::lock_guard<std::mutex> lock(mutex);
+			total += count;
+			if (memory.size() + count <= memoryLimit) {
+				memory.insert(memory.end(), states, states + count);
+				return true;
+			}
+
+			if (!file && !(file = fopen(path.c_str(), "w+b"))) {
+				failed = true;
+				return false;
+			}
+			fileCount += count;
+			if (fwrite(states, sizeof(uint64_t), count, file) != count)
+				failed = true;
+			return !failed;
+		}
+
+		void clear() {
+			memory.clear();
+			total = fileCount = 0;
+			if (file) {
+				fclose(file);
+				file = nullptr;
+				std::remove(path.c_str());
+			}
+		}
+
+		// fn(states, count) for the states in the file, then the ones in memory, in blocks of at most BlockSize
+		template <typename Fn>
+		bool forEachBlock(Fn fn) {
+			if (fileCount > 0) {
+				std::vector<uint64_t> block(BlockSize);
+				fflush(file);
+				rewind(file);
+				for (uint64_t left = fileCount; left > 0;) {
+					size_t count = static_cast<size_t>(std::min<uint64_t>(left, BlockSize));
+					if (fread(block.data(), sizeof(uint64_t), count, file) != count)
+						return false;
+					fn(block.data(), count);
+					left -= count;
+				}
+			}
+			for (size_t begin = 0; begin < memory.size(); begin += BlockSize)
+				fn(memory.data() + begin, std::min(BlockSize, memory.size() - begin));
+			return true;
+		}
+
+		uint64_t size() const { return total; }
+		bool hasFailed() const { return failed; }
+
+	private:
+		std::string path;
+		uint64_t memoryLimit;
+		std::vector<uint64_t> memory;
+		FILE* file = nullptr;
+		uint64_t total = 0, fileCount = 0;
+		bool failed = false;
+		std::mutex mutex;
+	};
+}
+
+
+std::unique_ptr<IStateSpace> createStateSpace(const std::string& name) {
+	if (name == "2x2")
+		return std::make_unique<CoordinatePairSpace<PocketPermCoord, PocketTwistCoord>>("2x2", pocketMoves, 9);
+	if (name == "corners")
+		return std::make_unique<CoordinatePairSpace<CornerPermCoord, TwistCoord>>("corners", faceMoves, 18);
+	if (name == "twistslice")
+		return std::make_unique<CoordinatePairSpace<TwistCoord, SliceCoord>>("twistslice", faceMoves, 18);
+	if (name == "flipslice")
+		return std::make_unique<CoordinatePairSpace<FlipCoord, SliceCoord>>("flipslice", faceMoves, 18);
+	if (name == "cornersliceperm")
+		return std::make_unique<CoordinatePairSpace<CornerPermCoord, SlicePermCoord>>("cornersliceperm", phase2Moves, 10);
+	if (name == "edgesliceperm")
+		return std::make_unique<CoordinatePairSpace<UDEdgePermCoord, SlicePermCoord>>("edgesliceperm", phase2Moves, 10);
+	return nullptr;
+}
+
+std::vector<std::string> getStateSpaceNames() {
+	return { "2x2", "corners", "twistslice", "flipslice", "cornersliceperm", "edgesliceperm" };
+}
+
+uint64_t verifyStateSpace(ThreadPool& threadPool, const IStateSpace& space, uint64_t walkSteps, uint64_t seed) {
+	uint8_t numMoves = space.getNumMoves();
+	const Move* moves = space.getMoves();
+	uint8_t inverse[MaxSpaceMoves];
+	for (uint8_t m = 0; m < numMoves; m++)
+		inverse[m] = static_cast<uint8_t>(std::find(moves, moves + numMoves, getInverseMove(moves[m])) - moves);
+
+	std::atomic<uint64_t> mismatches{ 0 };
+	threadPool.parallelFor(static_cast<UINT>(space.getSize()), GrainSize, [&](UINT begin, UINT end) {
+		uint64_t neighbours[MaxSpaceMoves], back[MaxSpaceMoves], count = 0;
+		for (uint64_t state = begin; state < end; state++) {
+			space.getNeighbours(state, neighbours);
+			for (uint8_t m = 0; m < numMoves; m++) {
+				space.getNeighbours(neighbours[m], back);
+				if (back[inverse[m]] != state && count++ == 0)
+					LOG_ERROR(Solver, "%s: %s then its inverse takes state %llu to %llu", space.getName(), getMoveInfo(moves[m]).notation,
+						static_cast<unsigned long long>(state), static_cast<unsigned long long>(back[inverse[m]]));
+			}
+		}
+		mismatches += count;
+	});
+
+	// the facelet model and fromFacelets are a separate path to the same states
+	Random random(seed);
+	CubeModel cube;
+	CubieCube cubie;
+	uint64_t state = space.getSolved(), neighbours[MaxSpaceMoves];
+	for (uint64_t step = 0; step < walkSteps; step++) {
+		uint8_t m = static_cast<uint8_t>(random.below(numMoves));
+		cube.apply(moves[m]);
+		space.getNeighbours(state, neighbours);
+		state = neighbours[m];
+		if (!cubie.fromFacelets(cube) || space.getState(cubie) != state) {
+			if (mismatches++ == 0)
+				LOG_ERROR(Solver, "%s: walk step %llu (%s) disagrees with the facelet model", space.getName(),
+					static_cast<unsigned long long>(step), getMoveInfo(moves[m]).notation);
+			cube.reset();
+			state = space.getSolved();
+		}
+	}
+	return mismatches;
+}
+
+
+StateSpaceExplorer::StateSpaceExplorer(const IStateSpace& space, ThreadPool& threadPool) : space(space), threadPool(threadPool) {
+
+}
+
+StateSpaceExplorer::~StateSpaceExplorer() {
+
+}
+
+bool StateSpaceExplorer::claim(uint64_t state) {
+	// a plain load first, most neighbours late in the search are already visited and need no locked instruction
+	auto& word = visited[state >> 6];
+	uint64_t bit = 1ull << (state & 63);
+	if (word.load(std::memory_order_relaxed) & bit)
+		return false;
+	return !(word.fetch_or(bit, std::memory_order_relaxed) & bit);
+}
+
+void StateSpaceExplorer::setDistance(uint64_t state, uint8_t distance) {
+	// the nibble is still all ones and only the thread that claimed the state writes it, so an and sets it
+	int shift = (state & 1) * 4;
+	distances[state >> 1].fetch_and(static_cast<uint8_t>(~(0xf << shift) | (distance << shift)), std::memory_order_relaxed);
+}
+
+bool StateSpaceExplorer::run(const ExploreOptions& options) {
+	auto startTime = std::chrono::steady_clock::now();
+	uint64_t size = space.getSize();
+	uint8_t numMoves = space.getNumMoves();
+
+	size_t words = static_cast<size_t>((size + 63) / 64);
+	visited.reset(new std::atomic<uint64_t>[words]);
+	for (size_t i = 0; i < words; i++)
+		visited[i].store(0, std::memory_order_relaxed);
+
+	distances.reset();
+	distancesValid = options.keepDistances;
+	if (options.keepDistances) {
+		size_t bytes = static_cast<size_t>((size + 1) / 2);
+		distances.reset(new std::atomic<uint8_t>[bytes]);
+		for (size_t i = 0; i < bytes; i++)
+			distances[i].store(0xff, std::memory_order_relaxed);
+	}
+
+	std::string path0, path1;
+	if (!options.frontierPath.empty()) {
+		path0 = options.frontierPath + ".0";
+		path1 = options.frontierPath + ".1";
+	}
+	Frontier frontiers[2] = { { path0, options.frontierMemory }, { path1, options.frontierMemory } };
+	Frontier* current = &frontiers[0];
+	Frontier* next = &frontiers[1];
+
+	uint64_t solved = space.getSolved();
+	claim(solved);
+	if (distances)
+		setDistance(solved, 0);
+	current->append(&solved, 1);
+	depthCounts.assign(1, 1);
+	reached = 1;
+
+	for (uint8_t depth = 0;; depth++) {
+		uint8_t distance = depth + 1;
+		bool writeDistance = distances && distancesValid && distance < DistanceTable::Unvisited;
+
+		next->clear();
+		bool read = current->forEachBlock([&](const uint64_t* states, size_t count) {
+			threadPool.parallelFor(static_cast<UINT>(count), GrainSize, [&](UINT begin, UINT end) {
+				std::vector<uint64_t> found;
+				found.reserve(FlushSize + MaxSpaceMoves);
+				uint64_t neighbours[MaxSpaceMoves];
+				for (UINT i = begin; i < end; i++) {
+					space.getNeighbours(states[i], neighbours);
+					for (uint8_t m = 0; m < numMoves; m++) {
+						if (!claim(neighbours[m]))
+							continue;
+						if (writeDistance)
+							setDistance(neighbours[m], distance);
+						found.push_back(neighbours[m]);
+					}
+					if (found.size() >= FlushSize) {
+						next->append(found.data(), found.size());
+						found.clear();
+					}
+				}
+				next->append(found.data(), found.size());
+			});
+		});
+
+		if (!read || next->hasFailed()) {
+			LOG_ERROR(Solver, "%s: could not use the frontier file %s", space.getName(), options.frontierPath.c_str());
+			return false;
+		}
+		if (next->size() == 0)
+			break;
+
+		if (distances && distancesValid && !writeDistance) {
+			LOG_WARN(Solver, "%s goes past depth %u, distances are not kept", space.getName(), DistanceTable::Unvisited - 1);
+			distancesValid = false;
+		}
+		depthCounts.push_back(next->size());
+		reached += next->size();
+		LOG_DEBUG(Solver, "%s depth %u: %llu states", space.getName(), distance, static_cast<unsigned long long>(next->size()));
+		std::swap(current, next);
+	}
+
+	seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	return true;
+}
+
+const std::vector<uint64_t>& StateSpaceExplorer::getDepthCounts() const {
+	return depthCounts;
+}
+
+uint64_t StateSpaceExplorer::getReached() const {
+	return reached;
+}
+
+double StateSpaceExplorer::getSeconds() const {
+	return seconds;
+}
+
+uint8_t StateSpaceExplorer::getDistance(uint64_t state) const {
+	if (!distances || !distancesValid)
+		return DistanceTable::Unvisited;
+	return (distances[state >> 1].load(std::memory_order_relaxed) >> ((state & 1) * 4)) & 0xf;
+}
+
+bool StateSpaceExplorer::writeDistances(const std::string& path) const {
+	static_assert(sizeof(std::atomic<uint8_t>) == 1, "distances are written straight from the atomic table");
+	if (!distances || !distancesValid)
+		return false;
+
+	DistanceFileHeader header = {};
+	std::copy(DistanceMagic, DistanceMagic + 4, header.magic);
+	header.version = DistanceVersion;
+	strncpy(header.space, space.getName(), sizeof(header.space) - 1);
+	header.size = space.getSize();
+	header.maxDepth = static_cast<uint32_t>(depthCounts.size() - 1);
+
+	std::string tempPath = path + ".tmp";
+	FILE* file = fopen(tempPath.c_str(), "wb");
+	if (!file)
+		return false;
+	size_t bytes = static_cast<size_t>((header.size + 1) / 2);
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+		fwrite(reinterpret_cast<const uint8_t*>(distances.get()), 1, bytes, file) == bytes;
+	written = fclose(file) == 0 && written;
+
+	if (!written || !replaceFile(tempPath, path)) {
+		std::remove(tempPath.c_str());
+		return false;
+	}
+	return true;
+}
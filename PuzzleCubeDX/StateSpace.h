@@ -0,0 +1,95 @@
+// whole state spaces of small puzzles and cube coordinates
+#pragma once
+#include "Coordinates.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+constexpr uint8_t MaxSpaceMoves = 18;
+
+// a puzzle state space ranked 0 .. size-1 with a fixed set of moves, eg. a pair of solver coordinates or the 2x2 cube
+class IStateSpace {
+public:
+	virtual ~IStateSpace() = default;
+
+	virtual const char* getName() const = 0;
+	virtual uint64_t getSize() const = 0;
+	virtual uint8_t getNumMoves() const = 0;
+	virtual const Move* getMoves() const = 0;
+
+	// rank of the part of cube this space tracks
+	virtual uint64_t getState(const CubieCube& cube) const = 0;
+
+	// neighbours[m] = state after getMoves()[m]
+	virtual void getNeighbours(uint64_t state, uint64_t* neighbours) const = 0;
+
+	uint64_t getSolved() const { return getState(CubieCube()); }
+};
+
+// 2x2 (3674160 states), corners, twistslice, flipslice, cornersliceperm or edgesliceperm, nullptr for other names.
+// building the move tables takes a moment for the larger ones
+std::unique_ptr<IStateSpace> createStateSpace(const std::string& name);
+std::vector<std::string> getStateSpaceNames();
+
+// checks the move tables against each other and against the facelet model: every move is undone by its inverse on
+// every state, and random walks of walkSteps moves on a CubeModel rank to the same states. returns the mismatches
+uint64_t verifyStateSpace(ThreadPool& threadPool, const IStateSpace& space, uint64_t walkSteps, uint64_t seed);
+
+struct ExploreOptions {
+	bool keepDistances = false;													// 4 bits per state, for writeDistances
+	std::string frontierPath;													// empty keeps every frontier in memory
+	uint64_t frontierMemory = 1ull << 24;										// states per frontier in memory before the rest goes to frontierPath
+};
+
+// breadth first search over every state reachable from solved. the visited set is one bit per state, each depth is a
+// list of states expanded in parallel and the states it finds are collected per thread then appended to the next list.
+// with a frontier path, lists that outgrow frontierMemory spill to a file and are read back in blocks, so only the
+// visited bits (and the distances, if kept) have to fit in memory
+class StateSpaceExplorer {
+public:
+	StateSpaceExplorer(const IStateSpace& space, ThreadPool& threadPool);
+	~StateSpaceExplorer();
+
+	bool run(const ExploreOptions& options);
+
+	// states first reached at each depth, the last entry is the deepest
+	const std::vector<uint64_t>& getDepthCounts() const;
+	uint64_t getReached() const;
+	double getSeconds() const;
+
+	// distance of a state, DistanceTable::Unvisited if not reached or distances were not kept
+	uint8_t getDistance(uint64_t state) const;
+
+	// the distances as a file: DistanceFileHeader then one 4 bit entry per state, the even state in the low nibble like
+	// DistanceTable. written to a temporary name and renamed. false if the distances were not kept or a depth went
+	// past 14
+	bool writeDistances(const std::string& path) const;
+
+private:
+	bool claim(uint64_t state);
+	void setDistance(uint64_t state, uint8_t distance);
+
+	const IStateSpace& space;
+	ThreadPool& threadPool;
+
+	std::unique_ptr<std::atomic<uint64_t>[]> visited;
+	std::unique_ptr<std::atomic<uint8_t>[]> distances;
+	bool distancesValid = false;
+
+	std::vector<uint64_t> depthCounts;
+	uint64_t reached = 0;
+	double seconds = 0.0;
+};
+
+struct DistanceFileHeader {
+	char magic[4];																// PCDT
+	uint32_t version;
+	char space[16];
+	uint64_t size;
+	uint32_t maxDepth;
+	uint32_t reserved;
+};
@@ -0,0 +1,164 @@
+#include "Symmetry.h"
+
+#include <algorithm>
+
+namespace {
+	const uint8_t BitsPerFacelet = 3;
+	const uint8_t FaceletsPerWord = 21;
+
+	// every symmetry as a gather over facelets and a renaming of colors: state' [i] = colorMap[state[gather[i]]]
+	struct SymmetryTable {
+		Facelets gather[NumSymmetries];
+		uint8_t colorMap[NumSymmetries][FaceTotal];
+
+		SymmetryTable() {
+			// position and normal of every facelet, found by asking the model about every sticker there could be
+			int faceletPosition[NumFacelets][3], faceletNormal[NumFacelets][3];
+			for (int p = 0; p < 27; p++) {
+				int position[3] = { p % 3 - 1, p / 3 % 3 - 1, p / 9 - 1 };
+				for (uint8_t face = 0; face < FaceTotal; face++) {
+					auto normal = CubeModel::getFaceNormal(face);
+					uint8_t facelet = CubeModel::faceletAt(position, normal);
+					if (facelet == InvalidFacelet)
+						continue;
+					std::copy(position, position + 3, faceletPosition[facelet]);
+					std::copy(normal, normal + 3, faceletNormal[facelet]);
+				}
+			}
+
+			// the 48 symmetries are the signed permutations of the axes. the even ones with an even number of sign flips
+			// (and the odd ones with an odd number) keep handedness and are the rotations, they go first
+			const int axisOrders[6][3] = { { 0, 1, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 0, 2, 1 }, { 2, 1, 0 }, { 1, 0, 2 } };
+			uint8_t rotations = 0, mirrors = NumSymmetries / 2;
+			for (int order = 0; order < 6; order++) {
+				for (int signs = 0; signs < 8; signs++) {
+					int flips = (signs & 1) + (signs >> 1 & 1) + (signs >> 2 & 1);
+					bool rotation = (order < 3) == (flips % 2 == 0);
+					uint8_t s = rotation ? rotations++ : mirrors++;
+
+					auto transform = [&](const int* v, int* out) {
+						for (int k = 0; k < 3; k++)
+							out[k] = v[axisOrders[order][k]] * (signs >> k & 1 ? -1 : 1);
+					};
+
+					for (uint8_t face = 0; face < FaceTotal; face++) {
+						int normal[3];
+						transform(CubeModel::getFaceNormal(face), normal);
+						int center[3] = { normal[0], normal[1], normal[2] };
+						colorMap[s][face] = CubeModel::faceletAt(center, normal) / 9;
+					}
+
+					// facelet i moves to target, so the new state at target gathers from i
+					for (uint8_t i = 0; i < NumFacelets; i++) {
+						int position[3], normal[3];
+						transform(faceletPosition[i], position);
+						transform(faceletNormal[i], normal);
+						gather[s][CubeModel::faceletAt(position, normal)] = i;
+					}
+				}
+			}
+		}
+	};
+
+	const SymmetryTable& getSymmetryTable() {
+		static SymmetryTable symmetryTable;
+		return symmetryTable;
+	}
+
+	inline uint64_t mix(uint64_t x) {
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdull;
+		x ^= x >> 33;
+		x *= 0xc4ceb9fe1a85ec53ull;
+		x ^= x >> 33;
+		return x;
+	}
+}
+
+
+bool StateKey::operator==(const StateKey& other) const {
+	return words[0] == other.words[0] && words[1] == other.words[1] && words[2] == other.words[2];
+}
+
+bool StateKey::operator<(const StateKey& other) const {
+	return std::lexicographical_compare(words, words + 3, other.words, other.words + 3);
+}
+
+uint64_t StateKey::getHash() const {
+	uint64_t hash = mix(words[0] ^ mix(words[1] ^ mix(words[2] + 0x9e3779b97f4a7c15ull)));
+	return hash ? hash : 1;
+}
+
+StateKey packState(const Facelets& facelets) {
+	StateKey key;
+	uint8_t i = 0;
+	for (auto& word : key.words) {
+		word = 0;
+		for (uint8_t slot = 0; slot < FaceletsPerWord; slot++, i++)
+			word = word << BitsPerFacelet | (i < NumFacelets ? facelets[i] : 0);
+	}
+	return key;
+}
+
+void applySymmetry(const Facelets& facelets, uint8_t symmetry, Facelets& out) {
+	auto& table = getSymmetryTable();
+	auto& gather = table.gather[symmetry];
+	auto colorMap = table.colorMap[symmetry];
+	for (uint8_t i = 0; i < NumFacelets; i++)
+		out[i] = colorMap[facelets[gather[i]]];
+}
+
+bool applySymmetry(const CubieCube& cube, uint8_t symmetry, CubieCube& out) {
+	CubeModel model;
+	Facelets facelets;
+	cube.toFacelets(model);
+	applySymmetry(model.getFacelets(), symmetry, facelets);
+	model.setFacelets(facelets);
+	return out.fromFacelets(model);
+}
+
+uint8_t getSymmetryFace(uint8_t symmetry, uint8_t face) {
+	return getSymmetryTable().colorMap[symmetry][face];
+}
+
+StateKey getCanonicalKey(const Facelets& facelets, bool colorPermutations, uint8_t* symmetry) {
+	auto& table = getSymmetryTable();
+	Facelets best, candidate;
+	uint8_t bestSymmetry = 0;
+
+	// candidates are built facelet by facelet and dropped as soon as they compare greater than the best so far, most
+	// of them only get a few facelets in
+	for (uint8_t s = 0; s < NumSymmetries; s++) {
+		auto& gather = table.gather[s];
+		uint8_t colorMap[FaceTotal];
+		uint8_t nextColor = 0;
+		if (colorPermutations)
+			std::fill(colorMap, colorMap + FaceTotal, FaceTotal);
+		else
+			std::copy(table.colorMap[s], table.colorMap[s] + FaceTotal, colorMap);
+
+		bool smaller = s == 0;
+		uint8_t i = 0;
+		for (; i < NumFacelets; i++) {
+			uint8_t& color = colorMap[facelets[gather[i]]];
+			if (color == FaceTotal)
+				color = nextColor++;
+			candidate[i] = color;
+
+			if (!smaller) {
+				if (candidate[i] > best[i])
+					break;
+				smaller = candidate[i] < best[i];
+			}
+		}
+
+		if (i == NumFacelets && smaller) {
+			best = candidate;
+			bestSymmetry = s;
+		}
+	}
+
+	if (symmetry)
+		*symmetry = bestSymmetry;
+	return packState(best);
+}
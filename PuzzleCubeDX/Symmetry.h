@@ -0,0 +1,33 @@
+// cube symmetries and canonical states
+#pragma once
+#include "CubieCube.h"
+
+constexpr uint8_t NumSymmetries = 48;											// 24 rotations, then their mirror images
+
+// a facelet state packed 3 bits per facelet, facelet 0 in the top bits of words[0]. comparing keys compares the facelets
+// in order
+struct StateKey {
+	uint64_t words[3];
+
+	bool operator==(const StateKey& other) const;
+	bool operator<(const StateKey& other) const;
+
+	// 64 bit hash, never 0 so a table can use 0 for empty
+	uint64_t getHash() const;
+};
+
+StateKey packState(const Facelets& facelets);
+
+// the state seen through a symmetry of the cube: the whole cube is rotated (or mirrored), the move sequence that made
+// the state is rotated with it, and the colors are renamed so the centers keep their colors. ie. S * state * S^-1
+void applySymmetry(const Facelets& facelets, uint8_t symmetry, Facelets& out);
+// the same on the cubie level, through the facelets. false if cube is not a valid cube
+bool applySymmetry(const CubieCube& cube, uint8_t symmetry, CubieCube& out);
+
+// the face a symmetry carries face to
+uint8_t getSymmetryFace(uint8_t symmetry, uint8_t face);
+
+// smallest key among the 48 symmetric states, so states that only differ by a symmetry get the same key. with
+// colorPermutations the colors are also renamed freely, in order of first appearance, so recolored cubes match too.
+// symmetry (if given) gets the one that produced the key
+StateKey getCanonicalKey(const Facelets& facelets, bool colorPermutations = false, uint8_t* symmetry = nullptr);
@@ -0,0 +1,55 @@
+#include "TranspositionTable.h"
+
+TranspositionTable::TranspositionTable(size_t requested) {
+	capacity = BucketSize;
+	while (capacity < requested)
+		capacity <<= 1;
+	bucketMask = capacity / BucketSize - 1;
+	entries.reset(new Entry[capacity]);
+}
+
+bool TranspositionTable::find(uint64_t hash, uint64_t& value) const {
+	const Entry* bucket = &entries[(hash & bucketMask) * BucketSize];
+	for (uint32_t i = 0; i < BucketSize; i++) {
+		uint64_t check = bucket[i].check.load(std::memory_order_acquire);
+		uint64_t stored = bucket[i].value.load(std::memory_order_relaxed);
+		if ((check ^ stored) == hash) {
+			value = stored;
+			return true;
+		}
+	}
+	return false;
+}
+
+void TranspositionTable::store(uint64_t hash, uint64_t value) {
+	Entry* bucket = &entries[(hash & bucketMask) * BucketSize];
+
+	// the entry already holding this hash, else an empty one, else one picked by the upper hash bits
+	Entry* target = nullptr;
+	for (uint32_t i = 0; i < BucketSize && !target; i++) {
+		uint64_t check = bucket[i].check.load(std::memory_order_relaxed);
+		uint64_t stored = bucket[i].value.load(std::memory_order_relaxed);
+		if ((check ^ stored) == hash)
+			target = &bucket[i];
+	}
+	for (uint32_t i = 0; i < BucketSize && !target; i++) {
+		if (bucket[i].check.load(std::memory_order_relaxed) == 0 && bucket[i].value.load(std::memory_order_relaxed) == 0)
+			target = &bucket[i];
+	}
+	if (!target)
+		target = &bucket[hash >> 62];
+
+	target->value.store(value, std::memory_order_relaxed);
+	target->check.store(hash ^ value, std::memory_order_release);
+}
+
+void TranspositionTable::clear() {
+	for (size_t i = 0; i < capacity; i++) {
+		entries[i].check.store(0, std::memory_order_relaxed);
+		entries[i].value.store(0, std::memory_order_relaxed);
+	}
+}
+
+size_t TranspositionTable::getCapacity() const {
+	return capacity;
+}
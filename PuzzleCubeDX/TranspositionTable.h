@@ -0,0 +1,35 @@
+// lock free transposition table
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// fixed size hash table from 64 bit state hashes (StateKey::getHash) to a 64 bit value whose meaning is up to the user,
+// eg. a distance and a best move. any number of threads can find and store at the same time without locks: an entry
+// keeps hash ^ value next to the value, so a torn write from two threads storing at once just reads as a miss.
+// a hash lands in a bucket of 4 entries, when all 4 hold other hashes one of them is replaced. two states with the
+// same 64 bit hash share an entry, about one in 2^64 per lookup
+class TranspositionTable {
+public:
+	static constexpr uint32_t BucketSize = 4;
+
+	// capacity is rounded up to a power of two entries, 16 bytes each
+	TranspositionTable(size_t capacity);
+
+	bool find(uint64_t hash, uint64_t& value) const;
+	void store(uint64_t hash, uint64_t value);
+	void clear();
+
+	size_t getCapacity() const;
+
+private:
+	struct Entry {
+		std::atomic<uint64_t> check{ 0 };											// hash ^ value, 0 with value 0 is empty
+		std::atomic<uint64_t> value{ 0 };
+	};
+
+	std::unique_ptr<Entry[]> entries;
+	size_t capacity;
+	size_t bucketMask;
+};
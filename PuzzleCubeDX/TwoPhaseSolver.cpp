@@ -0,0 +1,547 @@
+#include "TwoPhaseSolver.h"
+#include "Scheduler.h"
+#include "Symmetry.h"
+#include "MappedFile.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <memory>
+
+namespace {
+	const char CacheMagic[4] = { 'P', 'C', 'T', 'P' };
+	const uint32_t CacheVersion = 3;											// 3: phase 1 pruning on flip, slice and twist
+	const uint8_t NumPhase1Moves = TwoPhaseSolver::NumFaceMoves;
+	const uint8_t NumViews = 6;													// 3 axes, then the same for the inverse
+
+	// the 18 face moves are the first Move ids, phase 2 keeps to quarter turns of U and D and half turns of the rest
+	const Move phase2Moves[TwoPhaseSolver::NumPhase2Moves] = {
+		MoveU, MoveUi, MoveU2, MoveD, MoveDi, MoveD2, MoveR2, MoveL2, MoveF2, MoveB2
+	};
+
+	// the phase 1 coordinates, and the phase 2 ones that can be followed cheaply on the way
+	struct Phase1State {
+		uint16_t twist, flip, slice;
+		uint16_t cornerPerm, sliceSorted;
+	};
+
+	// a move is not worth trying after one on the same face, and of two opposite faces only one order is tried
+	bool isRedundant(Move move, int previous) {
+		if (previous < 0)
+			return false;
+		int face = move / 3, previousFace = previous / 3;
+		if (face == previousFace)
+			return true;
+		return getMoveInfo(move).turn.axis == getMoveInfo(static_cast<Move>(previous)).turn.axis && face < previousFace;
+	}
+
+	// breadth first from the solved pair, one sweep over the table per depth
+	void buildPruneTable(DistanceTable& table, uint32_t size1, uint32_t size2, const std::vector<uint16_t>& move1,
+		const std::vector<uint16_t>& move2, uint8_t numMoves, uint32_t solved) {
+		table.reset(size1 * size2);
+		table.set(solved, 0);
+
+		bool changed = true;
+		for (uint8_t depth = 0; changed; depth++) {
+			changed = false;
+			for (uint32_t i = 0; i < table.getSize(); i++) {
+				if (table.get(i) != depth)
+					continue;
+
+				uint32_t coord1 = i / size2, coord2 = i % size2;
+				for (uint8_t m = 0; m < numMoves; m++) {
+					uint32_t next = move1[coord1 * numMoves + m] * size2 + move2[coord2 * numMoves + m];
+					if (table.get(next) == DistanceTable::Unvisited) {
+						table.set(next, depth + 1);
+						changed = true;
+					}
+				}
+			}
+		}
+	}
+
+	template <typename T>
+	void writeTable(std::ofstream& file, const std::vector<T>& table) {
+		file.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(T));
+	}
+
+	template <typename T>
+	bool readTable(std::ifstream& file, std::vector<T>& table, size_t size) {
+		table.resize(size);
+		file.read(reinterpret_cast<char*>(table.data()), size * sizeof(T));
+		return file.good();
+	}
+
+	void writeTable(std::ofstream& file, const DistanceTable& table) {
+		file.write(reinterpret_cast<const char*>(table.getData()), table.getByteSize());
+	}
+
+	bool readTable(std::ifstream& file, DistanceTable& table, size_t size) {
+		table.reset(size);
+		file.read(reinterpret_cast<char*>(table.getData()), table.getByteSize());
+		return file.good();
+	}
+}
+
+
+// one solve call. keeps the current move sequence and the best solution so far, the tables are shared read only
+struct TwoPhaseSearch {
+	static constexpr uint8_t MaxPathLength = 31;
+	static constexpr uint8_t MaxPhase2Length = 10;								// longer ones are better left to a longer phase 1
+
+	const TwoPhaseSolver& solver;
+	CubieCube starts[NumViews];
+	uint8_t view = 0;															// the one being searched
+	uint8_t maxLength;
+	uint8_t bestLength = MaxPathLength + 1;
+	std::chrono::steady_clock::time_point deadline;
+	uint64_t nodes = 0;
+	bool timedOut = false;
+	Move path[MaxPathLength];
+	std::vector<Move> solution;
+
+	TwoPhaseSearch(const TwoPhaseSolver& solver, const CubieCube& start, uint8_t maxLength, double timeoutSeconds) :
+		solver(solver), maxLength(maxLength),
+		deadline(std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<double>(timeoutSeconds))) {
+		CubieCube inverse = start.getInverse();
+		for (uint8_t v = 0; v < NumViews; v++)
+			applySymmetry(v < 3 ? start : inverse, solver.viewSymmetry[v % 3], starts[v]);
+	}
+
+	// longer phase 1 solutions keep coming with a tighter bound on phase 2, until one fits maxLength. the views take
+	// turns at each phase 1 depth and share the best length, so whichever view has the short solution finds it early
+	bool run() {
+		Phase1State states[NumViews];
+		for (uint8_t v = 0; v < NumViews; v++) {
+			auto& cube = starts[v];
+			states[v] = { cube.getTwist(), cube.getFlip(), cube.getSlice(), cube.getCornerPerm(),
+				static_cast<uint16_t>(TwoPhaseSolver::SliceSortedCoord::get(cube)) };
+		}
+
+		for (uint8_t depth = 0; depth < bestLength && !timedOut; depth++) {
+			for (view = 0; view < NumViews && !timedOut; view++) {
+				if (phase1(states[view], 0, depth))
+					return true;
+			}
+		}
+		return bestLength <= MaxPathLength;
+	}
+
+	// path is a solution of the current view, as moves on the cube that was given
+	void storeSolution() {
+		solution.clear();
+		for (uint8_t i = 0; i < bestLength; i++)
+			solution.push_back(solver.viewMoves[view % 3][path[i]]);
+		if (view >= 3) {
+			std::reverse(solution.begin(), solution.end());
+			for (auto& move : solution)
+				move = getInverseMove(move);
+		}
+	}
+
+	bool checkTimeout() {
+		if ((++nodes & 4095) == 0 && std::chrono::steady_clock::now() > deadline)
+			timedOut = true;
+		return timedOut;
+	}
+
+	uint8_t phase1Distance(const Phase1State& state) const {
+		uint32_t flipSlice = state.slice * NumFlip + state.flip;
+		uint32_t twistInClass = solver.twistConj[state.twist * TwoPhaseSolver::NumUDSymmetries + solver.flipSliceSym[flipSlice]];
+		return solver.phase1Prune.get(static_cast<size_t>(solver.flipSliceClass[flipSlice]) * NumTwist + twistInClass);
+	}
+
+	uint8_t phase2Distance(uint16_t cornerPerm, uint16_t udEdgePerm, uint16_t slicePerm) const {
+		return std::max(solver.cornerSlicePermPrune.get(cornerPerm * NumSlicePerm + slicePerm),
+			solver.edgeSlicePermPrune.get(udEdgePerm * NumSlicePerm + slicePerm));
+	}
+
+	// true once a solution of at most maxLength moves is found, which ends the search
+	bool phase1(const Phase1State& state, uint8_t depth, uint8_t togo) {
+		if (togo == 0) {
+			// a phase 1 solution ending in a phase 2 move is just a shorter one plus a move, phase 2 already tries that
+			if (state.twist != 0 || state.flip != 0 || state.slice != SolvedSlice)
+				return false;
+			if (depth > 0 && (path[depth - 1] % 3 == 2 || getMoveInfo(path[depth - 1]).turn.axis == 1))
+				return false;
+			return phase2Start(state, depth);
+		}
+		if (checkTimeout())
+			return false;
+
+		for (uint8_t m = 0; m < NumPhase1Moves; m++) {
+			Move move = static_cast<Move>(m);
+			if (isRedundant(move, depth > 0 ? path[depth - 1] : -1))
+				continue;
+
+			Phase1State next;
+			next.twist = solver.twistMove[state.twist * NumPhase1Moves + m];
+			next.flip = solver.flipMove[state.flip * NumPhase1Moves + m];
+			next.slice = solver.sliceMove[state.slice * NumPhase1Moves + m];
+			if (phase1Distance(next) >= togo)
+				continue;
+			next.cornerPerm = solver.cornerPermMove[state.cornerPerm * NumPhase1Moves + m];
+			next.sliceSorted = solver.sliceSortedMove[state.sliceSorted * NumPhase1Moves + m];
+
+			path[depth] = move;
+			if (phase1(next, depth + 1, togo - 1))
+				return true;
+			if (timedOut)
+				return false;
+		}
+		return false;
+	}
+
+	bool phase2Start(const Phase1State& state, uint8_t depth1) {
+		// most phase 1 solutions already fail on the corners, the edges are only worked out for the rest
+		uint8_t limit = std::min<uint8_t>(MaxPhase2Length, bestLength - 1 - depth1);
+		uint16_t cornerPerm = state.cornerPerm, slicePerm = solver.slicePermOfSorted[state.sliceSorted];
+		if (solver.cornerSlicePermPrune.get(cornerPerm * NumSlicePerm + slicePerm) > limit)
+			return false;
+
+		CubieCube cube = starts[view];
+		for (uint8_t i = 0; i < depth1; i++)
+			cube.edgeMultiply(CubieCube::getMoveCube(path[i]));
+
+		uint16_t udEdgePerm = cube.getUDEdgePerm();
+		for (uint8_t depth2 = phase2Distance(cornerPerm, udEdgePerm, slicePerm); depth2 <= limit && !timedOut; depth2++) {
+			if (phase2(cornerPerm, udEdgePerm, slicePerm, depth1, depth2)) {
+				bestLength = depth1 + depth2;
+				storeSolution();
+				return bestLength <= maxLength;
+			}
+		}
+		return false;
+	}
+
+	bool phase2(uint16_t cornerPerm, uint16_t udEdgePerm, uint16_t slicePerm, uint8_t depth, uint8_t togo) {
+		if (togo == 0)
+			return cornerPerm == 0 && udEdgePerm == 0 && slicePerm == 0;
+		if (checkTimeout())
+			return false;
+
+		for (uint8_t m = 0; m < TwoPhaseSolver::NumPhase2Moves; m++) {
+			Move move = phase2Moves[m];
+			if (isRedundant(move, depth > 0 ? path[depth - 1] : -1))
+				continue;
+
+			uint16_t nextCornerPerm = solver.cornerPermMove[cornerPerm * NumPhase1Moves + move];
+			uint16_t nextUDEdgePerm = solver.udEdgePermMove[udEdgePerm * TwoPhaseSolver::NumPhase2Moves + m];
+			uint16_t nextSlicePerm = solver.slicePermMove[slicePerm * TwoPhaseSolver::NumPhase2Moves + m];
+			if (phase2Distance(nextCornerPerm, nextUDEdgePerm, nextSlicePerm) >= togo)
+				continue;
+
+			path[depth] = move;
+			if (phase2(nextCornerPerm, nextUDEdgePerm, nextSlicePerm, depth + 1, togo - 1))
+				return true;
+			if (timedOut)
+				return false;
+		}
+		return false;
+	}
+};
+
+
+void TwoPhaseSolver::init(const std::string& cachePath) {
+	auto startTime = std::chrono::steady_clock::now();
+	buildLookupTables();
+	if (!loadTables(cachePath)) {
+		generateTables();
+		saveTables(cachePath);
+	}
+
+	LOG_INFO(Solver, "two-phase tables ready in %.2fs", std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count());
+	ready.store(true, std::memory_order_release);
+}
+
+bool TwoPhaseSolver::isReady() const {
+	return ready.load(std::memory_order_acquire);
+}
+
+bool TwoPhaseSolver::solve(const CubeModel& cube, std::vector<Move>& solution, uint8_t maxLength, double timeoutSeconds,
+	SolveStats* stats) const {
+	CubieCube cubie;
+	if (!cubie.fromFacelets(cube))
+		return false;
+	return solve(cubie, solution, maxLength, timeoutSeconds, stats);
+}
+
+bool TwoPhaseSolver::solve(const CubieCube& cube, std::vector<Move>& solution, uint8_t maxLength, double timeoutSeconds,
+	SolveStats* stats) const {
+	if (!isReady())
+		return false;
+
+	auto startTime = std::chrono::steady_clock::now();
+	TwoPhaseSearch search(*this, cube, maxLength, timeoutSeconds);
+	bool found = search.run();
+	if (found)
+		solution = search.solution;
+
+	if (stats) {
+		stats->nodes = search.nodes;
+		stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	}
+	return found;
+}
+
+void TwoPhaseSolver::generateTables() {
+	Move faceMoves[NumPhase1Moves];
+	for (uint8_t m = 0; m < NumPhase1Moves; m++)
+		faceMoves[m] = static_cast<Move>(m);
+
+	// independent tables are built side by side, the move tables first since the pruning tables walk them
+	ThreadPool pool;
+	std::vector<std::function<void()>> jobs = {
+		[&] { buildMoveTable<TwistCoord>(twistMove, faceMoves, NumPhase1Moves); },
+		[&] { buildMoveTable<FlipCoord>(flipMove, faceMoves, NumPhase1Moves); },
+		[&] { buildMoveTable<SliceCoord>(sliceMove, faceMoves, NumPhase1Moves); },
+		[&] { buildMoveTable<CornerPermCoord>(cornerPermMove, faceMoves, NumPhase1Moves); },
+		[&] { buildMoveTable<SliceSortedCoord>(sliceSortedMove, faceMoves, NumPhase1Moves); },
+		[&] { buildMoveTable<UDEdgePermCoord>(udEdgePermMove, phase2Moves, NumPhase2Moves); },
+		[&] { buildMoveTable<SlicePermCoord>(slicePermMove, phase2Moves, NumPhase2Moves); }
+	};
+	pool.run(jobs);
+
+	// the pruning table walks the corners with the phase 2 moves only
+	std::vector<uint16_t> cornerPhase2Move(NumCornerPerm * NumPhase2Moves);
+	for (uint32_t i = 0; i < NumCornerPerm; i++) {
+		for (uint8_t m = 0; m < NumPhase2Moves; m++)
+			cornerPhase2Move[i * NumPhase2Moves + m] = cornerPermMove[i * NumPhase1Moves + phase2Moves[m]];
+	}
+
+	jobs = {
+		[&] { buildPruneTable(cornerSlicePermPrune, NumCornerPerm, NumSlicePerm, cornerPhase2Move, slicePermMove, NumPhase2Moves, 0); },
+		[&] { buildPruneTable(edgeSlicePermPrune, NumUDEdgePerm, NumSlicePerm, udEdgePermMove, slicePermMove, NumPhase2Moves, 0); }
+	};
+	pool.run(jobs);
+	buildPhase1PruneTable(pool);
+}
+
+void TwoPhaseSolver::buildLookupTables() {
+	// the first rotation taking each axis onto U/D, and what the face moves turn into under it
+	const uint8_t axisFaces[3] = { FaceTop, FaceRight, FaceFront };
+	for (uint8_t axis = 0; axis < 3; axis++) {
+		uint8_t s = 0;
+		while (getSymmetryFace(s, axisFaces[axis]) != FaceTop)
+			s++;
+		viewSymmetry[axis] = s;
+
+		for (uint8_t m = 0; m < NumFaceMoves; m++) {
+			CubieCube symmetric;
+			applySymmetry(CubieCube::getMoveCube(static_cast<Move>(m)), s, symmetric);
+			uint8_t viewMove = 0;
+			while (!(CubieCube::getMoveCube(static_cast<Move>(viewMove)) == symmetric))
+				viewMove++;
+			viewMoves[axis][viewMove] = static_cast<Move>(m);
+		}
+	}
+
+	// phase 1 follows where the E slice edges are, phase 2 their order once they are in the slice
+	slicePermOfSorted.assign(SliceSortedCoord::Size, 0);
+	CubieCube cube;
+	for (uint8_t perm = 0; perm < NumSlicePerm; perm++) {
+		cube.setSlicePerm(perm);
+		slicePermOfSorted[SliceSortedCoord::get(cube)] = perm;
+	}
+
+	// the symmetries that keep U and D on the U/D axis, the identity first
+	uint8_t symmetries[NumUDSymmetries];
+	uint8_t count = 0;
+	for (uint8_t s = 0; s < NumSymmetries; s++) {
+		uint8_t top = getSymmetryFace(s, FaceTop);
+		if (top == FaceTop || top == FaceBottom)
+			symmetries[count++] = s;
+	}
+
+	// conjugating the twist only depends on the twist. the flip also depends on where the slice edges are, since a
+	// quarter turn of the whole cube about U/D flips the E slice edges. flip bits just move to other slots, so that
+	// part can be added to the conjugated flip of the solved slice by xor
+	std::vector<uint16_t> flipConj(NumFlip * NumUDSymmetries), sliceConj(NumSlice * NumUDSymmetries), sliceFlip(NumSlice * NumUDSymmetries);
+	twistConj.resize(NumTwist * NumUDSymmetries);
+	for (uint8_t k = 0; k < NumUDSymmetries; k++) {
+		CubieCube symmetric;
+		cube = CubieCube();
+		for (uint16_t twist = 0; twist < NumTwist; twist++) {
+			cube.setTwist(twist);
+			applySymmetry(cube, symmetries[k], symmetric);
+			twistConj[twist * NumUDSymmetries + k] = symmetric.getTwist();
+		}
+
+		cube = CubieCube();
+		for (uint16_t flip = 0; flip < NumFlip; flip++) {
+			cube.setFlip(flip);
+			applySymmetry(cube, symmetries[k], symmetric);
+			flipConj[flip * NumUDSymmetries + k] = symmetric.getFlip();
+		}
+
+		for (uint16_t slice = 0; slice < NumSlice; slice++) {
+			// swapping two corners keeps the cube valid whatever the parity of the edges setSlice left
+			cube = CubieCube();
+			cube.setSlice(slice);
+			if (isOddPermutation(cube.ep, EdgeCount))
+				std::swap(cube.cp[0], cube.cp[1]);
+			applySymmetry(cube, symmetries[k], symmetric);
+			sliceConj[slice * NumUDSymmetries + k] = symmetric.getSlice();
+			sliceFlip[slice * NumUDSymmetries + k] = symmetric.getFlip();
+		}
+	}
+
+	// the smallest flipSlice of each class represents it. going up from 0, a class is new exactly when its smallest
+	// member comes up
+	flipSliceClass.resize(NumFlipSlice);
+	flipSliceSym.resize(NumFlipSlice);
+	classFlipSlice.clear();
+	classStabilizer.clear();
+	for (uint32_t flipSlice = 0; flipSlice < NumFlipSlice; flipSlice++) {
+		uint32_t slice = flipSlice / NumFlip, flip = flipSlice % NumFlip;
+		uint32_t smallest = flipSlice;
+		uint8_t smallestSym = 0;
+		uint16_t stabilizer = 0;
+		for (uint8_t k = 0; k < NumUDSymmetries; k++) {
+			uint32_t symmetric = sliceConj[slice * NumUDSymmetries + k] * NumFlip +
+				(flipConj[flip * NumUDSymmetries + k] ^ sliceFlip[slice * NumUDSymmetries + k]);
+			if (symmetric < smallest) {
+				smallest = symmetric;
+				smallestSym = k;
+			}
+			if (symmetric == flipSlice)
+				stabilizer |= 1 << k;
+		}
+
+		if (smallest == flipSlice) {
+			flipSliceClass[flipSlice] = static_cast<uint16_t>(classFlipSlice.size());
+			classFlipSlice.push_back(flipSlice);
+			classStabilizer.push_back(stabilizer);
+		}
+		else {
+			flipSliceClass[flipSlice] = flipSliceClass[smallest];
+		}
+		flipSliceSym[flipSlice] = smallestSym;
+	}
+}
+
+void TwoPhaseSolver::buildPhase1PruneTable(ThreadPool& pool) {
+	static_assert(sizeof(std::atomic<uint8_t>) == 1, "the table is copied straight from the atomic one");
+
+	// breadth first like buildPruneTable, split over the pool. an entry is a class representative with some twist, when
+	// the representative is symmetric to itself its twist conjugates are the same state and get set together
+	uint32_t size = static_cast<uint32_t>(classFlipSlice.size()) * NumTwist;
+	std::unique_ptr<std::atomic<uint8_t>[]> table(new std::atomic<uint8_t>[(size + 1) / 2]);
+	for (uint32_t i = 0; i < (size + 1) / 2; i++)
+		table[i].store(0xff, std::memory_order_relaxed);
+
+	auto setState = [&](uint32_t index, uint8_t distance) {
+		uint32_t classIndex = index / NumTwist, twist = index % NumTwist;
+		uint64_t count = DistanceTable::setUnvisited(table.get(), index, distance);
+		uint16_t stabilizer = classStabilizer[classIndex];
+		for (uint8_t k = 1; k < NumUDSymmetries; k++) {
+			if (stabilizer >> k & 1)
+				count += DistanceTable::setUnvisited(table.get(), classIndex * NumTwist + twistConj[twist * NumUDSymmetries + k], distance);
+		}
+		return count;
+	};
+
+	auto neighbour = [&](uint32_t index, uint8_t m) {
+		uint32_t flipSlice = classFlipSlice[index / NumTwist], twist = index % NumTwist;
+		uint32_t next = sliceMove[flipSlice / NumFlip * NumPhase1Moves + m] * NumFlip + flipMove[flipSlice % NumFlip * NumPhase1Moves + m];
+		return flipSliceClass[next] * NumTwist + twistConj[twistMove[twist * NumPhase1Moves + m] * NumUDSymmetries + flipSliceSym[next]];
+	};
+
+	uint64_t frontier = setState(flipSliceClass[SolvedSlice * NumFlip] * NumTwist, 0);
+	uint64_t remaining = size - frontier;
+	for (uint8_t depth = 0; remaining > 0 && frontier > 0; depth++) {
+		std::atomic<uint64_t> found{ 0 };
+		bool backward = frontier > remaining;
+
+		pool.parallelFor(size, 1 << 16, [&](UINT begin, UINT end) {
+			uint64_t count = 0;
+			for (uint32_t i = begin; i < end; i++) {
+				uint8_t entry = DistanceTable::get(table.get(), i);
+				if (backward) {
+					if (entry != DistanceTable::Unvisited)
+						continue;
+					for (uint8_t m = 0; m < NumPhase1Moves; m++) {
+						if (DistanceTable::get(table.get(), neighbour(i, m)) == depth) {
+							count += setState(i, depth + 1);
+							break;
+						}
+					}
+				}
+				else if (entry == depth) {
+					for (uint8_t m = 0; m < NumPhase1Moves; m++)
+						count += setState(neighbour(i, m), depth + 1);
+				}
+			}
+			found += count;
+		});
+
+		frontier = found;
+		remaining -= frontier;
+	}
+
+	phase1Prune.reset(size);
+	std::copy(reinterpret_cast<const uint8_t*>(table.get()), reinterpret_cast<const uint8_t*>(table.get()) + phase1Prune.getByteSize(),
+		phase1Prune.getData());
+}
+
+bool TwoPhaseSolver::loadTables(const std::string& cachePath) {
+	std::ifstream file(cachePath, std::ios::binary);
+	if (!file)
+		return false;
+
+	char magic[4];
+	uint32_t version = 0;
+	file.read(magic, sizeof(magic));
+	file.read(reinterpret_cast<char*>(&version), sizeof(version));
+	if (!file || !std::equal(magic, magic + 4, CacheMagic) || version != CacheVersion) {
+		LOG_WARN(Solver, "ignoring two-phase cache %s, wrong format", cachePath.c_str());
+		return false;
+	}
+
+	bool loaded = readTable(file, twistMove, NumTwist * NumPhase1Moves) &&
+		readTable(file, flipMove, NumFlip * NumPhase1Moves) &&
+		readTable(file, sliceMove, NumSlice * NumPhase1Moves) &&
+		readTable(file, cornerPermMove, NumCornerPerm * NumPhase1Moves) &&
+		readTable(file, sliceSortedMove, SliceSortedCoord::Size * NumPhase1Moves) &&
+		readTable(file, udEdgePermMove, NumUDEdgePerm * NumPhase2Moves) &&
+		readTable(file, slicePermMove, NumSlicePerm * NumPhase2Moves) &&
+		readTable(file, phase1Prune, classFlipSlice.size() * NumTwist) &&
+		readTable(file, cornerSlicePermPrune, NumCornerPerm * NumSlicePerm) &&
+		readTable(file, edgeSlicePermPrune, NumUDEdgePerm * NumSlicePerm);
+	if (!loaded)
+		LOG_WARN(Solver, "ignoring two-phase cache %s, file is truncated", cachePath.c_str());
+	return loaded;
+}
+
+void TwoPhaseSolver::saveTables(const std::string& cachePath) const {
+	// written to a temporary name and renamed, so a crash or a full disk never leaves half a cache behind
+	std::string tempPath = cachePath + ".tmp";
+	std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		LOG_WARN(Solver, "could not write two-phase cache %s", cachePath.c_str());
+		return;
+	}
+
+	file.write(CacheMagic, sizeof(CacheMagic));
+	file.write(reinterpret_cast<const char*>(&CacheVersion), sizeof(CacheVersion));
+	writeTable(file, twistMove);
+	writeTable(file, flipMove);
+	writeTable(file, sliceMove);
+	writeTable(file, cornerPermMove);
+	writeTable(file, sliceSortedMove);
+	writeTable(file, udEdgePermMove);
+	writeTable(file, slicePermMove);
+	writeTable(file, phase1Prune);
+	writeTable(file, cornerSlicePermPrune);
+	writeTable(file, edgeSlicePermPrune);
+
+	file.close();
+	if (!file || !replaceFile(tempPath, cachePath)) {
+		std::remove(tempPath.c_str());
+		LOG_WARN(Solver, "could not write two-phase cache %s", cachePath.c_str());
+	}
+}
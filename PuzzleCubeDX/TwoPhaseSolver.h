@@ -0,0 +1,78 @@
+// two-phase cube solver
+#pragma once
+#include "CubieCube.h"
+#include "Coordinates.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// Kociemba's two-phase algorithm. phase 1 brings the cube into the subgroup <U, D, R2, L2, F2, B2> (no twisted corners,
+// no flipped edges, E slice edges in the E slice), phase 2 solves it inside that subgroup. both phases are IDA* over
+// small coordinates with move tables and pruning tables. phase 1 keeps producing longer solutions with a tighter limit
+// on phase 2, so the total gets shorter the longer the search runs.
+// every solve searches the cube with each of its 3 axes as U/D, and its inverse the same way, since how deep phase 1
+// has to go depends a lot on the axis.
+// phase 1 prunes on its exact distance from flip, slice and twist together. the 16 symmetries keeping the U/D axis
+// leave phase 1 unchanged, so that table only stores one flip and slice pair per symmetry class (64430 of 1013760)
+// the tables (about 75MB) take a few seconds to build on all cores, so init writes them to a cache file and later runs
+// just load it
+class TwoPhaseSolver {
+public:
+	static constexpr uint8_t NumFaceMoves = 18;
+	static constexpr uint8_t NumPhase2Moves = 10;
+	static constexpr uint8_t NumUDSymmetries = 16;
+	static constexpr uint32_t NumFlipSlice = NumSlice * NumFlip;				// slice * NumFlip + flip
+	typedef EdgePositionCoord<EdgeFR, 4> SliceSortedCoord;						// where each E slice edge is, 11880 ranks
+
+	// load the tables from cachePath, or generate and save them. can run on a background thread, isReady turns true
+	// when done
+	void init(const std::string& cachePath);
+	bool isReady() const;
+
+	// face moves that solve the cube, stops at the first solution of at most maxLength moves. if the timeout hits first
+	// the shortest solution so far is returned instead. false if the tables are not ready, the cube is not valid or
+	// nothing was found in time. stats (if given) gets the nodes visited and the time taken.
+	// solve only reads the tables, so several threads can solve at the same time
+	bool solve(const CubeModel& cube, std::vector<Move>& solution, uint8_t maxLength = 20, double timeoutSeconds = 1.0,
+		SolveStats* stats = nullptr) const;
+	bool solve(const CubieCube& cube, std::vector<Move>& solution, uint8_t maxLength = 20, double timeoutSeconds = 1.0,
+		SolveStats* stats = nullptr) const;
+
+private:
+	friend struct TwoPhaseSearch;
+
+	void buildLookupTables();
+	void generateTables();
+	void buildPhase1PruneTable(ThreadPool& pool);
+	bool loadTables(const std::string& cachePath);
+	void saveTables(const std::string& cachePath) const;
+
+	// move tables, coordinate * moves + move -> coordinate after the move
+	std::vector<uint16_t> twistMove;											// 18 moves
+	std::vector<uint16_t> flipMove;
+	std::vector<uint16_t> sliceMove;
+	std::vector<uint16_t> cornerPermMove;										// also 18 moves, phase 1 carries it along
+	std::vector<uint16_t> sliceSortedMove;
+	std::vector<uint16_t> udEdgePermMove;										// phase 2 moves only
+	std::vector<uint16_t> slicePermMove;
+
+	// built on every init instead of cached, they only take a moment
+	uint8_t viewSymmetry[3];													// rotations taking each axis onto U/D
+	Move viewMoves[3][NumFaceMoves];											// a move after such a rotation -> the move before
+	std::vector<uint8_t> slicePermOfSorted;										// sliceSorted -> slicePerm, once the E slice is home
+	std::vector<uint16_t> flipSliceClass;										// flipSlice -> class
+	std::vector<uint8_t> flipSliceSym;											// flipSlice -> symmetry taking it to its class representative
+	std::vector<uint32_t> classFlipSlice;										// class -> representative
+	std::vector<uint16_t> classStabilizer;										// class -> bit per symmetry fixing the representative
+	std::vector<uint16_t> twistConj;											// twist * NumUDSymmetries + symmetry
+
+	// pruning tables, exact number of moves to solve the coordinates
+	DistanceTable phase1Prune;													// class * NumTwist + twist conjugated into the class
+	DistanceTable cornerSlicePermPrune;											// cornerPerm * NumSlicePerm + slicePerm
+	DistanceTable edgeSlicePermPrune;											// udEdgePerm * NumSlicePerm + slicePerm
+
+	std::atomic<bool> ready{ false };
+};
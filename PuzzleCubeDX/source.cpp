@@ -1,52 +1,66 @@
-#include "Core.h"
-
-std::unique_ptr<Core> core;
-
-LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam) {
-	return core->run(hwnd, msg, wparam, lparam);
-}
-int WINAPI WinMain(HINSTANCE hinstance, HINSTANCE hprevinstance, PSTR mCmdLine, int iShowCmd) {
-
-	core = std::make_unique<Core>(1280, 720);
-
-	WNDCLASSEX wndclass = { 0 };
-	wndclass.cbSize = sizeof(WNDCLASSEX);
-	wndclass.style = CS_HREDRAW | CS_VREDRAW;
-	wndclass.lpfnWndProc = WndProc;
-	wndclass.hInstance = hinstance;
-	wndclass.hCursor = LoadCursor(NULL, IDC_ARROW);
-	wndclass.lpszClassName = L"WndClass";
-	
-	if (!RegisterClassEx(&wndclass)) {
-		MessageBox(0, L"RegisterClass Failed.", 0, 0);
-		return false;
-	}
-
-	RECT windowRect = { 0, 0, static_cast<LONG>(core->getWndWidth()), static_cast<LONG>(core->getWndHeight()) };
-	AdjustWindowRect(&windowRect, WS_OVERLAPPEDWINDOW, FALSE);
-
-	// Create the window and store a handle to it.
-	core->hwnd = CreateWindow(wndclass.lpszClassName, L"Puzzle Cube DX", WS_OVERLAPPEDWINDOW, CW_USEDEFAULT, CW_USEDEFAULT, windowRect.right - windowRect.left, windowRect.bottom - windowRect.top, 0, 0, hinstance, 0);
-	if (!core->hwnd) {
-		MessageBox(0, L"CreateWindow Failed.", 0, 0);
-		return false;
-	}
-
-	core->initialize();
-
-	ShowWindow(core->hwnd, SW_SHOW);
-
-	MSG msg = {};
-	while (msg.message != WM_QUIT) {
-
-		if (PeekMessage(&msg, 0, 0, 0, PM_REMOVE)) {
-			TranslateMessage(&msg);
-			DispatchMessage(&msg);
-		}
-	}
-
-
-	core->destroy();
-
-	return 0;
+#include "Core.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+std::unique_ptr<Core> core;
+
+// cube size from the command line, "PuzzleCubeDX.exe 5" or "--size 5". 3 when it is missing or not a number
+uint16_t parseCubeSize(const char* cmdLine) {
+	const char* p = cmdLine ? strstr(cmdLine, "--size") : nullptr;
+	p = p ? p + 6 : cmdLine;
+	if (!p)
+		return 3;
+	int size = atoi(p);
+	return size > 0 ? static_cast<uint16_t>(std::min(size, 0xffff)) : 3;
+}
+
+LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam) {
+	return core->run(hwnd, msg, wparam, lparam);
+}
+int WINAPI WinMain(HINSTANCE hinstance, HINSTANCE hprevinstance, PSTR mCmdLine, int iShowCmd) {
+
+	core = std::make_unique<Core>(1280, 720, parseCubeSize(mCmdLine));
+
+	WNDCLASSEX wndclass = { 0 };
+	wndclass.cbSize = sizeof(WNDCLASSEX);
+	wndclass.style = CS_HREDRAW | CS_VREDRAW;
+	wndclass.lpfnWndProc = WndProc;
+	wndclass.hInstance = hinstance;
+	wndclass.hCursor = LoadCursor(NULL, IDC_ARROW);
+	wndclass.lpszClassName = L"WndClass";
+	
+	if (!RegisterClassEx(&wndclass)) {
+		MessageBox(0, L"RegisterClass Failed.", 0, 0);
+		return false;
+	}
+
+	RECT windowRect = { 0, 0, static_cast<LONG>(core->getWndWidth()), static_cast<LONG>(core->getWndHeight()) };
+	AdjustWindowRect(&windowRect, WS_OVERLAPPEDWINDOW, FALSE);
+
+	// Create the window and store a handle to it.
+	core->hwnd = CreateWindow(wndclass.lpszClassName, L"Puzzle Cube DX", WS_OVERLAPPEDWINDOW, CW_USEDEFAULT, CW_USEDEFAULT, windowRect.right - windowRect.left, windowRect.bottom - windowRect.top, 0, 0, hinstance, 0);
+	if (!core->hwnd) {
+		MessageBox(0, L"CreateWindow Failed.", 0, 0);
+		return false;
+	}
+
+	core->initialize();
+
+	ShowWindow(core->hwnd, SW_SHOW);
+
+	MSG msg = {};
+	while (msg.message != WM_QUIT) {
+
+		if (PeekMessage(&msg, 0, 0, 0, PM_REMOVE)) {
+			TranslateMessage(&msg);
+			DispatchMessage(&msg);
+		}
+	}
+
+
+	core->destroy();
+
+	return 0;
 }
\ No newline at end of file
@@ -1,20 +1,25 @@
-#pragma once
-
-#ifndef WIN32_LEAN_AND_MEAN
-#define WIN32_LEAN_AND_MEAN 
-#endif
-
-#include <windows.h>
-#include <wrl.h>
-#include <d3d12.h>
-#include <dxgi1_4.h>
-#include <d3dcompiler.h>
-#include <DirectXColors.h>
-#include <DirectXCollision.h>
-
-#include <directx/d3dx12.h>
-
-#include <memory>
-#include <string>
-
-using Microsoft::WRL::ComPtr;
+#pragma once
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN 
+#endif
+
+// keeps windows.h from defining min and max macros, which break std::min and std::max
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <windows.h>
+#include <wrl.h>
+#include <d3d12.h>
+#include <dxgi1_4.h>
+#include <d3dcompiler.h>
+#include <DirectXColors.h>
+#include <DirectXCollision.h>
+
+#include <directx/d3dx12.h>
+
+#include <memory>
+#include <string>
+
+using Microsoft::WRL::ComPtr;
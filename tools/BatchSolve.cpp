@@ -0,0 +1,367 @@
+// headless batch solver. reads one scramble per line from a file or stdin, solves them on all cores and streams one
+// result per line to stdout in input order. no windows sdk needed, see the README for the build line
+#include "CubeModel.h"
+#include "Notation.h"
+#include "TwoPhaseSolver.h"
+#include "OptimalSolver.h"
+#include "Scrambler.h"
+#include "Scheduler.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+	enum class Format { CSV, JSONLines };
+	enum class SolverKind { TwoPhase, Optimal };
+
+	struct Options {
+		SolverKind solver = SolverKind::TwoPhase;
+		Format format = Format::CSV;
+		uint32_t threads = 0;														// 0 = all cores for two-phase, 1 for optimal
+		uint32_t queueSize = 0;														// 0 = 4 per thread
+		uint8_t maxLength = 20;
+		double timeout = 1.0;
+		std::string tables;
+		std::string input = "-";
+		uint32_t generate = 0;													// > 0 prints that many scrambles instead
+		uint64_t seed = 0;
+	};
+
+	struct Job {
+		uint64_t sequence;
+		uint64_t line;
+		std::string scramble;
+	};
+
+	struct Result {
+		bool ready = false;
+		std::string text;
+	};
+
+	struct Totals {
+		uint64_t solved = 0, failed = 0, invalid = 0, nodes = 0, moves = 0;
+	};
+
+	void printUsage() {
+		fprintf(stderr,
+			"usage: BatchSolve [options] [file]\n"
+			"  reads one scramble per line from file, or stdin when it is missing or -\n"
+			"  --solver twophase|optimal  solver to use (twophase)\n"
+			"  --format csv|jsonl         output format (csv)\n"
+			"  --threads n                scrambles solved at once (all cores, 1 for optimal which splits each search)\n"
+			"  --queue n                  scrambles in flight at most (4 per thread)\n"
+			"  --max-length n             longest solution to accept (20)\n"
+			"  --timeout s                two-phase time limit per scramble in seconds (1.0)\n"
+			"  --tables path              table cache file (TwoPhaseTables.bin or PatternDatabases.bin)\n"
+			"  --generate n               print n random state scrambles instead, one per line\n"
+			"  --seed s                   seed for --generate, the same seed gives the same scrambles (random)\n");
+	}
+
+	bool parseOptions(int argc, char** argv, Options& options) {
+		for (int i = 1; i < argc; i++) {
+			std::string arg = argv[i];
+			bool hasValue = i + 1 < argc;
+			if (arg == "--solver" && hasValue) {
+				std::string value = argv[++i];
+				if (value == "twophase")
+					options.solver = SolverKind::TwoPhase;
+				else if (value == "optimal")
+					options.solver = SolverKind::Optimal;
+				else
+					return false;
+			}
+			else if (arg == "--format" && hasValue) {
+				std::string value = argv[++i];
+				if (value == "csv")
+					options.format = Format::CSV;
+				else if (value == "jsonl")
+					options.format = Format::JSONLines;
+				else
+					return false;
+			}
+			else if (arg == "--threads" && hasValue)
+				options.threads = std::max(1, std::atoi(argv[++i]));
+			else if (arg == "--queue" && hasValue)
+				options.queueSize = std::max(1, std::atoi(argv[++i]));
+			else if (arg == "--max-length" && hasValue)
+				options.maxLength = static_cast<uint8_t>(std::min(std::max(std::atoi(argv[++i]), 0), 30));
+			else if (arg == "--timeout" && hasValue)
+				options.timeout = std::atof(argv[++i]);
+			else if (arg == "--tables" && hasValue)
+				options.tables = argv[++i];
+			else if (arg == "--generate" && hasValue)
+				options.generate = static_cast<uint32_t>(std::max(0, std::atoi(argv[++i])));
+			else if (arg == "--seed" && hasValue)
+				options.seed = std::strtoull(argv[++i], nullptr, 10);
+			else if (arg.size() > 1 && arg[0] == '-' && arg != "-")
+				return false;
+			else
+				options.input = arg;
+		}
+
+		if (options.threads == 0)
+			options.threads = options.solver == SolverKind::Optimal ? 1 : std::max(1u, std::thread::hardware_concurrency());
+		if (options.queueSize == 0)
+			options.queueSize = options.threads * 4;
+		if (options.tables.empty())
+			options.tables = options.solver == SolverKind::TwoPhase || options.generate ? "TwoPhaseTables.bin" : "PatternDatabases.bin";
+		return true;
+	}
+
+	// practice sets, or input for a solver run: BatchSolve --generate 1000 | BatchSolve
+	int generateScrambles(const Options& options) {
+		TwoPhaseSolver solver;
+		solver.init(options.tables);
+		Scrambler scrambler(solver);
+		ThreadPool threadPool(options.threads - 1);
+		uint64_t seed = options.seed ? options.seed : std::random_device{}();
+
+		auto startTime = std::chrono::steady_clock::now();
+		std::vector<std::vector<Move>> scrambles;
+		scrambler.generate(threadPool, seed, options.generate, scrambles);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+		size_t moves = 0;
+		for (auto& scramble : scrambles) {
+			printf("%s\n", toNotation(scramble).c_str());
+			moves += scramble.size();
+		}
+		fprintf(stderr, "%u scrambles with seed %llu in %.3fs (%.1f/s), avg %.2f moves\n", options.generate,
+			static_cast<unsigned long long>(seed), seconds, seconds > 0.0 ? options.generate / seconds : 0.0,
+			options.generate ? static_cast<double>(moves) / options.generate : 0.0);
+		Log::flush();
+		return 0;
+	}
+
+	std::string quoteCSV(const std::string& text) {
+		std::string quoted = "\"";
+		for (char c : text) {
+			if (c == '"')
+				quoted += '"';
+			quoted += c;
+		}
+		return quoted + "\"";
+	}
+
+	std::string quoteJSON(const std::string& text) {
+		std::string quoted = "\"";
+		for (char c : text) {
+			switch (c) {
+			case '"': quoted += "\\\""; break;
+			case '\\': quoted += "\\\\"; break;
+			case '\t': quoted += "\\t"; break;
+			case '\r': quoted += "\\r"; break;
+			case '\n': quoted += "\\n"; break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20) {
+					char escaped[8];
+					snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+					quoted += escaped;
+				}
+				else
+					quoted += c;
+			}
+		}
+		return quoted + "\"";
+	}
+
+	// scrambles in flight are bounded by the queue size: the reader waits until the oldest result is written before
+	// reading past it, and results are kept in a ring indexed by sequence until everything before them is out
+	class OrderedQueue {
+	public:
+		OrderedQueue(uint32_t capacity) : capacity(capacity), results(capacity) {}
+
+		void push(Job job) {
+			std::unique_lock<std::mutex> lock(mutex);
+			spaceAvailable.wait(lock, [this] { return nextSequence - nextWrite < capacity; });
+			job.sequence = nextSequence++;
+			jobs.push_back(std::move(job));
+			jobAvailable.notify_one();
+		}
+
+		void close() {
+			std::lock_guard<std::mutex> lock(mutex);
+			closed = true;
+			jobAvailable.notify_all();
+		}
+
+		bool pop(Job& job) {
+			std::unique_lock<std::mutex> lock(mutex);
+			jobAvailable.wait(lock, [this] { return closed || !jobs.empty(); });
+			if (jobs.empty())
+				return false;
+			job = std::move(jobs.front());
+			jobs.pop_front();
+			return true;
+		}
+
+		// store a result and write out every result that is next in line
+		void finish(uint64_t sequence, std::string text) {
+			std::lock_guard<std::mutex> lock(mutex);
+			auto& result = results[sequence % capacity];
+			result.text = std::move(text);
+			result.ready = true;
+
+			bool wrote = false;
+			for (auto* next = &results[nextWrite % capacity]; next->ready; next = &results[nextWrite % capacity]) {
+				fwrite(next->text.data(), 1, next->text.size(), stdout);
+				next->ready = false;
+				next->text.clear();
+				nextWrite++;
+				wrote = true;
+			}
+			if (wrote) {
+				fflush(stdout);
+				spaceAvailable.notify_one();
+			}
+		}
+
+	private:
+		const uint32_t capacity;
+		std::deque<Job> jobs;
+		std::vector<Result> results;
+		uint64_t nextSequence = 0, nextWrite = 0;
+		bool closed = false;
+		std::mutex mutex;
+		std::condition_variable jobAvailable, spaceAvailable;
+	};
+}
+
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage();
+		return 2;
+	}
+	if (options.generate)
+		return generateScrambles(options);
+
+	std::ifstream file;
+	std::istream* input = &std::cin;
+	if (options.input != "-") {
+		file.open(options.input);
+		if (!file) {
+			fprintf(stderr, "can not open %s\n", options.input.c_str());
+			return 1;
+		}
+		input = &file;
+	}
+
+	// both solvers are safe to call from several threads once their tables are loaded
+	TwoPhaseSolver twoPhase;
+	OptimalSolver optimal;
+	if (options.solver == SolverKind::TwoPhase)
+		twoPhase.init(options.tables);
+	else if (!optimal.init(options.tables)) {
+		Log::flush();
+		return 1;
+	}
+
+	if (options.format == Format::CSV)
+		printf("line,status,length,seconds,nodes,scramble,solution\n");
+
+	OrderedQueue queue(options.queueSize);
+	std::mutex totalsMutex;
+	Totals totals;
+
+	auto worker = [&] {
+		Job job;
+		while (queue.pop(job)) {
+			// the same compiler the gameplay input box uses, so scrambles mean the same as in the game
+			std::vector<Move> moves, solution;
+			std::string error, status = "ok";
+			SolveStats stats;
+			CubeModel cube;
+
+			if (!compileNotation(job.scramble, moves, &error))
+				status = "invalid";
+			else {
+				for (auto move : moves)
+					cube.apply(move);
+
+				bool found = options.solver == SolverKind::TwoPhase ?
+					twoPhase.solve(cube, solution, options.maxLength, options.timeout, &stats) :
+					optimal.solve(cube, solution, &stats, options.maxLength);
+				if (!found)
+					status = "unsolved";
+				else if (solution.size() > options.maxLength)
+					status = "timeout";
+			}
+
+			std::string notation = status == "invalid" ? error : toNotation(solution);
+			size_t length = status == "invalid" ? 0 : solution.size();
+			char numbers[128];
+			std::string text;
+			if (options.format == Format::CSV) {
+				snprintf(numbers, sizeof(numbers), "%llu,%s,%zu,%.6f,%llu,", static_cast<unsigned long long>(job.line),
+					status.c_str(), length, stats.seconds, static_cast<unsigned long long>(stats.nodes));
+				text = numbers + quoteCSV(job.scramble) + "," + quoteCSV(notation) + "\n";
+			}
+			else {
+				snprintf(numbers, sizeof(numbers), "{\"line\":%llu,\"status\":\"%s\",\"length\":%zu,\"seconds\":%.6f,\"nodes\":%llu,",
+					static_cast<unsigned long long>(job.line), status.c_str(), length, stats.seconds,
+					static_cast<unsigned long long>(stats.nodes));
+				text = numbers + std::string("\"scramble\":") + quoteJSON(job.scramble) +
+					(status == "invalid" ? ",\"error\":" : ",\"solution\":") + quoteJSON(notation) + "}\n";
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(totalsMutex);
+				totals.nodes += stats.nodes;
+				if (status == "invalid")
+					totals.invalid++;
+				else if (status == "unsolved")
+					totals.failed++;
+				else {
+					totals.solved++;
+					totals.moves += solution.size();
+				}
+			}
+			queue.finish(job.sequence, std::move(text));
+		}
+	};
+
+	auto startTime = std::chrono::steady_clock::now();
+	std::vector<std::thread> workers;
+	for (uint32_t i = 0; i < options.threads; i++)
+		workers.emplace_back(worker);
+
+	// blank lines and # comments are skipped, the line number in the output still points into the input
+	std::string line;
+	for (uint64_t lineNumber = 1; std::getline(*input, line); lineNumber++) {
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+		size_t first = line.find_first_not_of(" \t");
+		if (first == std::string::npos || line[first] == '#')
+			continue;
+		queue.push({ 0, lineNumber, line });
+	}
+	queue.close();
+	for (auto& thread : workers)
+		thread.join();
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	uint64_t total = totals.solved + totals.failed + totals.invalid;
+	fprintf(stderr, "%llu scrambles in %.3fs (%.1f/s): %llu solved, avg %.2f moves, %llu unsolved, %llu invalid, %.2fM nodes/s\n",
+		static_cast<unsigned long long>(total), seconds, seconds > 0.0 ? total / seconds : 0.0,
+		static_cast<unsigned long long>(totals.solved), totals.solved ? static_cast<double>(totals.moves) / totals.solved : 0.0,
+		static_cast<unsigned long long>(totals.failed), static_cast<unsigned long long>(totals.invalid),
+		seconds > 0.0 ? totals.nodes / seconds / 1e6 : 0.0);
+
+	Log::flush();
+	return totals.failed || totals.invalid ? 1 : 0;
+}
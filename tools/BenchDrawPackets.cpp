@@ -0,0 +1,96 @@
+// headless draw packet benchmark. builds the draw list LevelLoader makes for an NxN cube, a piece followed by its faces,
+// and times grouping it into instanced packets. no windows sdk needed, see the README for the build line
+#include "DrawPackets.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+	// mesh indices in the order LevelLoader first loads them
+	enum Mesh : uint32_t {
+		MeshPiece,
+		MeshFaceCorner,
+		MeshFaceCross,
+		MeshFaceCenter,
+		NumMeshes
+	};
+
+	struct Options {
+		std::vector<int> sizes;
+		int runs = 200;																// timed runs, the median is printed
+	};
+
+	void printUsage() {
+		fprintf(stderr,
+			"usage: BenchDrawPackets [options] [size...]\n"
+			"  groups the draws of each cube size into packets, sizes 3 50 100 when none are given\n"
+			"  --runs n                   timed runs, the median is printed (200)\n");
+	}
+
+	bool parseOptions(int argc, char** argv, Options& options) {
+		for (int i = 1; i < argc; i++) {
+			std::string arg = argv[i];
+			if (arg == "--runs" && i + 1 < argc)
+				options.runs = std::max(1, std::atoi(argv[++i]));
+			else if (arg.size() > 1 && arg[0] == '-')
+				return false;
+			else if (std::atoi(arg.c_str()) >= 2)
+				options.sizes.push_back(std::atoi(arg.c_str()));
+			else
+				return false;
+		}
+		if (options.sizes.empty())
+			options.sizes = { 3, 50, 100 };
+		return true;
+	}
+
+	// a piece on every surface position, each followed by one face per side it shows
+	std::vector<uint32_t> makeDraws(int n) {
+		std::vector<uint32_t> meshOfDraw;
+		for (int x = 0; x < n; x++) {
+			for (int y = 0; y < n; y++) {
+				for (int z = 0; z < n; z++) {
+					int sides = (x == 0 || x == n - 1) + (y == 0 || y == n - 1) + (z == 0 || z == n - 1);
+					if (sides == 0)
+						continue;
+
+					meshOfDraw.push_back(MeshPiece);
+					uint32_t face = sides == 3 ? MeshFaceCorner : sides == 2 ? MeshFaceCross : MeshFaceCenter;
+					meshOfDraw.insert(meshOfDraw.end(), sides, face);
+				}
+			}
+		}
+		return meshOfDraw;
+	}
+}
+
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage();
+		return 2;
+	}
+
+	for (int n : options.sizes) {
+		auto meshOfDraw = makeDraws(n);
+		auto numDraws = static_cast<uint32_t>(meshOfDraw.size());
+
+		DrawPacketBuilder builder;
+		std::vector<double> seconds;
+		for (int run = 0; run < options.runs; run++) {
+			auto start = std::chrono::steady_clock::now();
+			builder.build(meshOfDraw.data(), numDraws, NumMeshes);
+			seconds.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+		}
+		std::sort(seconds.begin(), seconds.end());
+
+		printf("%dx%d: %u draws -> %zu packets, %.1f us\n", n, n, numDraws, builder.getPackets().size(),
+			seconds[seconds.size() / 2] * 1e6);
+	}
+	return 0;
+}
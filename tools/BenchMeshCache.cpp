@@ -0,0 +1,127 @@
+// headless mesh cold start benchmark. times the two ways LevelLoader gets a mesh: parsing the .obj with tinyobj, and
+// hashing the .obj then mapping and checking the prebuilt .mesh. no windows sdk needed, see the README for the build line
+#include "MeshCache.h"
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "tiny_obj_loader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+	struct Options {
+		std::vector<std::string> files;
+		int runs = 50;																// timed runs, the median is printed
+	};
+
+	void printUsage() {
+		fprintf(stderr,
+			"usage: BenchMeshCache [options] [file.obj...]\n"
+			"  loads each .obj by parsing it and through a .mesh, the four cube meshes in PuzzleCubeDX/assets when none\n"
+			"  are given\n"
+			"  --runs n                   timed runs, the median is printed (50)\n");
+	}
+
+	bool parseOptions(int argc, char** argv, Options& options) {
+		for (int i = 1; i < argc; i++) {
+			std::string arg = argv[i];
+			if (arg == "--runs" && i + 1 < argc)
+				options.runs = std::max(1, std::atoi(argv[++i]));
+			else if (arg.size() > 1 && arg[0] == '-')
+				return false;
+			else
+				options.files.push_back(arg);
+		}
+		if (options.files.empty()) {
+			for (auto name : { "Piece", "Face_Corner", "Face_Cross", "Face_Center" })
+				options.files.push_back(std::string("PuzzleCubeDX/assets/") + name + ".obj");
+		}
+		return true;
+	}
+
+	template <typename Fn>
+	double medianSeconds(int runs, Fn&& fn) {
+		std::vector<double> seconds;
+		for (int run = 0; run < runs; run++) {
+			auto start = std::chrono::steady_clock::now();
+			if (!fn())
+				return -1.;
+			seconds.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+		}
+		std::sort(seconds.begin(), seconds.end());
+		return seconds[seconds.size() / 2];
+	}
+
+	// the parse path of LevelLoader::loadMesh, positions and flattened indices
+	bool parseObj(const std::string& path, std::vector<float>& positions, std::vector<uint32_t>& indices) {
+		tinyobj::ObjReaderConfig readerConfig;
+		readerConfig.triangulate = true;
+		tinyobj::ObjReader reader;
+		if (!reader.ParseFromFile(path, readerConfig))
+			return false;
+
+		positions = reader.GetAttrib().vertices;
+		indices.clear();
+		for (auto& shape : reader.GetShapes()) {
+			for (auto& index : shape.mesh.indices)
+				indices.push_back(index.vertex_index);
+		}
+		return true;
+	}
+}
+
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage();
+		return 2;
+	}
+
+	const std::string cachePath = "BenchMeshCache.mesh";
+	int failed = 0;
+	printf("%-36s %8s %8s %10s %10s\n", "file", "vertices", "indices", "parse us", "mapped us");
+	for (auto& path : options.files) {
+		std::vector<float> positions;
+		std::vector<uint32_t> indices;
+		uint64_t sourceHash = 0;
+		if (!hashFile(path, sourceHash) || !parseObj(path, positions, indices) || !writeMeshFile(cachePath, positions, indices, sourceHash)) {
+			fprintf(stderr, "could not load %s\n", path.c_str());
+			failed++;
+			continue;
+		}
+
+		double parsed = medianSeconds(options.runs, [&] { return parseObj(path, positions, indices); });
+
+		// hash the source, map and check the cache, then copy the streams out as loadMesh does into its buffers
+		std::vector<float> vertexCopy;
+		std::vector<uint32_t> indexCopy;
+		double mapped = medianSeconds(options.runs, [&] {
+			uint64_t hash = 0;
+			MeshFile cache;
+			if (!hashFile(path, hash) || !cache.open(cachePath) || cache.getHeader().sourceHash != hash)
+				return false;
+
+			auto& header = cache.getHeader();
+			vertexCopy.assign(cache.getPositions(), cache.getPositions() + header.vertexCount * 3);
+			if (header.indexSize == 2)
+				indexCopy.assign(cache.getIndices16(), cache.getIndices16() + header.indexCount);
+			else
+				indexCopy.assign(cache.getIndices32(), cache.getIndices32() + header.indexCount);
+			return true;
+		});
+		if (mapped < 0. || vertexCopy != positions || indexCopy != indices) {
+			fprintf(stderr, "%s: the .mesh does not match the .obj\n", path.c_str());
+			failed++;
+			continue;
+		}
+
+		printf("%-36s %8zu %8zu %10.1f %10.1f\n", path.c_str(), positions.size() / 3, indices.size(), parsed * 1e6, mapped * 1e6);
+	}
+	std::remove(cachePath.c_str());
+	return failed;
+}
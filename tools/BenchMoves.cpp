@@ -0,0 +1,167 @@
+// headless move kernel benchmark. applies the same random face moves with every instruction set the cpu runs, to
+// single states and to batches of BatchWidth, and prints states per second. no windows sdk needed, see the README
+#include "MoveKernels.h"
+#include "CubeModel.h"
+#include "CubieCube.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+	struct Options {
+		uint32_t count = 4000000;													// moves per kernel
+		uint32_t repeat = 3;														// passes per set, the fastest counts
+		uint64_t seed = 1;
+	};
+
+	void printUsage() {
+		fprintf(stderr,
+			"usage: BenchMoves [options]\n"
+			"  states per second of each move kernel with each instruction set the cpu runs\n"
+			"  --count n                  moves per kernel (4000000), batches apply n / %u\n"
+			"  --repeat n                 passes per instruction set, the fastest is printed (3)\n"
+			"  --seed s                   seed for the random moves (1)\n", BatchWidth);
+	}
+
+	bool parseOptions(int argc, char** argv, Options& options) {
+		for (int i = 1; i < argc; i++) {
+			std::string arg = argv[i];
+			bool hasValue = i + 1 < argc;
+			if (arg == "--count" && hasValue)
+				options.count = std::max<uint32_t>(BatchWidth, std::atoi(argv[++i]));
+			else if (arg == "--repeat" && hasValue)
+				options.repeat = std::max(1, std::atoi(argv[++i]));
+			else if (arg == "--seed" && hasValue)
+				options.seed = std::strtoull(argv[++i], nullptr, 10);
+			else
+				return false;
+		}
+		return true;
+	}
+
+	// states per second of fn, which applies count moves to states states each
+	template <typename Fn>
+	double statesPerSecond(uint64_t states, Fn&& fn) {
+		auto start = std::chrono::steady_clock::now();
+		fn();
+		return states / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// order dependent sum of a final state, equal across the sets when they compute the same thing
+	uint64_t checksum(const uint8_t* bytes, size_t size) {
+		uint64_t sum = 0;
+		for (size_t i = 0; i < size; i++)
+			sum = sum * 31 + bytes[i];
+		return sum;
+	}
+
+	struct Result {
+		double rates[4];
+		uint64_t sums[4];
+	};
+
+	Result run(const std::vector<Move>& moves) {
+		Result result;
+		uint32_t batches = static_cast<uint32_t>(moves.size() / BatchWidth);
+
+		CubeModel model;
+		result.rates[0] = statesPerSecond(moves.size(), [&] {
+			for (auto move : moves)
+				model.apply(move);
+		});
+		result.sums[0] = checksum(model.getFacelets().data(), NumFacelets);
+
+		CubieCube cube;
+		result.rates[1] = statesPerSecond(moves.size(), [&] {
+			for (auto move : moves)
+				cube.multiply(CubieCube::getMoveCube(move));
+		});
+		result.sums[1] = checksum(cube.cp, CornerCount) ^ checksum(cube.co, CornerCount) * 3 ^
+			checksum(cube.ep, EdgeCount) * 5 ^ checksum(cube.eo, EdgeCount) * 7;
+
+		// every lane starts from a different state so the lanes are not all the same bytes
+		FaceletBatch faceletBatch[2];
+		CubieBatch cubieBatch[2];
+		for (uint8_t k = 0; k < BatchWidth; k++) {
+			CubeModel laneModel;
+			CubieCube laneCube;
+			for (uint8_t m = 0; m < k; m++) {
+				laneModel.apply(moves[m]);
+				laneCube.multiply(CubieCube::getMoveCube(moves[m]));
+			}
+			faceletBatch[0].set(k, laneModel.getFacelets());
+			cubieBatch[0].set(k, laneCube);
+		}
+
+		result.rates[2] = statesPerSecond(uint64_t(batches) * BatchWidth, [&] {
+			for (uint32_t i = 0; i < batches; i++)
+				applyMove(faceletBatch[i & 1], faceletBatch[~i & 1], *getMoveInfo(moves[i]).permutation);
+		});
+		result.sums[2] = checksum(&faceletBatch[batches & 1].facelets[0][0], sizeof(FaceletBatch::facelets));
+
+		result.rates[3] = statesPerSecond(uint64_t(batches) * BatchWidth, [&] {
+			for (uint32_t i = 0; i < batches; i++)
+				applyMove(cubieBatch[i & 1], cubieBatch[~i & 1], CubieCube::getMoveCube(moves[i]));
+		});
+		auto& lastCubies = cubieBatch[batches & 1];
+		result.sums[3] = checksum(&lastCubies.cp[0][0], sizeof(lastCubies.cp)) ^ checksum(&lastCubies.co[0][0], sizeof(lastCubies.co)) * 3 ^
+			checksum(&lastCubies.ep[0][0], sizeof(lastCubies.ep)) * 5 ^ checksum(&lastCubies.eo[0][0], sizeof(lastCubies.eo)) * 7;
+		return result;
+	}
+}
+
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage();
+		return 2;
+	}
+
+	// the 18 face moves, the ones every kernel takes
+	std::mt19937_64 random(options.seed);
+	std::vector<Move> moves(options.count);
+	for (auto& move : moves)
+		move = static_cast<Move>(random() % 18);
+
+	const char* kernels[4] = { "facelet single", "cubie single", "facelet batch", "cubie batch" };
+	std::vector<InstructionSet> sets;
+	std::vector<Result> results;
+	for (auto set : { InstructionSet::Scalar, InstructionSet::SSSE3, InstructionSet::AVX2 }) {
+		if (setInstructionSet(set) != set)
+			continue;
+
+		// one untimed pass so the tables and pages are warm for every set alike
+		if (results.empty())
+			run(std::vector<Move>(moves.begin(), moves.begin() + std::min<size_t>(moves.size(), 1 << 16)));
+		sets.push_back(set);
+		results.push_back(run(moves));
+		for (uint32_t pass = 1; pass < options.repeat; pass++) {
+			auto again = run(moves);
+			for (int k = 0; k < 4; k++)
+				results.back().rates[k] = std::max(results.back().rates[k], again.rates[k]);
+		}
+	}
+	setInstructionSet(getSupportedInstructionSet());
+
+	printf("%-16s", "M states/s");
+	for (auto set : sets)
+		printf("%10s", getInstructionSetName(set));
+	printf("\n");
+	bool match = true;
+	for (int k = 0; k < 4; k++) {
+		printf("%-16s", kernels[k]);
+		for (size_t s = 0; s < sets.size(); s++) {
+			printf("%10.0f", results[s].rates[k] / 1e6);
+			match = match && results[s].sums[k] == results[0].sums[k];
+		}
+		printf("\n");
+	}
+	printf("results %s across the sets\n", match ? "match" : "DIFFER");
+	return match ? 0 : 1;
+}
@@ -0,0 +1,369 @@
+// headless registry benchmarks. times the entity/component storage the systems run on with plain components, so the
+// numbers come from the same Registry code the game uses. no windows sdk needed, see the README for the build line
+#include "Registry.h"
+#include "ArchetypeRegistry.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+	struct Options {
+		std::string mode;
+		UINT count = 100000;														// entities
+		UINT runs = 20;																// timed runs, the median is printed
+		bool countGiven = false;
+		UINT density = 8;
+		UINT spread = 64;															// parents within this many entities, 0 = anywhere
+		uint64_t seed = 1;
+	};
+
+	void printUsage() {
+		fprintf(stderr,
+			"usage: BenchRegistry [options] pools|lookups|propagate\n"
+			"  pools                      walk and look up a component owned by 1 in --density entities, in the sparse set\n"
+			"                             pools and in the old pools indexed by entity, at 256, 10k and 1M entities\n"
+			"  lookups                    getComponent for --count entities through a shared_ptr copy of the pool as it used\n"
+			"                             to be, through Registry::getComponent and through a View\n"
+			"  propagate                  world matrices for a forest of transforms, parents before children, through the\n"
+			"                             Registry pools, the old pools indexed by entity, the ArchetypeRegistry chunks\n"
+			"                             and a flat node array like the HierarchySystem's\n"
+			"  --count n                  entities, pools runs only this size when given (100000)\n"
+			"  --density n                pools gives the component to 1 in n entities (8)\n"
+			"  --runs n                   timed runs, the median is printed (20)\n"
+			"  --spread n                 parents are at most n entities before their children, 0 for anywhere (64)\n"
+			"  --seed s                   seed for the random hierarchy (1)\n");
+	}
+
+	bool parseOptions(int argc, char** argv, Options& options) {
+		for (int i = 1; i < argc; i++) {
+			std::string arg = argv[i];
+			bool hasValue = i + 1 < argc;
+			if (arg == "--count" && hasValue) {
+				options.count = std::max(1, std::atoi(argv[++i]));
+				options.countGiven = true;
+			}
+			else if (arg == "--density" && hasValue)
+				options.density = std::max(1, std::atoi(argv[++i]));
+			else if (arg == "--runs" && hasValue)
+				options.runs = std::max(1, std::atoi(argv[++i]));
+			else if (arg == "--spread" && hasValue)
+				options.spread = std::atoi(argv[++i]);
+			else if (arg == "--seed" && hasValue)
+				options.seed = std::strtoull(argv[++i], nullptr, 10);
+			else if (arg.size() > 1 && arg[0] == '-')
+				return false;
+			else
+				options.mode = arg;
+		}
+		return !options.mode.empty();
+	}
+
+	// median seconds of runs calls to fn
+	template <typename Fn>
+	double timeRuns(UINT runs, Fn&& fn) {
+		std::vector<double> seconds;
+		for (UINT i = 0; i < runs; i++) {
+			auto start = std::chrono::steady_clock::now();
+			fn();
+			seconds.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+		}
+		std::sort(seconds.begin(), seconds.end());
+		return seconds[seconds.size() / 2];
+	}
+
+	void printResult(const char* name, UINT count, double seconds) {
+		printf("%-28s %9u  %10.3f ms  %8.2f ns/entity\n", name, count, seconds * 1e3, seconds * 1e9 / count);
+	}
+
+	// stand-ins for CTransform and CHierarchy without DirectXMath, the same size class as the real ones
+	struct BTransform {
+		float local[16];
+		float world[16];
+	};
+
+	struct BParent {
+		UINT parent = NullEntity;
+	};
+
+	void multiply(const float* a, const float* b, float* out) {
+		for (int r = 0; r < 4; r++) {
+			for (int c = 0; c < 4; c++)
+				out[r * 4 + c] = a[r * 4] * b[c] + a[r * 4 + 1] * b[4 + c] + a[r * 4 + 2] * b[8 + c] + a[r * 4 + 3] * b[12 + c];
+		}
+	}
+
+	BTransform randomTransform(std::mt19937_64& random) {
+		std::uniform_real_distribution<float> value(-1.f, 1.f);
+		BTransform transform;
+		for (int i = 0; i < 16; i++) {
+			transform.local[i] = i % 5 == 0 ? 1.f : value(random) * 0.01f;
+			transform.world[i] = 0.f;
+		}
+		return transform;
+	}
+
+	// the pool before sparse sets: a component slot for every possible entity, indexed by the entity, with the
+	// registry's signatures telling which slots are in use. kept here only to compare against
+	template <typename T>
+	struct EntityIndexedPool {
+		std::vector<T> compData;
+		std::vector<Signature> signatures;
+	};
+
+	void benchPools(const Options& options, UINT count) {
+		UINT owners = (count + options.density - 1) / options.density;
+		std::mt19937_64 random(options.seed);
+
+		// sparse set, only the owners have a slot
+		Registry registry;
+		std::vector<UINT> entities;
+		for (UINT i = 0; i < count; i++) {
+			UINT e = registry.createEntity();
+			if (i % options.density == 0)
+				registry.addComponent<BTransform>(e, randomTransform(random));
+			entities.push_back(e);
+		}
+		auto& pool = registry.getPool<BTransform>();
+
+		// entity indexed, every entity has a slot
+		EntityIndexedPool<BTransform> indexed;
+		indexed.compData.resize(count);
+		indexed.signatures.resize(count);
+		UINT typeID = Component<BTransform>::getID();
+		for (UINT i = 0; i < count; i += options.density) {
+			indexed.compData[i] = pool.get(entities[i]);
+			indexed.signatures[i].set(typeID);
+		}
+
+		// the owners in random order for the lookups
+		std::vector<UINT> lookups;
+		for (UINT i = 0; i < count; i += options.density)
+			lookups.push_back(i);
+		std::shuffle(lookups.begin(), lookups.end(), random);
+
+		UINT runs = std::max<UINT>(options.runs, 2000000 / count);
+		float sum = 0.f;
+		double sparseWalk = timeRuns(runs, [&] {
+			for (UINT i = 0; i < pool.size(); i++)
+				sum += pool.compData[i].local[1];
+		});
+		double indexedWalk = timeRuns(runs, [&] {
+			for (UINT i = 0; i < count; i++) {
+				if (indexed.signatures[i].test(typeID))
+					sum += indexed.compData[i].local[1];
+			}
+		});
+		double sparseLookup = timeRuns(runs, [&] {
+			for (auto i : lookups)
+				sum += pool.get(entities[i]).local[1];
+		});
+		double indexedLookup = timeRuns(runs, [&] {
+			for (auto i : lookups)
+				sum += indexed.compData[i].local[1];
+		});
+
+		size_t sparseBytes = pool.sparse.size() * sizeof(UINT) + pool.size() * (2 * sizeof(UINT) + sizeof(BTransform));
+		size_t indexedBytes = size_t(count) * sizeof(BTransform);
+		printf("%u entities, %u owners, %zu KB sparse set, %zu KB entity indexed (checksum %g)\n", count, owners,
+			sparseBytes / 1024, indexedBytes / 1024, sum);
+		printResult("  walk sparse set", owners, sparseWalk);
+		printResult("  walk entity indexed", owners, indexedWalk);
+		printResult("  lookup sparse set", owners, sparseLookup);
+		printResult("  lookup entity indexed", owners, indexedLookup);
+	}
+
+	void benchLookups(const Options& options) {
+		std::mt19937_64 random(options.seed);
+		Registry registry;
+		std::vector<UINT> entities;
+		for (UINT i = 0; i < options.count; i++) {
+			UINT e = registry.createEntity();
+			registry.addComponent<BTransform>(e, randomTransform(random));
+			entities.push_back(e);
+		}
+
+		// the lookup getComponent used to do: copy the shared_ptr to the pool and cast it, one atomic increment and
+		// decrement per call. it points at the same pool so only the lookup itself differs
+		UINT typeID = Component<BTransform>::getID();
+		std::vector<std::shared_ptr<IPool>> sharedPools(typeID + 1);
+		sharedPools[typeID] = std::shared_ptr<IPool>(&registry.getPool<BTransform>(), [](IPool*) {});
+		auto view = registry.getView<BTransform>();
+
+		float sum = 0.f;
+		double shared = timeRuns(options.runs, [&] {
+			for (auto e : entities) {
+				std::shared_ptr<Pool<BTransform>> pool = std::static_pointer_cast<Pool<BTransform>>(sharedPools[typeID]);
+				sum += pool->get(e).local[1];
+			}
+		});
+		double registryGet = timeRuns(options.runs, [&] {
+			for (auto e : entities)
+				sum += registry.getComponent<BTransform>(e).local[1];
+		});
+		double viewGet = timeRuns(options.runs, [&] {
+			for (auto e : entities)
+				sum += view.get<BTransform>(e).local[1];
+		});
+
+		printf("%u lookups (checksum %g)\n", options.count, sum);
+		printResult("  shared_ptr copy", options.count, shared);
+		printResult("  Registry::getComponent", options.count, registryGet);
+		printResult("  View::get", options.count, viewGet);
+	}
+
+	// a forest like the cube's: every parent index is lower than its child's, so a pass in creation order sees parents
+	// first. about one root per 8 entities, the rest hang off a random entity up to spread before them
+	std::vector<UINT> makeForest(const Options& options) {
+		std::mt19937_64 random(options.seed);
+		std::vector<UINT> parents(options.count, NullEntity);
+		for (UINT i = 1; i < options.count; i++) {
+			if (random() % 8 != 0)
+				parents[i] = static_cast<UINT>(i - 1 - random() % (options.spread ? std::min(i, options.spread) : i));
+		}
+		return parents;
+	}
+
+
+	int benchPropagate(const Options& options) {
+		auto parents = makeForest(options);
+
+		// registry, walking the packed transform pool and looking the parent up through the sparse index
+		Registry registry;
+		{
+			std::mt19937_64 random(options.seed);
+			std::vector<UINT> entities;
+			for (UINT i = 0; i < options.count; i++) {
+				UINT e = registry.createEntity();
+				registry.addComponent<BTransform>(e, randomTransform(random));
+				registry.addComponent<BParent>(e, BParent{ parents[i] == NullEntity ? NullEntity : entities[parents[i]] });
+				entities.push_back(e);
+			}
+		}
+		auto view = registry.getView<BTransform, BParent>();
+		auto& transforms = view.pool<BTransform>();
+		auto& links = view.pool<BParent>();
+		float sparseSum = 0.f;
+		double sparseSeconds = timeRuns(options.runs, [&] {
+			for (UINT i = 0; i < transforms.size(); i++) {
+				auto& transform = transforms.compData[i];
+				UINT parent = links.get(transforms.entities[i]).parent;
+				if (parent == NullEntity)
+					std::copy(transform.local, transform.local + 16, transform.world);
+				else
+					multiply(transform.local, transforms.get(parent).world, transform.world);
+			}
+		});
+		for (UINT i = 0; i < transforms.size(); i++)
+			sparseSum += transforms.compData[i].world[0];
+
+		// entity indexed pools, the parent's transform is at its entity index
+		EntityIndexedPool<BTransform> indexed;
+		{
+			std::mt19937_64 random(options.seed);
+			for (UINT i = 0; i < options.count; i++)
+				indexed.compData.push_back(randomTransform(random));
+		}
+		float indexedSum = 0.f;
+		double indexedSeconds = timeRuns(options.runs, [&] {
+			for (UINT i = 0; i < options.count; i++) {
+				auto& transform = indexed.compData[i];
+				if (parents[i] == NullEntity)
+					std::copy(transform.local, transform.local + 16, transform.world);
+				else
+					multiply(transform.local, indexed.compData[parents[i]].world, transform.world);
+			}
+		});
+		for (auto& transform : indexed.compData)
+			indexedSum += transform.world[0];
+
+		// archetype chunks, every entity ends up in the one transform + parent archetype in creation order. the parent
+		// is looked up through its entity record
+		ArchetypeRegistry archetypes;
+		{
+			std::mt19937_64 random(options.seed);
+			std::vector<UINT> entities;
+			for (UINT i = 0; i < options.count; i++) {
+				UINT e = archetypes.createEntity();
+				archetypes.addComponent<BTransform>(e, randomTransform(random));
+				archetypes.addComponent<BParent>(e, BParent{ parents[i] == NullEntity ? NullEntity : entities[parents[i]] });
+				entities.push_back(e);
+			}
+		}
+		float archetypeSum = 0.f;
+		double archetypeSeconds = timeRuns(options.runs, [&] {
+			archetypes.forEach<BTransform, BParent>([&](UINT, BTransform& transform, BParent& link) {
+				if (link.parent == NullEntity)
+					std::copy(transform.local, transform.local + 16, transform.world);
+				else
+					multiply(transform.local, archetypes.getComponent<BTransform>(link.parent).world, transform.world);
+			});
+		});
+		archetypes.forEach<BTransform>([&](UINT, BTransform& transform) { archetypeSum += transform.world[0]; });
+
+		// flat array of nodes holding their parent's node index, the layout the HierarchySystem keeps. the floor for any
+		// component storage
+		struct Node {
+			UINT parent;
+			BTransform transform;
+		};
+		std::vector<Node> nodes;
+		{
+			std::mt19937_64 random(options.seed);
+			for (UINT i = 0; i < options.count; i++)
+				nodes.push_back({ parents[i], randomTransform(random) });
+		}
+		float flatSum = 0.f;
+		double flatSeconds = timeRuns(options.runs, [&] {
+			for (auto& node : nodes) {
+				if (node.parent == NullEntity)
+					std::copy(node.transform.local, node.transform.local + 16, node.transform.world);
+				else
+					multiply(node.transform.local, nodes[node.parent].transform.world, node.transform.world);
+			}
+		});
+		for (auto& node : nodes)
+			flatSum += node.transform.world[0];
+
+		printResult("propagate registry", options.count, sparseSeconds);
+		printResult("propagate entity indexed", options.count, indexedSeconds);
+		printResult("propagate archetype", options.count, archetypeSeconds);
+		printResult("propagate flat array", options.count, flatSeconds);
+		printf("checksums %g %g %g %g\n", sparseSum, indexedSum, archetypeSum, flatSum);	// equal when all computed the same matrices
+		return 0;
+	}
+}
+
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage();
+		return 2;
+	}
+
+	if (options.mode == "pools") {
+		if (options.countGiven)
+			benchPools(options, options.count);
+		else {
+			for (UINT count : { 256u, 10000u, 1000000u })
+				benchPools(options, count);
+		}
+		return 0;
+	}
+	if (options.mode == "lookups") {
+		benchLookups(options);
+		return 0;
+	}
+	if (options.mode == "propagate")
+		return benchPropagate(options);
+
+	printUsage();
+	return 2;
+}
@@ -0,0 +1,148 @@
+// headless benchmark of the symmetry reduced state keys and the transposition table. times canonicalization of random
+// states with and without color renaming, packing and hashing, and table stores and finds from several threads. no
+// windows sdk needed, see the README for the build line
+#include "Symmetry.h"
+#include "TranspositionTable.h"
+#include "CubeModel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+	struct Options {
+		uint32_t count = 200000;													// random states
+		uint32_t threads = 4;														// threads sharing the table
+		uint64_t seed = 1;
+	};
+
+	void printUsage() {
+		fprintf(stderr,
+			"usage: BenchSymmetry [options]\n"
+			"  --count n                  random states (200000)\n"
+			"  --threads n                threads storing and finding in one table (4)\n"
+			"  --seed s                   seed for the random states (1)\n");
+	}
+
+	bool parseOptions(int argc, char** argv, Options& options) {
+		for (int i = 1; i < argc; i++) {
+			std::string arg = argv[i];
+			bool hasValue = i + 1 < argc;
+			if (arg == "--count" && hasValue)
+				options.count = std::max(1, std::atoi(argv[++i]));
+			else if (arg == "--threads" && hasValue)
+				options.threads = std::max(1, std::atoi(argv[++i]));
+			else if (arg == "--seed" && hasValue)
+				options.seed = std::strtoull(argv[++i], nullptr, 10);
+			else
+				return false;
+		}
+		return true;
+	}
+
+	template <typename Fn>
+	double timeSeconds(Fn&& fn) {
+		auto start = std::chrono::steady_clock::now();
+		fn();
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void printRate(const char* name, uint64_t count, double seconds) {
+		printf("%-32s %8.3f us  %6.2f M/s\n", name, seconds * 1e6 / count, count / seconds / 1e6);
+	}
+}
+
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage();
+		return 2;
+	}
+
+	// 25 random face moves each, far enough from solved that the keys are spread out
+	std::mt19937_64 random(options.seed);
+	std::vector<Facelets> states(options.count);
+	for (auto& state : states) {
+		CubeModel cube;
+		for (int m = 0; m < 25; m++)
+			cube.apply(static_cast<Move>(random() % 18));
+		state = cube.getFacelets();
+	}
+
+	std::vector<StateKey> keys(options.count);
+	double canonical = timeSeconds([&] {
+		for (uint32_t i = 0; i < options.count; i++)
+			keys[i] = getCanonicalKey(states[i]);
+	});
+	double recolored = timeSeconds([&] {
+		for (uint32_t i = 0; i < options.count; i++)
+			keys[i] = getCanonicalKey(states[i], true);
+	});
+	uint64_t mix = 0;
+	double packed = timeSeconds([&] {
+		for (uint32_t i = 0; i < options.count; i++)
+			mix ^= packState(states[i]).getHash();
+	});
+
+	// every symmetric copy of a state has to give the same key
+	uint32_t checked = std::min<uint32_t>(options.count, 2000), mismatches = 0;
+	for (uint32_t i = 0; i < checked; i++) {
+		auto key = getCanonicalKey(states[i]);
+		bool same = true;
+		for (uint8_t s = 0; s < NumSymmetries; s++) {
+			Facelets copy;
+			applySymmetry(states[i], s, copy);
+			same = same && getCanonicalKey(copy) == key;
+		}
+		mismatches += !same;
+	}
+
+	// each thread stores its share of the keys with their index as value, then finds all of them
+	std::vector<uint64_t> hashes(options.count);
+	for (uint32_t i = 0; i < options.count; i++)
+		hashes[i] = packState(states[i]).getHash();
+	TranspositionTable table(size_t(options.count) * 4);
+	std::atomic<uint32_t> wrong{ 0 }, found{ 0 };
+	auto runThreads = [&](auto&& fn) {
+		std::vector<std::thread> threads;
+		for (uint32_t t = 0; t < options.threads; t++)
+			threads.emplace_back(fn, t);
+		for (auto& thread : threads)
+			thread.join();
+	};
+	double stores = timeSeconds([&] {
+		runThreads([&](uint32_t t) {
+			for (uint32_t i = t; i < options.count; i += options.threads)
+				table.store(hashes[i], i);
+		});
+	});
+	double finds = timeSeconds([&] {
+		runThreads([&](uint32_t t) {
+			for (uint32_t i = t; i < options.count; i += options.threads) {
+				uint64_t value;
+				if (table.find(hashes[i], value)) {
+					found++;
+					if (hashes[value] != hashes[i])
+						wrong++;
+				}
+			}
+		});
+	});
+
+	printf("%u states (hash mix %016llx)\n", options.count, static_cast<unsigned long long>(mix));
+	printRate("canonical key", options.count, canonical);
+	printRate("canonical key, color renaming", options.count, recolored);
+	printRate("pack + hash", options.count, packed);
+	printRate("table store", options.count, stores);
+	printRate("table find", options.count, finds);
+	printf("%u of %u states key the same under all %u symmetries\n", checked - mismatches, checked, NumSymmetries);
+	printf("table: %u of %u found, %u wrong values from %u threads\n", found.load(), options.count, wrong.load(), options.threads);
+	return mismatches || wrong ? 1 : 0;
+}
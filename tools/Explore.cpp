@@ -0,0 +1,131 @@
+// headless state space explorer. runs a breadth first search over every state of the 2x2 cube or of a pair of solver
+// coordinates on all cores, prints how many states are at each depth and can write the exact distances to a file.
+// no windows sdk needed, see the README for the build line
+#include "StateSpace.h"
+#include "Scheduler.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+
+namespace {
+	struct Options {
+		std::string space;
+		uint32_t threads = 0;														// 0 = all cores
+		std::string distances;														// distance file to write
+		std::string frontier;														// frontier file prefix, empty = memory only
+		uint64_t frontierMemory = 1ull << 24;
+		uint64_t verify = 0;														// > 0 checks the move tables, with walks that long
+		uint64_t seed = 0;
+	};
+
+	void printUsage() {
+		std::string names;
+		for (auto& name : getStateSpaceNames())
+			names += (names.empty() ? "" : "|") + name;
+		fprintf(stderr,
+			"usage: Explore [options] %s\n"
+			"  prints depth,states for every depth of the space to stdout\n"
+			"  --threads n                threads searching (all cores)\n"
+			"  --distances path           write the distance of every state, 4 bits each, to path\n"
+			"  --frontier path            spill frontiers past --frontier-memory to path.0 and path.1\n"
+			"  --frontier-memory n        states per frontier kept in memory with --frontier (16777216)\n"
+			"  --verify n                 check every move against its inverse on every state and n random moves\n"
+			"                             against the facelet model first\n"
+			"  --seed s                   seed for --verify (random)\n", names.c_str());
+	}
+
+	bool parseOptions(int argc, char** argv, Options& options) {
+		for (int i = 1; i < argc; i++) {
+			std::string arg = argv[i];
+			bool hasValue = i + 1 < argc;
+			if (arg == "--threads" && hasValue)
+				options.threads = std::max(1, std::atoi(argv[++i]));
+			else if (arg == "--distances" && hasValue)
+				options.distances = argv[++i];
+			else if (arg == "--frontier" && hasValue)
+				options.frontier = argv[++i];
+			else if (arg == "--frontier-memory" && hasValue)
+				options.frontierMemory = std::max(1ull, std::strtoull(argv[++i], nullptr, 10));
+			else if (arg == "--verify" && hasValue)
+				options.verify = std::strtoull(argv[++i], nullptr, 10);
+			else if (arg == "--seed" && hasValue)
+				options.seed = std::strtoull(argv[++i], nullptr, 10);
+			else if (arg.size() > 1 && arg[0] == '-')
+				return false;
+			else
+				options.space = arg;
+		}
+
+		if (options.threads == 0)
+			options.threads = std::max(1u, std::thread::hardware_concurrency());
+		return !options.space.empty();
+	}
+}
+
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage();
+		return 2;
+	}
+
+	auto space = createStateSpace(options.space);
+	if (!space) {
+		fprintf(stderr, "unknown space %s\n", options.space.c_str());
+		printUsage();
+		return 2;
+	}
+	ThreadPool threadPool(options.threads - 1);
+
+	if (options.verify) {
+		uint64_t seed = options.seed ? options.seed : std::random_device{}();
+		auto startTime = std::chrono::steady_clock::now();
+		uint64_t mismatches = verifyStateSpace(threadPool, *space, options.verify, seed);
+		fprintf(stderr, "verify %s: %llu mismatches in %.2fs (seed %llu)\n", space->getName(), static_cast<unsigned long long>(mismatches),
+			std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count(), static_cast<unsigned long long>(seed));
+		if (mismatches) {
+			Log::flush();
+			return 1;
+		}
+	}
+
+	ExploreOptions exploreOptions;
+	exploreOptions.keepDistances = !options.distances.empty();
+	exploreOptions.frontierPath = options.frontier;
+	exploreOptions.frontierMemory = options.frontierMemory;
+
+	StateSpaceExplorer explorer(*space, threadPool);
+	if (!explorer.run(exploreOptions)) {
+		Log::flush();
+		return 1;
+	}
+
+	printf("depth,states\n");
+	auto& depthCounts = explorer.getDepthCounts();
+	for (size_t depth = 0; depth < depthCounts.size(); depth++)
+		printf("%zu,%llu\n", depth, static_cast<unsigned long long>(depthCounts[depth]));
+
+	uint64_t size = space->getSize(), reached = explorer.getReached();
+	double seconds = explorer.getSeconds();
+	fprintf(stderr, "%s: %llu of %llu states reached, deepest %zu, %.2fs (%.1fM states/s, %u threads)\n", space->getName(),
+		static_cast<unsigned long long>(reached), static_cast<unsigned long long>(size), depthCounts.size() - 1, seconds,
+		seconds > 0.0 ? reached / seconds / 1e6 : 0.0, options.threads);
+
+	if (!options.distances.empty()) {
+		if (!explorer.writeDistances(options.distances)) {
+			fprintf(stderr, "could not write %s\n", options.distances.c_str());
+			Log::flush();
+			return 1;
+		}
+		fprintf(stderr, "distances written to %s\n", options.distances.c_str());
+	}
+	Log::flush();
+	return 0;
+}
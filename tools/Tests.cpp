@@ -0,0 +1,943 @@
+// headless checks for the engine pieces that build without the windows sdk. each test prints ok or what went wrong,
+// the exit code is the number of failed tests. see the README for the build line
+#include "Scheduler.h"
+#include "Registry.h"
+#include "CommandBuffer.h"
+#include "DrawPackets.h"
+#include "Notation.h"
+#include "MoveKernels.h"
+#include "Coordinates.h"
+#include "TwoPhaseSolver.h"
+#include "OptimalSolver.h"
+#include "Scrambler.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+	struct Failure {
+		std::string message;
+	};
+
+	// throws out of the running test with the failed expression and its line
+#define CHECK(condition) \
+	do { if (!(condition)) throw Failure{ std::string(#condition) + " (line " + std::to_string(__LINE__) + ")" }; } while (0)
+
+	struct ReadA {};
+	struct ReadB {};
+
+	// stages follow the conflicts: writers of a type wait for earlier readers and writers of it
+	void testSchedulerStages(UINT workers) {
+		Scheduler scheduler(workers);
+		Registry registry;
+		auto a = registry.getSignature<ReadA>();
+		auto b = registry.getSignature<ReadB>();
+
+		std::mutex mutex;
+		std::vector<std::string> order;
+		auto record = [&](const char* name) {
+			return [&, name](float) {
+				std::lock_guard<std::mutex> lock(mutex);
+				order.push_back(name);
+			};
+		};
+		scheduler.addSystem("writeA", Signature(), a, record("writeA"));
+		scheduler.addSystem("readA", a, Signature(), record("readA"));
+		scheduler.addSystem("writeB", Signature(), b, record("writeB"));
+		scheduler.addSystem("readB writeA", b, a, record("readB writeA"));
+
+		auto& stages = scheduler.getStages();
+		CHECK(stages.size() == 3);
+		CHECK((stages[0] == std::vector<UINT>{ 0, 2 }));
+		CHECK((stages[1] == std::vector<UINT>{ 1 }));
+		CHECK((stages[2] == std::vector<UINT>{ 3 }));
+
+		for (int frame = 0; frame < 100; frame++) {
+			order.clear();
+			scheduler.onUpdate(0.f);
+			CHECK(order.size() == 4);
+			auto at = [&](const char* name) { return std::find(order.begin(), order.end(), name) - order.begin(); };
+			CHECK(at("writeA") < at("readA"));
+			CHECK(at("readA") < at("readB writeA"));
+			CHECK(at("writeB") < at("readB writeA"));
+		}
+	}
+
+	// systems of one stage really run at the same time: each waits for the other to arrive
+	void testSchedulerConcurrent(UINT workers) {
+		if (workers == 0)
+			return;																// needs a second thread to meet
+
+		Scheduler scheduler(workers);
+		std::atomic<int> arrived{ 0 };
+		std::atomic<bool> timedOut{ false };
+		auto meet = [&](float) {
+			arrived++;
+			auto start = std::chrono::steady_clock::now();
+			while (arrived.load() < 2) {
+				if (std::chrono::steady_clock::now() - start > std::chrono::seconds(5)) {
+					timedOut = true;
+					return;
+				}
+				std::this_thread::yield();
+			}
+		};
+		scheduler.addSystem("first", Signature(), Signature(), meet);
+		scheduler.addSystem("second", Signature(), Signature(), meet);
+		scheduler.onUpdate(0.f);
+		CHECK(!timedOut);
+	}
+
+	// every index exactly once for any grain, also from a system running on a worker
+	void testParallelFor(UINT workers) {
+		Scheduler scheduler(workers);
+		auto& pool = scheduler.getThreadPool();
+		CHECK(pool.getWorkerCount() == workers);
+		CHECK(ThreadPool::getThreadIndex() == 0);
+
+		for (UINT count : { 0u, 1u, 7u, 1000u, 4099u }) {
+			for (UINT grain : { 0u, 1u, 3u, 64u, 5000u }) {
+				std::vector<std::atomic<int>> visits(count);
+				std::atomic<bool> badThread{ false };
+				pool.parallelFor(count, grain, [&](UINT begin, UINT end) {
+					if (ThreadPool::getThreadIndex() > workers)
+						badThread = true;
+					for (UINT i = begin; i < end; i++)
+						visits[i]++;
+				});
+				CHECK(!badThread);
+				CHECK(std::all_of(visits.begin(), visits.end(), [](const std::atomic<int>& v) { return v.load() == 1; }));
+			}
+		}
+
+		// nested: systems fan out over entities while the stage itself runs on the pool
+		std::vector<UINT> entities(10000);
+		for (UINT i = 0; i < entities.size(); i++)
+			entities[i] = i;
+		std::vector<std::atomic<int>> visits(entities.size());
+		auto visit = [&](float) { scheduler.forEachChunked(entities, 97, [&](UINT e) { visits[e]++; }); };
+		scheduler.addSystem("first", Signature(), Signature(), visit);
+		scheduler.addSystem("second", Signature(), Signature(), visit);
+		scheduler.onUpdate(0.f);
+		CHECK(std::all_of(visits.begin(), visits.end(), [](const std::atomic<int>& v) { return v.load() == 2; }));
+	}
+
+	struct Value {
+		UINT value = 0;
+	};
+
+	// every thread records into a buffer nobody else writes: workers of the pool, the calling thread, a thread of its own
+	// and the workers of a second pool, whose thread indices overlap the first pool's
+	void testCommandBuffersThreads(UINT workers) {
+		Scheduler scheduler(workers);
+		ThreadPool otherPool(2);
+		CommandBuffers commandBuffers(scheduler.getThreadPool());
+		Registry registry;
+
+		const UINT perSource = 5000;
+		auto record = [&](UINT first, UINT count) {
+			auto& commands = commandBuffers.local();
+			for (UINT i = first; i < first + count; i++) {
+				UINT e = commands.createEntity();
+				commands.addComponent<Value>(e, Value{ i });
+			}
+		};
+		scheduler.getThreadPool().parallelFor(perSource, 7, [&](UINT begin, UINT end) { record(begin, end - begin); });
+		otherPool.parallelFor(perSource, 7, [&](UINT begin, UINT end) { record(perSource + begin, end - begin); });
+		std::thread thread([&] { record(2 * perSource, perSource); });
+		thread.join();
+		record(3 * perSource, perSource);
+
+		commandBuffers.playback(registry);
+		auto& pool = registry.getPool<Value>();
+		CHECK(pool.size() == 4 * perSource);
+		std::vector<int> seen(4 * perSource);
+		for (UINT i = 0; i < pool.size(); i++) {
+			CHECK(pool.compData[i].value < seen.size());
+			seen[pool.compData[i].value]++;
+		}
+		CHECK(std::all_of(seen.begin(), seen.end(), [](int n) { return n == 1; }));
+
+		// played back buffers start empty again
+		commandBuffers.playback(registry);
+		CHECK(pool.size() == 4 * perSource);
+	}
+
+	// pending handles resolve per buffer, destroys run after the adds and removes
+	void testCommandBuffersPlayback(UINT workers) {
+		Scheduler scheduler(workers);
+		CommandBuffers commandBuffers(scheduler.getThreadPool());
+		Registry registry;
+
+		UINT live = registry.createEntity();
+		registry.addComponent<Value>(live, Value{ 1 });
+		registry.addComponent<ReadA>(live);
+
+		auto& commands = commandBuffers.local();
+		UINT pending = commands.createEntity();
+		commands.addComponent<Value>(pending, Value{ 2 });
+		commands.addComponent<ReadB>(pending);
+		commands.removeComponent<ReadA>(live);
+		commands.addComponent<Value>(live, Value{ 3 });
+		UINT doomed = commands.createEntity();
+		commands.addComponent<Value>(doomed, Value{ 4 });
+		commands.destroyEntity(doomed);
+		CHECK(isPendingEntity(pending));
+		CHECK(registry.getPool<Value>().size() == 1);
+
+		commandBuffers.playback(registry);
+		auto& pool = registry.getPool<Value>();
+		CHECK(pool.size() == 2);
+		CHECK(registry.getComponent<Value>(live).value == 3);
+		CHECK(!registry.hasComponent<ReadA>(live));
+		for (UINT i = 0; i < pool.size(); i++) {
+			if (pool.entities[i] != live) {
+				CHECK(pool.compData[i].value == 2);
+				CHECK(registry.hasComponent<ReadB>(pool.entities[i]));
+			}
+		}
+	}
+
+	// a thread outside the pool keeps its own buffer in every instance, also in one made where a destroyed one was
+	void testCommandBuffersInstances(UINT workers) {
+		Scheduler scheduler(workers);
+		Registry registry;
+		CommandBuffers first(scheduler.getThreadPool()), second(scheduler.getThreadPool());
+		for (UINT i = 0; i < 100; i++) {
+			CommandBuffers& commandBuffers = i % 2 ? second : first;
+			commandBuffers.local().addComponent<Value>(commandBuffers.local().createEntity(), Value{ i });
+		}
+		first.playback(registry);
+		CHECK(registry.getPool<Value>().size() == 50);
+		second.playback(registry);
+		CHECK(registry.getPool<Value>().size() == 100);
+
+		for (int round = 0; round < 10; round++) {
+			auto commandBuffers = std::make_unique<CommandBuffers>(scheduler.getThreadPool());
+			CHECK(commandBuffers->local().createEntity() == makeEntity(0, PendingGeneration));
+		}
+	}
+
+	// a handle kept past destroyEntity does not reach the entity that gets its recycled slot
+	void testRegistryStaleHandles(UINT) {
+		Registry registry;
+		UINT old = registry.createEntity();
+		registry.addComponent<Value>(old, Value{ 1 });
+		registry.addComponent<ReadA>(old);
+		registry.destroyEntity(old);
+
+		UINT recycled = registry.createEntity();
+		CHECK(entityIndex(recycled) == entityIndex(old));
+		CHECK(recycled != old);
+		registry.addComponent<Value>(recycled, Value{ 2 });
+		registry.addComponent<ReadA>(recycled);
+
+		CHECK(!registry.isAlive(old));
+		CHECK(registry.isAlive(recycled));
+		CHECK(!registry.hasComponent<Value>(old));
+		CHECK(!registry.getPool<Value>().has(old));
+		CHECK(registry.getPool<Value>().has(recycled));
+
+		// removing through the old handle or destroying it again leaves the new owner alone
+		registry.removeComponent<ReadA>(old);
+		registry.destroyEntity(old);
+		CHECK(registry.isAlive(recycled));
+		CHECK(registry.hasComponent<ReadA>(recycled));
+		CHECK(registry.getComponent<Value>(recycled).value == 2);
+		CHECK(registry.getPool<Value>().size() == 1);
+
+		// the pool's remove checks the handle too
+		registry.getPool<Value>().remove(old, registry.getTick());
+		CHECK(registry.getPool<Value>().size() == 1);
+	}
+
+	// getChanged reads the change log, it has to give what a scan of every component's tick gives
+	void testRegistryChanged(UINT) {
+		Registry registry;
+		auto& pool = registry.getPool<Value>();
+		std::mt19937 random(11);
+		std::vector<UINT> alive;
+		std::vector<UINT> checkpoints{ registry.getTick() };
+		for (int step = 0; step < 20000; step++) {
+			UINT op = random() % 10;
+			if (op < 3 || alive.empty()) {
+				UINT e = registry.createEntity();
+				registry.addComponent<Value>(e, Value{ static_cast<UINT>(step) });
+				alive.push_back(e);
+			}
+			else if (op < 5) {
+				UINT at = random() % alive.size();
+				registry.destroyEntity(alive[at]);
+				alive[at] = alive.back();
+				alive.pop_back();
+			}
+			else if (op < 9)
+				registry.markChanged<Value>(alive[random() % alive.size()]);
+			else
+				checkpoints.push_back(registry.advanceTick());
+
+			if (step % 97 == 0) {
+				UINT since = checkpoints[random() % checkpoints.size()];
+				std::vector<UINT> changed, expected;
+				registry.getChanged<Value>(since, changed);
+				for (UINT i = 0; i < pool.size(); i++) {
+					if (pool.changeTicks[i] > since)
+						expected.push_back(pool.entities[i]);
+				}
+				std::sort(changed.begin(), changed.end());
+				std::sort(expected.begin(), expected.end());
+				CHECK(changed == expected);
+			}
+		}
+	}
+
+	// one packet per used mesh in mesh order, every drawn draw in its mesh's packet on a slot of its own, draw order kept
+	// inside a packet, draws with an unknown mesh left out
+	void checkPackets(const std::vector<uint32_t>& meshOfDraw, uint32_t numMeshes) {
+		DrawPacketBuilder builder;
+		builder.build(meshOfDraw.data(), static_cast<uint32_t>(meshOfDraw.size()), numMeshes);
+		auto& packets = builder.getPackets();
+
+		std::vector<uint32_t> perMesh(numMeshes, 0);
+		for (auto mesh : meshOfDraw) {
+			if (mesh < numMeshes)
+				perMesh[mesh]++;
+		}
+		uint32_t next = 0, used = 0;
+		for (auto& packet : packets) {
+			CHECK(packet.mesh < numMeshes);
+			CHECK(packet.firstInstance == next);
+			CHECK(packet.instanceCount == perMesh[packet.mesh]);
+			CHECK(packet.instanceCount > 0);
+			CHECK(used == 0 || packet.mesh > packets[used - 1].mesh);
+			next += packet.instanceCount;
+			used++;
+		}
+		CHECK(used == std::count_if(perMesh.begin(), perMesh.end(), [](uint32_t n) { return n > 0; }));
+		CHECK(builder.getNumInstances() == next);
+
+		std::vector<uint8_t> taken(next, 0);
+		std::vector<uint32_t> lastSlot(numMeshes, 0);
+		std::vector<uint8_t> any(numMeshes, 0);
+		for (uint32_t i = 0; i < meshOfDraw.size(); i++) {
+			uint32_t slot = builder.getInstance(i);
+			uint32_t mesh = meshOfDraw[i];
+			if (mesh >= numMeshes) {
+				CHECK(slot == InvalidInstance);
+				continue;
+			}
+			CHECK(slot < next);
+			CHECK(!taken[slot]);
+			taken[slot] = 1;
+
+			auto packet = std::find_if(packets.begin(), packets.end(), [&](const DrawPacket& p) { return p.mesh == mesh; });
+			CHECK(packet != packets.end());
+			CHECK(slot >= packet->firstInstance && slot < packet->firstInstance + packet->instanceCount);
+			CHECK(!any[mesh] || slot > lastSlot[mesh]);
+			any[mesh] = 1;
+			lastSlot[mesh] = slot;
+		}
+		CHECK(builder.getInstance(static_cast<uint32_t>(meshOfDraw.size())) == InvalidInstance);
+	}
+
+	void testDrawPackets(UINT) {
+		checkPackets({}, 4);
+		checkPackets({ 0, 0, 0 }, 1);
+		checkPackets({ 3, 1, 3, 1, 0 }, 4);
+		checkPackets({ 2, 7, 0, 2, 9 }, 4);												// 7 and 9 are not meshes
+
+		std::mt19937 random(5);
+		for (int round = 0; round < 50; round++) {
+			uint32_t numMeshes = 1 + random() % 12;
+			std::vector<uint32_t> meshOfDraw(random() % 5000);
+			for (auto& mesh : meshOfDraw)
+				mesh = random() % (numMeshes + 1);											// one past the end now and then
+			checkPackets(meshOfDraw, numMeshes);
+		}
+
+		// building again reuses the builder without leftovers
+		DrawPacketBuilder builder;
+		std::vector<uint32_t> big(1000, 1), small{ 0 };
+		builder.build(big.data(), 1000, 2);
+		builder.build(small.data(), 1, 2);
+		CHECK(builder.getPackets().size() == 1);
+		CHECK(builder.getNumInstances() == 1);
+		CHECK(builder.getInstance(1) == InvalidInstance);
+	}
+
+	CubeModel applied(const std::vector<Move>& moves) {
+		CubeModel cube;
+		for (auto move : moves)
+			cube.apply(move);
+		return cube;
+	}
+
+	CubeModel scrambled(std::mt19937& random, int length) {
+		CubeModel cube;
+		for (int i = 0; i < length; i++)
+			cube.apply(static_cast<Move>(random() % MoveCount));
+		return cube;
+	}
+
+	// four quarter turns of any move are the identity, and each move has the inverse and double turn it claims
+	void testCubeMoves(UINT) {
+		std::mt19937 random(7);
+		for (int round = 0; round < 20; round++) {
+			CubeModel start = round == 0 ? CubeModel() : scrambled(random, 30);
+			for (int m = 0; m < MoveCount; m++) {
+				auto move = static_cast<Move>(m);
+				CubeModel cube = start;
+				for (int i = 0; i < 4; i++) {
+					cube.apply(move);
+					CHECK((cube == start) == (i == 3 || (m % 3 == 2 && i == 1)));		// doubles are back after two
+				}
+
+				cube.apply(move);
+				cube.apply(getInverseMove(move));
+				CHECK(cube == start);
+
+				CubeModel twice = start, doubled = start, thrice = start, inverse = start;
+				twice.apply(move);
+				twice.apply(move);
+				doubled.apply(static_cast<Move>(m - m % 3 + 2));
+				CHECK(m % 3 == 2 || twice == doubled);
+				for (int i = 0; i < 3; i++)
+					thrice.apply(move);
+				inverse.apply(getInverseMove(move));
+				CHECK(thrice == inverse);
+			}
+		}
+
+		// whole cube rotations keep a solved cube solved, any other move does not
+		for (int m = 0; m < MoveCount; m++) {
+			CubeModel cube;
+			cube.apply(static_cast<Move>(m));
+			CHECK(cube.isSolved() == (m >= MoveX));
+		}
+	}
+
+	// the move table against what each move is known to do: the sticker that lands on a spot after one clockwise turn of
+	// a solved cube. the right face is at -x and the left at +x
+	void testCubeMoveTable(UINT) {
+		struct Expected {
+			Move move;
+			int position[3];
+			int normal[3];
+			uint8_t face;
+		};
+		const Expected expected[] = {
+			{ MoveR, { -1, 1, 0 }, { 0, 1, 0 }, FaceFront },							// R brings the front up
+			{ MoveL, { 1, 0, 1 }, { 0, 0, 1 }, FaceTop },								// L brings the top to the front
+			{ MoveU, { 0, 1, 1 }, { 0, 0, 1 }, FaceRight },								// U brings the right to the front
+			{ MoveF, { 0, 1, 1 }, { 0, 1, 0 }, FaceLeft },								// F brings the left up
+			{ MoveD, { 0, -1, 1 }, { 0, 0, 1 }, FaceLeft },								// D brings the left to the front
+			{ MoveB, { 0, 1, -1 }, { 0, 1, 0 }, FaceRight },							// B brings the right up
+			{ MoveM, { 0, 0, 1 }, { 0, 0, 1 }, FaceTop },								// M follows L
+			{ MoveE, { 0, 0, 1 }, { 0, 0, 1 }, FaceLeft },								// E follows D
+			{ MoveS, { 0, 1, 0 }, { 0, 1, 0 }, FaceLeft },								// S follows F
+			{ MoveRw, { 0, 1, 0 }, { 0, 1, 0 }, FaceFront },							// r takes the middle along
+			{ MoveLw, { 0, 0, 1 }, { 0, 0, 1 }, FaceTop },
+			{ MoveUw, { 0, 0, 1 }, { 0, 0, 1 }, FaceRight },
+			{ MoveFw, { 0, 1, 0 }, { 0, 1, 0 }, FaceLeft },
+			{ MoveDw, { 0, 0, 1 }, { 0, 0, 1 }, FaceLeft },
+			{ MoveBw, { 0, 1, 0 }, { 0, 1, 0 }, FaceRight },
+			{ MoveX, { 0, 1, 0 }, { 0, 1, 0 }, FaceFront },								// x follows R
+			{ MoveY, { 0, 0, 1 }, { 0, 0, 1 }, FaceRight },								// y follows U
+			{ MoveZ, { 0, 1, 0 }, { 0, 1, 0 }, FaceLeft },								// z follows F
+		};
+		for (auto& e : expected) {
+			CubeModel cube;
+			cube.apply(e.move);
+			CHECK(cube.getFacelet(CubeModel::faceletAt(e.position, e.normal)) == e.face);
+		}
+
+		// a move and its turn are the same permutation, and the cubie move cubes agree with the facelet ones
+		std::mt19937 random(12);
+		for (int round = 0; round < 50; round++) {
+			CubeModel start;
+			for (int i = 0; i < 25; i++)
+				start.apply(static_cast<Move>(random() % (MoveB2 + 1)));
+			CubieCube cubie;
+			CHECK(cubie.fromFacelets(start));
+
+			for (int m = 0; m < MoveCount; m++) {
+				auto move = static_cast<Move>(m);
+				CubeModel byMove = start, byTurn = start;
+				byMove.apply(move);
+				byTurn.apply(getMoveInfo(move).turn);
+				CHECK(byMove == byTurn);
+				if (m > MoveB2)
+					continue;
+
+				CubieCube moved = cubie;
+				moved.multiply(CubieCube::getMoveCube(move));
+				CubeModel byCubie;
+				moved.toFacelets(byCubie);
+				CHECK(byCubie == byMove);
+			}
+		}
+
+		// every instruction set the cpu has applies the table the same way, one state at a time and batched
+		InstructionSet previous = getInstructionSet();
+		std::vector<CubeModel> starts;
+		FaceletBatch batch;
+		for (uint8_t k = 0; k < BatchWidth; k++) {
+			starts.push_back(scrambled(random, 25));
+			batch.set(k, starts.back().getFacelets());
+		}
+		for (int set = 0; set <= static_cast<int>(getSupportedInstructionSet()); set++) {
+			setInstructionSet(static_cast<InstructionSet>(set));
+			for (int m = 0; m < MoveCount; m++) {
+				auto move = static_cast<Move>(m);
+				FaceletBatch out;
+				applyMove(batch, out, *getMoveInfo(move).permutation);
+				for (uint8_t k = 0; k < BatchWidth; k++) {
+					CubeModel cube = starts[k];
+					cube.apply(move);
+					Facelets facelets;
+					out.get(k, facelets);
+					CHECK(facelets == cube.getFacelets());
+				}
+			}
+		}
+		setInstructionSet(previous);
+	}
+
+	uint32_t countOf(uint8_t n, uint8_t k) {
+		uint32_t count = 1;
+		for (uint8_t i = 0; i < k; i++)
+			count = count * (n - i) / (i + 1);
+		return count;
+	}
+
+	// unranking every rank gives a distinct arrangement that ranks back to it, so the ranks are a perfect hash
+	void testCoordinatesRanks(UINT) {
+		for (uint8_t n = 1; n <= 9; n++) {
+			uint32_t count = countPartialPermutations(n, n);
+			std::vector<uint8_t> seen(count, 0);
+			uint8_t perm[12];
+			for (uint32_t rank = 0; rank < count; rank++) {
+				unrankPermutation(rank, perm, n);
+				CHECK(rankPermutation(perm, n) == rank);
+				int inversions = 0;
+				for (uint8_t i = 0; i < n; i++) {
+					CHECK(perm[i] < n);
+					for (uint8_t j = i + 1; j < n; j++)
+						inversions += perm[i] > perm[j];
+				}
+				CHECK(isOddPermutation(perm, n) == (inversions % 2 == 1));
+				std::sort(perm, perm + n);
+				for (uint8_t i = 0; i < n; i++)
+					CHECK(perm[i] == i);
+			}
+		}
+
+		// 12 pieces have too many permutations to walk, shuffles stand in for them
+		std::mt19937 random(19);
+		uint8_t perm[12];
+		for (int round = 0; round < 100000; round++) {
+			for (uint8_t i = 0; i < 12; i++)
+				perm[i] = i;
+			std::shuffle(perm, perm + 12, random);
+			uint32_t rank = rankPermutation(perm, 12);
+			CHECK(rank < 479001600);
+			uint8_t back[12];
+			unrankPermutation(rank, back, 12);
+			CHECK(std::equal(perm, perm + 12, back));
+		}
+
+		for (uint8_t k : { 1, 4, 6 }) {
+			uint32_t count = countPartialPermutations(EdgeCount, k);
+			uint8_t values[12];
+			for (uint32_t rank = 0; rank < count; rank++) {
+				unrankPartialPermutation(rank, values, k, EdgeCount);
+				CHECK(rankPartialPermutation(values, k, EdgeCount) == rank);
+				for (uint8_t i = 0; i < k; i++) {
+					CHECK(values[i] < EdgeCount);
+					CHECK(std::find(values, values + i, values[i]) == values + i);
+				}
+			}
+		}
+
+		// every mask of 12 slots, grouped by the number of set bits
+		for (uint32_t mask = 0; mask < (1u << EdgeCount); mask++) {
+			uint8_t k = 0;
+			for (uint32_t m = mask; m; m &= m - 1)
+				k++;
+			uint32_t rank = rankCombination(static_cast<uint16_t>(mask), k);
+			CHECK(rank < countOf(EdgeCount, k));
+			CHECK(unrankCombination(rank, k) == mask);
+		}
+
+		for (auto [n, base] : { std::pair<uint8_t, uint8_t>{ CornerCount, 3 }, { EdgeCount, 2 } }) {
+			uint32_t count = 1;
+			for (uint8_t i = 0; i + 1 < n; i++)
+				count *= base;
+			uint8_t orientation[12];
+			for (uint32_t rank = 0; rank < count; rank++) {
+				unrankOrientation(rank, orientation, n, base);
+				CHECK(rankOrientation(orientation, n, base) == rank);
+				int sum = 0;
+				for (uint8_t i = 0; i < n; i++)
+					sum += orientation[i];
+				CHECK(sum % base == 0);
+			}
+		}
+	}
+
+	template <typename Coord>
+	void checkCoordinate() {
+		CubieCube cube;
+		for (uint32_t coord = 0; coord < Coord::Size; coord++) {
+			Coord::set(cube, coord);
+			CHECK(Coord::get(cube) == coord);
+		}
+	}
+
+	// the solver coordinates read back what they set over their whole range, and are 0 or solved on a solved cube
+	void testCoordinatesCubie(UINT) {
+		checkCoordinate<TwistCoord>();
+		checkCoordinate<FlipCoord>();
+		checkCoordinate<SliceCoord>();
+		checkCoordinate<CornerPermCoord>();
+		checkCoordinate<UDEdgePermCoord>();
+		checkCoordinate<SlicePermCoord>();
+		checkCoordinate<EdgePositionCoord<0>>();
+		checkCoordinate<EdgePositionCoord<6>>();
+
+		CubieCube solved;
+		CHECK(solved.getTwist() == 0 && solved.getFlip() == 0 && solved.getSlice() == SolvedSlice);
+		CHECK(solved.getCornerPerm() == 0 && solved.getUDEdgePerm() == 0 && solved.getSlicePerm() == 0);
+	}
+
+	// every layer turn of every size is back where it started after four quarter turns, and a 3x3 turns like CubeModel
+	void testCubeLayers(UINT) {
+		std::mt19937 random(22);
+		for (uint16_t size = 2; size <= 7; size++) {
+			CubeModelNxN start(size);
+			for (int i = 0; i < 50; i++) {
+				auto first = static_cast<uint16_t>(1 + random() % size);
+				start.apply(LayerMove(static_cast<Move>(random() % MoveCount), first, first));
+			}
+
+			for (uint8_t axis = 0; axis < 3; axis++) {
+				for (uint16_t layer = 0; layer < size; layer++) {
+					for (uint8_t quarterTurns = 1; quarterTurns < 4; quarterTurns++) {
+						CubeModelNxN cube = start;
+						for (int i = 0; i < 4; i++) {
+							cube.apply(LayerTurn{ axis, layer, layer, quarterTurns });
+							CHECK((cube.getFacelets() == start.getFacelets()) == (i == 3 || (quarterTurns == 2 && i == 1)));
+						}
+					}
+				}
+			}
+
+			// layer ranges too, wide moves, slices and rotations
+			for (int m = 0; m < MoveCount; m++) {
+				auto first = static_cast<uint16_t>(1 + random() % size);
+				auto last = static_cast<uint16_t>(first + random() % (size - first + 1));
+				LayerMove move(static_cast<Move>(m), first, last);
+				CubeModelNxN cube = start;
+				for (int i = 0; i < 4; i++)
+					cube.apply(move);
+				CHECK(cube.getFacelets() == start.getFacelets());
+			}
+		}
+
+		CubeModelNxN big(3);
+		CubeModel cube;
+		for (int i = 0; i < 200; i++) {
+			auto move = static_cast<Move>(random() % MoveCount);
+			big.apply(LayerMove(move));
+			cube.apply(move);
+			CubeModel copy;
+			CHECK(big.toCubeModel(copy));
+			CHECK(copy == cube);
+		}
+	}
+
+	// big cube scrambles have 10 moves per layer, never turn the layer just turned, and undo with their inverse
+	void testCubeLayerScramble(UINT) {
+		Random random(22);
+		for (uint16_t size : { 2, 4, 5, 7, 10 }) {
+			CubeModelNxN cube(size);
+			for (int round = 0; round < 10; round++) {
+				std::vector<LayerMove> scramble;
+				Scrambler::generate(random, cube, scramble);
+				CHECK(scramble.size() == 10u * size);
+				for (size_t i = 1; i < scramble.size(); i++) {
+					LayerTurn previous = cube.getTurn(scramble[i - 1]), turn = cube.getTurn(scramble[i]);
+					CHECK(turn.first == turn.last);
+					CHECK(turn.axis != previous.axis || turn.first != previous.first);
+				}
+
+				for (auto& move : scramble)
+					cube.apply(move);
+				CHECK(!cube.isSolved());
+				invertMoves(scramble);
+				for (auto& move : scramble)
+					cube.apply(move);
+				CHECK(cube.isSolved());
+			}
+		}
+	}
+
+	// the solver tables are cached in the working directory under the names the game uses, only the first run builds them
+	const TwoPhaseSolver& getTwoPhaseSolver() {
+		static TwoPhaseSolver solver;
+		if (!solver.isReady())
+			solver.init("TwoPhaseTables.bin");
+		return solver;
+	}
+
+	// seeded random state scrambles, each solved within the length limit
+	void testSolverTwoPhase(UINT) {
+		auto& solver = getTwoPhaseSolver();
+		CHECK(solver.isReady());
+		Scrambler scrambler(solver);
+		Random random(14);
+		for (int round = 0; round < 20; round++) {
+			std::vector<Move> scramble, solution;
+			scrambler.generate(random, scramble);
+			CHECK(!scramble.empty() && scramble.size() <= scrambler.maxLength);
+
+			CubeModel cube = applied(scramble);
+			CHECK(solver.solve(cube, solution, 21, 10.0));
+			CHECK(solution.size() <= 21);
+			for (auto move : solution)
+				cube.apply(move);
+			CHECK(cube.isSolved());
+		}
+
+		// solved needs no moves, a twisted corner has no solution
+		std::vector<Move> solution{ MoveR };
+		CHECK(solver.solve(CubeModel(), solution));
+		CHECK(solution.empty());
+		const int corner[3] = { -1, 1, 1 };
+		const int normals[3][3] = { { 0, 1, 0 }, { -1, 0, 0 }, { 0, 0, 1 } };
+		Facelets facelets = CubeModel().getFacelets();
+		uint8_t stickers[3];
+		for (int i = 0; i < 3; i++)
+			stickers[i] = CubeModel::faceletAt(corner, normals[i]);
+		std::swap(facelets[stickers[0]], facelets[stickers[1]]);
+		std::swap(facelets[stickers[1]], facelets[stickers[2]]);
+		CubeModel twisted;
+		twisted.setFacelets(facelets);
+		CHECK(!solver.solve(twisted, solution));
+	}
+
+	// short scrambles keep the optimal search to milliseconds, deep ones take minutes. the solution can never be longer
+	// than the scramble
+	void testSolverOptimal(UINT) {
+		static OptimalSolver solver;
+		CHECK(solver.isReady() || solver.init("PatternDatabases.bin"));
+
+		std::mt19937 random(15);
+		for (int round = 0; round < 20; round++) {
+			std::vector<Move> scramble;
+			while (scramble.size() < 7) {
+				auto move = static_cast<Move>(random() % (MoveB2 + 1));
+				if (scramble.empty() || move / 3 != scramble.back() / 3)
+					scramble.push_back(move);
+			}
+
+			CubeModel cube = applied(scramble);
+			std::vector<Move> solution;
+			CHECK(solver.solve(cube, solution, nullptr, static_cast<uint8_t>(scramble.size())));
+			CHECK(solution.size() <= scramble.size());
+			for (auto move : solution)
+				cube.apply(move);
+			CHECK(cube.isSolved());
+		}
+
+		// R U F takes exactly three moves
+		std::vector<Move> solution;
+		CubeModel cube = applied({ MoveR, MoveU, MoveF });
+		CHECK(!solver.solve(cube, solution, nullptr, 2));
+		CHECK(solver.solve(cube, solution, nullptr, 3));
+		CHECK((solution == std::vector<Move>{ MoveFi, MoveUi, MoveRi }));
+	}
+
+	std::vector<Move> compile(const std::string& text) {
+		std::vector<Move> moves;
+		std::string error;
+		if (!compileNotation(text, moves, &error))
+			throw Failure{ "\"" + text + "\" " + error };
+		return moves;
+	}
+
+	// every form the parser takes: suffixes, wide moves, slices, rotations, groups, commutators and conjugates
+	void testNotationParse(UINT) {
+		CHECK(toNotation(compile("R U2 D' B")) == "R U2 Di B");
+		CHECK(compile("R'") == compile("Ri"));
+		CHECK(compile("R'") == compile("R3"));
+		CHECK(compile("R2'") == compile("R2"));
+		CHECK(compile("R4'").empty());
+		CHECK(toNotation(compile("r Rw l' Dw2")) == "r r li d2");
+		CHECK(toNotation(compile("M E' S2")) == "M Ei S2");
+		CHECK(compile("x y' z2") == compile("X Y' Z2"));
+		CHECK(toNotation(compile("x y' z2")) == "X Yi Z2");
+		CHECK(toNotation(compile("(R U)3")) == "R U R U R U");
+		CHECK(toNotation(compile("(R U)'")) == "Ui Ri");
+		CHECK(toNotation(compile("(R (U F)2)2'")) == "Fi Ui Fi Ui Ri Fi Ui Fi Ui Ri");
+		CHECK(toNotation(compile("[R, U]")) == "R U Ri Ui");
+		CHECK(toNotation(compile("[R: U]")) == "R U Ri");
+		CHECK(toNotation(compile("[R: [U, F]]")) == "R U F Ui Fi Ri");
+		CHECK(compile("").empty());
+		CHECK(compile("  R\tU  ") == compile("R U"));
+
+		// bigger cubes take layer numbers
+		std::vector<LayerMove> layerMoves;
+		CHECK(compileNotation("3R 3Rw 2-3Rw r 4r' M x", 5, layerMoves));
+		CHECK(toNotation(layerMoves) == "3R 3Rw 2-3Rw Rw 4Rwi M X");
+		CHECK(layerMoves[2].first == 2 && layerMoves[2].last == 3);
+	}
+
+	// text that is not notation fails with an error and leaves the output alone
+	void testNotationErrors(UINT) {
+		for (auto text : { "Q", "R U)", "(R U", "[R U]", "[R, U", "3R", "'", "Rw2w", "(R)100000000" }) {
+			std::vector<Move> moves{ MoveF };
+			std::string error;
+			CHECK(!compileNotation(text, moves, &error));
+			CHECK(!error.empty());
+			CHECK((moves == std::vector<Move>{ MoveF }));
+		}
+
+		std::vector<LayerMove> layerMoves;
+		CHECK(!compileNotation("6R", 5, layerMoves));
+		CHECK(!compileNotation("2-1Rw", 5, layerMoves));
+		CHECK(layerMoves.empty());
+	}
+
+	// printed moves compile back to the same moves, on the 3x3 and on bigger cubes
+	void testNotationRoundTrip(UINT) {
+		std::vector<Move> all;
+		for (int m = 0; m < MoveCount; m++)
+			all.push_back(static_cast<Move>(m));
+		CHECK(compile(toNotation(all)) == all);
+
+		std::mt19937 random(13);
+		for (uint16_t size : { 2, 4, 7 }) {
+			std::vector<LayerMove> moves;
+			for (int i = 0; i < 200; i++) {
+				auto base = static_cast<Move>(random() % MoveCount);
+				auto first = static_cast<uint16_t>(1 + random() % size);
+				auto last = static_cast<uint16_t>(first + random() % (size - first + 1));
+				moves.push_back(LayerMove(base, first, last));
+			}
+			std::vector<LayerMove> compiled;
+			std::string error;
+			CHECK(compileNotation(toNotation(moves), size, compiled, &error));
+			CHECK(toNotation(compiled) == toNotation(moves));
+		}
+	}
+
+	// simplified sequences are never longer and leave the cube in the same state
+	void testNotationSimplify(UINT) {
+		auto simplified = [](const std::string& text) {
+			auto moves = compile(text);
+			simplifyMoves(moves);
+			CHECK(applied(moves) == applied(compile(text)));
+			return toNotation(moves);
+		};
+		CHECK(simplified("R R'") == "");
+		CHECK(simplified("R R") == "R2");
+		CHECK(simplified("R M' L'") == "X");
+		CHECK(simplified("Rw r x y z") == "Li ri Y Z");
+		CHECK(simplified("R U U' R'") == "");
+		CHECK(simplified("R L R") == "R2 L");
+		CHECK(simplified("[R, U]") == "R U Ri Ui");
+
+		std::mt19937 random(11);
+		for (int round = 0; round < 500; round++) {
+			std::vector<Move> moves(random() % 40);
+			for (auto& move : moves)
+				move = static_cast<Move>(random() % MoveCount);
+			auto merged = moves;
+			simplifyMoves(merged);
+			CHECK(merged.size() <= moves.size());
+			CHECK(applied(merged) == applied(moves));
+		}
+	}
+
+	struct Test {
+		const char* group;
+		const char* name;
+		void (*fn)(UINT workers);
+		bool threaded;																// run with 0 and 3 workers, else once
+	};
+
+	const Test tests[] = {
+		{ "scheduler", "stages", testSchedulerStages, true },
+		{ "scheduler", "concurrent", testSchedulerConcurrent, true },
+		{ "scheduler", "parallelFor", testParallelFor, true },
+		{ "commandbuffers", "threads", testCommandBuffersThreads, true },
+		{ "commandbuffers", "playback", testCommandBuffersPlayback, true },
+		{ "commandbuffers", "instances", testCommandBuffersInstances, true },
+		{ "registry", "stale handles", testRegistryStaleHandles, false },
+		{ "registry", "changed", testRegistryChanged, false },
+		{ "drawpackets", "build", testDrawPackets, false },
+		{ "cube", "moves", testCubeMoves, false },
+		{ "cube", "move table", testCubeMoveTable, false },
+		{ "cube", "layers", testCubeLayers, false },
+		{ "cube", "layer scramble", testCubeLayerScramble, false },
+		{ "coordinates", "ranks", testCoordinatesRanks, false },
+		{ "coordinates", "cubie", testCoordinatesCubie, false },
+		{ "solver", "two-phase", testSolverTwoPhase, false },
+		{ "solver", "optimal", testSolverOptimal, false },
+		{ "notation", "parse", testNotationParse, false },
+		{ "notation", "errors", testNotationErrors, false },
+		{ "notation", "round trip", testNotationRoundTrip, false },
+		{ "notation", "simplify", testNotationSimplify, false },
+	};
+}
+
+
+int main(int argc, char** argv) {
+	std::string group = argc > 1 ? argv[1] : "all";
+	if (group == "--help" || group == "-h") {
+		fprintf(stderr, "usage: Tests [all|scheduler|commandbuffers|registry|drawpackets|cube|coordinates|solver|notation]\n"
+			"  runs the checks of a group, the threaded ones with 0 and 3 worker threads\n");
+		return 0;
+	}
+
+	int failed = 0, ran = 0;
+	for (auto& test : tests) {
+		if (group != "all" && group != test.group)
+			continue;
+
+		for (UINT workers : { 0u, 3u }) {
+			if (!test.threaded && workers > 0)
+				break;
+
+			std::string name = std::string(test.group) + " " + test.name;
+			if (test.threaded)
+				name += " (" + std::to_string(workers) + " workers)";
+			ran++;
+			try {
+				test.fn(workers);
+				printf("%s: ok\n", name.c_str());
+			}
+			catch (const Failure& failure) {
+				printf("%s: FAILED %s\n", name.c_str(), failure.message.c_str());
+				failed++;
+			}
+		}
+	}
+
+	if (ran == 0) {
+		fprintf(stderr, "no tests in group %s\n", group.c_str());
+		return 1;
+	}
+	printf("%d of %d passed\n", ran - failed, ran);
+	return failed;
+}